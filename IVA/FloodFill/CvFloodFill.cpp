@@ -5,16 +5,38 @@
  *      Author: davidroussel
  */
 
-#include <ctime>		// for clock
+#include <ctime>		// for CLOCKS_PER_SEC
+#include <cstring>		// for memset
+#include <climits>		// for INT_MAX
 #include <iostream>		// for cerr
+#include <iomanip>		// for setw & setprecision
 using namespace std;
 
+#include <opencv2/core/core.hpp>	// for parallel_for_
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include <assert.h>
 
 #include "CvFloodFill.h"
 
+/*
+ * Minimum ROI margin around the predicted bounding box (in pixels)
+ */
+const int CvFloodFill::minRoiMargin = 8;
+
+/*
+ * Minimum area allowed to a tracked flood by leak protection so
+ * that small regions can still grow
+ */
+const int CvFloodFill::minLeakArea = 256;
+
+/*
+ * Number of consecutive leaks after which the region is considered
+ * as really grown (e.g. when an occluder leaves) and the next
+ * tracked flood is accepted whatever its area
+ */
+const int CvFloodFill::maxConsecutiveLeaks = 8;
+
 /*
  * Flood fill class constructor
  * @param sourceImage
@@ -24,7 +46,6 @@ CvFloodFill::CvFloodFill(Mat * sourceImage) :
 	dim(sourceImage->size()),
 	// mask is 2 pixel wider and taller
 	mask(Size(sourceImage->cols + 2, sourceImage->rows + 2), CV_8UC1),
-	merged(dim, type),
 	displayMode(INPUT_IM),
 	seeded(false),
 	flooded(false),
@@ -40,7 +61,21 @@ CvFloodFill::CvFloodFill(Mat * sourceImage) :
 	initialSeed(-1, -1),
 	centerSeed(-1, -1),
 	floodBoundingBox(0,0,0,0),
-	showBoundingBox(false)
+	showBoundingBox(false),
+	floodEngine(OPENCV_FLOOD),
+	pyramidLevels(2),
+	pyramidCheck(false),
+	pyramidIoU(0.0),
+	roiTracking(false),
+	floodVelocity(0.0f, 0.0f),
+	roiMargin(0.25f),
+	leakFactor(4.0f),
+	floodROI(0, 0, 0, 0),
+	floodLeaked(false),
+	leakCount(0),
+	multiRegion(false),
+	parallelThreads(getNumThreads() > 1 ? (size_t) getNumThreads() : 1),
+	regionConflicts(0)
 
 {
 	setup(sourceImage, false);
@@ -49,6 +84,9 @@ CvFloodFill::CvFloodFill(Mat * sourceImage) :
 
 	// Adds named image to additional images map
 	addImage("display", &displayImage);
+	addImage("labels", &labels);
+	addImage("segments", &segmentLabels);
+	addImage("segmented", &segmented);
 }
 
 /*
@@ -83,8 +121,8 @@ void CvFloodFill::setup(Mat *image, bool completeSetup)
 		floodBoundingBox = Rect(0,0,0,0);
 		showBoundingBox = false;
 		mask.create(Size(image->cols + 2, image->rows + 2), CV_8UC1);
-		merged.create(dim, type);
 		displayMode = INPUT_IM;
+		regions.clear();
 	}
 	else // setup during constructor only
 	{
@@ -92,6 +130,65 @@ void CvFloodFill::setup(Mat *image, bool completeSetup)
 	}
 
 	// in any cases
+	// mask is only partially cleared in update, so clear it entirely here
+	mask = Scalar(0);
+	floodMask = mask(Rect(1, 1, dim.width, dim.height));
+	maskDirtyRect = Rect(0, 0, 0, 0);
+	previousMask.create(dim, CV_8UC1);
+
+	// scanline engine workspace of the single region flood uses floodMask
+	floodWorkspace.mask = floodMask;
+	setupWorkspace(floodWorkspace, dim, false);
+
+	// pyramid flood workspaces and images (created on demand)
+	pyramidWorkspace.mask.release();
+	checkWorkspace.mask.release();
+
+	// multi-region label image and workspaces (created on demand)
+	labels.create(dim, CV_32SC1);
+	labels = Scalar(0);
+	regionWorkspaces.clear();
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		regions[i].flooded = false;
+		regions[i].boundingBox = Rect(0, 0, 0, 0);
+	}
+
+	// whole image segmentation images
+	segmentLabels.create(dim, CV_32SC1);
+	segmented.create(dim, type);
+	segmented = Scalar(0);
+	segments.clear();
+}
+
+/*
+ * Setup a flood workspace for an image size
+ * @param workspace the workspace to setup
+ * @param size the size of the images to flood
+ * @param withMask creates the workspace mask if true (otherwise
+ * mask is expected to be set by the caller)
+ */
+void CvFloodFill::setupWorkspace(FloodWorkspace & workspace,
+								 const Size & size,
+								 const bool withMask)
+{
+	if (withMask)
+	{
+		workspace.mask.create(size, CV_8UC1);
+		workspace.mask = Scalar(0);
+	}
+
+	// row acceptance is recomputed on next flood
+	workspace.rowPass.create(size, CV_8UC1);
+	workspace.rowStamp.assign(size.height, 0);
+	workspace.fillStamp = 0;
+	workspace.m10 = 0;
+	workspace.m01 = 0;
+	workspace.boundingBox = Rect(0, 0, 0, 0);
+	workspace.bounds = Rect(Point(0, 0), size);
+	workspace.maxArea = 0;
+	workspace.touchedBounds = false;
+	workspace.leaked = false;
 }
 
 /*
@@ -100,7 +197,21 @@ void CvFloodFill::setup(Mat *image, bool completeSetup)
  */
 void CvFloodFill::cleanup()
 {
-	merged.release();
+	floodWorkspace.mask.release();
+	floodWorkspace.rowPass.release();
+	pyramidImage.release();
+	pyramidWorkspace.mask.release();
+	pyramidWorkspace.rowPass.release();
+	pyramidState.release();
+	pyramidInside.release();
+	checkWorkspace.mask.release();
+	checkWorkspace.rowPass.release();
+	regionWorkspaces.clear();
+	labels.release();
+	segmentLabels.release();
+	segmented.release();
+	segments.clear();
+	floodMask.release();
 	mask.release();
 	displayImage.release();
 
@@ -108,6 +219,18 @@ void CvFloodFill::cleanup()
 	CvProcessor::cleanup();
 }
 
+/*
+ * Computes elapsed wall clock time since start (in clock ticks so
+ * it can be used as processTime).
+ * @param start the starting time obtained with getTickCount()
+ * @return the elapsed time in clock ticks
+ */
+clock_t CvFloodFill::elapsedTicks(const int64 start)
+{
+	return (clock_t) (((double) (getTickCount() - start) * CLOCKS_PER_SEC) /
+					  getTickFrequency());
+}
+
 /*
  * Gets displayImageChanged current status when display image is changed
  * @return the current displayImageChanged value
@@ -132,7 +255,13 @@ CvFloodFill::ImageDisplay CvFloodFill::getDisplayMode() const
  */
 void CvFloodFill::setDisplayMode(const ImageDisplay displayMode)
 {
-	if ((displayMode >= INPUT_IM) && (displayMode < NBDISPLAY_IM))
+	if ((displayMode == SEGMENTED_IM) && (type != CV_8UC1) &&
+		(type != CV_8UC3))
+	{
+		cerr << "CvFloodFill::setDisplayMode : segmentation requires "
+			 << "a 8 bits image" << endl;
+	}
+	else if ((displayMode >= INPUT_IM) && (displayMode < NBDISPLAY_IM))
 	{
 		this->displayMode = displayMode;
 	}
@@ -208,6 +337,33 @@ void CvFloodFill::setFfillMode(const FloodFillMode ffillMode)
 	resetMeanProcessTime();
 }
 
+/*
+ * Gets the current flood fill engine
+ * @return the current flood fill engine
+ */
+CvFloodFill::FloodEngine CvFloodFill::getFloodEngine() const
+{
+	return floodEngine;
+}
+
+/*
+ * Sets a new flood fill engine
+ * @param floodEngine the new flood fill engine
+ */
+void CvFloodFill::setFloodEngine(const FloodEngine floodEngine)
+{
+	if ((floodEngine >= OPENCV_FLOOD) && (floodEngine < NBFLOOD_ENGINES))
+	{
+		this->floodEngine = floodEngine;
+	}
+	else
+	{
+		cerr << "flood engine out of range: " << floodEngine << endl;
+	}
+
+	resetMeanProcessTime();
+}
+
 /*
  * Gets the lower difference in pixel values for flooding
  * @return the current lower difference for flooding
@@ -399,52 +555,45 @@ void CvFloodFill::setShowBoundingBox(const bool showBoundingBox)
 
 /*
  * Flood fill update:
- * 	- Copy source image to merged image
- * 	- if image has already been flooded compute Flood barycenter
- * 		- if flood has succeded set seed as the barycenter
- * 		- else reset seeded and flooded states
+ * 	- if segmented image is displayed, segments the whole image
+ * 	- if image has already been flooded use the last flood barycenter
+ * 	as the seed
  * 	- else
  * 		- if image has been seed manually then use this seed
- * 	- clears mask with zeros
+ * 	- clears mask with zeros where the last flood has set it
  * 	- if there is a seed
  * 		- flood fill the image
  * 		- if flood area counts some pixels then sets flooded state
  * 		- if flooded
+ * 			- compute flood barycenter within flood bounding box
+ * 			- if barycenter can't be computed reset seeded and
+ * 			flooded states
+ * 			- if merged image is displayed, compose flood into source
+ * 				image within flood bounding box
  * 			- if show bounding box is on then draw bouding box rectangle
  * 				in source image
- * 			- if show seed is on then draw seed in source image and
- * 				merged image
+ * 			- if show seed is on then draw seed in source image
  *	- according to displayMode set displayImage
  *
  */
 void CvFloodFill::update()
 {
-	// copy source image to merged image
-	sourceImage->copyTo(merged);
-
-	clock_t start, end;
+	// wall clock time since floods and segmentation may be multi-threaded
+	int64 start = getTickCount();
 
-	start = clock();
+	// Segments the whole image before anything is drawn in source image
+	if ((displayMode == SEGMENTED_IM) &&
+		((type == CV_8UC1) || (type == CV_8UC3)))
+	{
+		segmentImage();
+	}
 
-	// if image has been flooded once, then compute flood barycenter as the
+	// if image has been flooded once, then last flood barycenter is the
 	// seed for next flood
 	Point seed;
 	if (flooded)
 	{
-		// TODO Compléter la méthode computeFloodCenter pour calculer
-		// le barycentre centre de la zone inondée (flooded) à partir de l'image
-		// du masque qui contient des valeurs à 255 dans cette zone et 0 ailleurs
-		bool res = computeFloodCenter<uchar>(mask, centerSeed, (uchar)newMaskVal);
-		if (res)
-		{
-			// set seed for flooding
-			seed = centerSeed;
-		}
-		else
-		{
-			seeded = false;
-			flooded = false;
-		}
+		seed = centerSeed;
 	}
 	else
 	{
@@ -454,11 +603,25 @@ void CvFloodFill::update()
 		}
 	}
 
-	// update mask with zeros : clears mask
-	mask = Scalar(0);
+	// clears mask with zeros where it has been set by the last flood
+	if (maskDirtyRect.area() > 0)
+	{
+		// a tracked flood may be rejected : last flood is saved to be restored
+		if (flooded && roiTracking)
+		{
+			floodMask(maskDirtyRect).copyTo(previousMask(maskDirtyRect));
+		}
+		floodMask(maskDirtyRect) = Scalar(0);
+		maskDirtyRect = Rect(0, 0, 0, 0);
+	}
 
 	// flood
-	if (seeded) // We can flood the image
+	if (multiRegion)
+	{
+		// seeded and flooded are cleared in multi-region mode
+		updateRegions();
+	}
+	else if (seeded) // We can flood the image
 	{
 		// Check seed is inside image otherwise floodFill will crash
 		seed.x >= 0 ? seed.x : seed.x = 0;
@@ -466,20 +629,113 @@ void CvFloodFill::update()
 		seed.y >= 0 ? seed.y : seed.y = 0;
 		seed.y < dim.height ? seed.y : seed.y = dim.height - 1;
 
-		// Flood image from seed point
-		// merged --> mask
+		// Flood image from seed point (source image is left unchanged)
+		// sourceImage --> mask
 		// with seed point : seed
 		// with flood color : floodColor
 		// update flood bounding box : floodBoundingBox
 		// Lo diff set as Scalar(loDiff, loDiff, loDiff)
 		// Up diff set as Scalar(upDiff, upDiff, upDiff)
 		// use already computed floodFlags
-		// TODO floodArea = floodFill(...);
-        floodArea = floodFill(merged,mask,seed,floodColor,&floodBoundingBox,Scalar(loDiff, loDiff, loDiff),Scalar(upDiff, upDiff, upDiff),floodFlags);
+		bool scanline = ((floodEngine == SCANLINE_FLOOD) ||
+						 (floodEngine == PYRAMID_FLOOD)) &&
+						((type == CV_8UC1) || (type == CV_8UC3));
+		bool pyramid = scanline && (floodEngine == PYRAMID_FLOOD);
+		bool tracking = scanline && !pyramid && roiTracking && flooded;
+		if (tracking)
+		{
+			// bounded flood around the predicted region : sets floodArea,
+			// floodBoundingBox, centerSeed and mask
+			seed = trackFlood();
+		}
+		else if (scanline)
+		{
+			floodWorkspace.bounds = Rect(Point(0, 0), dim);
+			floodWorkspace.maxArea = 0;
+
+			if (pyramid)
+			{
+				if (isColor)
+				{
+					floodArea = pyramidFloodFill<3>(NULL, seed, floodColor);
+				}
+				else
+				{
+					floodArea = pyramidFloodFill<1>(NULL, seed, floodColor);
+				}
+			}
+			else if (isColor)
+			{
+				floodArea = scanlineFloodFill<3>(*sourceImage, NULL, seed,
+												 loDiff, upDiff, floodColor,
+												 floodWorkspace);
+			}
+			else
+			{
+				floodArea = scanlineFloodFill<1>(*sourceImage, NULL, seed,
+												 loDiff, upDiff, floodColor,
+												 floodWorkspace);
+			}
+			floodBoundingBox = floodWorkspace.boundingBox;
+
+			if (pyramid && pyramidCheck)
+			{
+				// full resolution check is not included in process time
+				int64 checkStart = getTickCount();
+				if (isColor)
+				{
+					pyramidIoU = checkPyramidFlood<3>(seed);
+				}
+				else
+				{
+					pyramidIoU = checkPyramidFlood<1>(seed);
+				}
+				start += getTickCount() - checkStart;
+			}
+		}
+		else
+		{
+			floodArea = floodFill(*sourceImage,mask,seed,floodColor,&floodBoundingBox,Scalar(loDiff, loDiff, loDiff),Scalar(upDiff, upDiff, upDiff),floodFlags | CV_FLOODFILL_MASK_ONLY);
+		}
 
 		// if floodArea contains some pixels then flooded is true now
 		flooded = (floodArea > 0 ? true : false);
 
+		if (flooded && !tracking)
+		{
+			maskDirtyRect = floodBoundingBox;
+
+			bool res;
+			if (scanline)
+			{
+				// moments have been computed while flooding
+				centerSeed.x = (int)(floodWorkspace.m10 / floodArea);
+				centerSeed.y = (int)(floodWorkspace.m01 / floodArea);
+				res = true;
+			}
+			else
+			{
+				// Compute flood barycenter as the seed for next flood while
+				// the flooded part of the mask is still in cache
+				res = computeFloodCenter<uchar>(floodMask,
+												floodBoundingBox,
+												centerSeed,
+												(uchar)newMaskVal);
+			}
+
+			if (!res)
+			{
+				seeded = false;
+				flooded = false;
+			}
+		}
+
+		// merged image is only composed when displayed
+		if (flooded && (displayMode == MERGED_IM))
+		{
+			composeFlood();
+		}
+
 		// if image has been flooded and showBoundingBox is true then
 		// draw flooded area bounding box in source image
 		if (flooded)
@@ -503,7 +759,7 @@ void CvFloodFill::update()
 		}
 
 		// if showSeed is true then Shows seed point in source image
-		// and merged image as a small circle with red color
+		// (and merged image) as a small circle with red color
 		if (showSeed)
 		{
 			circle(*sourceImage, // image to draw in
@@ -512,12 +768,10 @@ void CvFloodFill::update()
 				   Scalar(0, 0, 255), // draw color
 				   2, // Line width
 				   CV_AA); // Line type (better with AA)
-			circle(merged, seed, 3, Scalar(0, 0, 255), 2, CV_AA);
 		}
 	}
 
-	end = clock();
-	processTime = end - start;
+	processTime = elapsedTicks(start);
 	meanProcessTime += processTime;
 
 	// ------------------------------------------------------------------------
@@ -534,7 +788,11 @@ void CvFloodFill::update()
 			displayImage = mask;
 			break;
 		case MERGED_IM:
-			displayImage = merged;
+			// flood has been composed into source image
+			displayImage = *sourceImage;
+			break;
+		case SEGMENTED_IM:
+			displayImage = segmented;
 			break;
 		default:
 			if (verboseLevel >= CvProcessor::VERBOSE_WARNINGS)
@@ -568,14 +826,22 @@ void CvFloodFill::clearFlood()
 	initialSeed = Point(-1,-1);
 	centerSeed = Point(-1,-1);
 	floodBoundingBox = Rect(0,0,0,0);
+	floodVelocity = Point2f(0.0f, 0.0f);
+	floodROI = Rect(0, 0, 0, 0);
+	floodLeaked = false;
+	leakCount = 0;
 
 	resetMeanProcessTime();
 }
 
 /*
- * Compute barycenter of last computed flood
+ * Compute barycenter of last computed flood within the flooded area
+ * bounding box
  * @param mask the mask image where mask pixels are set to newMaskVal
- * @param center the barycenter point computed here
+ * @param area the region of the mask containing all flooded pixels
+ * (typically the flood bounding box). Only this region is scanned.
+ * @param center the barycenter point computed here (in mask
+ * coordinates)
  * @param threshold the value to use as threshold to find flooded area
  * pixels in the mask image
  * @note One can also use the OpenCV function moments(...) to compute
@@ -588,6 +854,7 @@ void CvFloodFill::clearFlood()
  */
 template<typename T>
 bool CvFloodFill::computeFloodCenter(const Mat & mask,
+									 const Rect & area,
 									 Point & center,
 									 const T threshold)
 {
@@ -598,21 +865,26 @@ bool CvFloodFill::computeFloodCenter(const Mat & mask,
 		long lineCount = 0;		// m01
 		long colCount = 0;		// m10
 
-		for (int i = 0; i < mask.rows; i++)
+		// scan only the part of the mask within area
+		Rect region = area & Rect(0, 0, mask.cols, mask.rows);
+		const int lastCol = region.x + region.width;
+
+		for (int i = region.y; i < region.y + region.height; i++)
 		{
-			for (int j = 0; j < mask.cols; j++)
+			const T * maskRow = mask.ptr<T>(i);
+			long rowCount = 0;
+
+			for (int j = region.x; j < lastCol; j++)
 			{
-				if (mask.at<T>(i,j) >= threshold)
+				if (maskRow[j] >= threshold)
 				{
-					// TODO Compléter ...
-					// update pixelCount : +1
-					// update lineCount : +i
-					// update colCount : +j
-                    pixelCount++;
-                    lineCount+=i;
-                    colCount+=j;
+					rowCount++;
+					colCount += j;
 				}
 			}
+
+			pixelCount += rowCount;
+			lineCount += rowCount * i;
 		}
 
 		if (pixelCount > 0)
@@ -639,3 +911,2009 @@ bool CvFloodFill::computeFloodCenter(const Mat & mask,
 	}
 }
 
+
+/*
+ * Checks if a pixel q is within floating range of a flooded neighbor p:
+ * p - loDiff <= q <= p + upDiff on all channels
+ * @param q the pixel to check
+ * @param p the flooded neighbor
+ * @param loDiff the lower difference
+ * @param range loDiff + upDiff
+ * @return true if q can be flooded from p
+ */
+template<int cn>
+static inline bool floatingAccept(const uchar * q,
+								  const uchar * p,
+								  const int loDiff,
+								  const unsigned int range)
+{
+	for (int c = 0; c < cn; c++)
+	{
+		if ((unsigned int)(q[c] - p[c] + loDiff) > range)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Extends a span of accepted pixels to the left and to the right as long
+ * as pixels are not flooded yet and accepted: either from rowPass (fixed
+ * range) or from their horizontal neighbor (floating range)
+ * @param row the image row
+ * @param pass the row acceptance for fixed range or NULL for floating range
+ * @param maskRow the mask row
+ * @param xMin the leftmost pixel the span can be extended to
+ * @param xMax the rightmost pixel the span can be extended to
+ * @param loDiff the lower difference (floating range only)
+ * @param range loDiff + upDiff (floating range only)
+ * @param xl the left end of the span to extend
+ * @param xr the right end of the span to extend
+ */
+template<int cn>
+static inline void extendSpan(const uchar * row,
+							  const uchar * pass,
+							  const uchar * maskRow,
+							  const int xMin,
+							  const int xMax,
+							  const int loDiff,
+							  const unsigned int range,
+							  int & xl,
+							  int & xr)
+{
+	if (pass != NULL)
+	{
+		while ((xl > xMin) && pass[xl - 1] && (maskRow[xl - 1] == 0))
+		{
+			xl--;
+		}
+		while ((xr < xMax) && pass[xr + 1] && (maskRow[xr + 1] == 0))
+		{
+			xr++;
+		}
+	}
+	else
+	{
+		while ((xl > xMin) && (maskRow[xl - 1] == 0) &&
+			   floatingAccept<cn>(row + (xl - 1) * cn, row + xl * cn,
+								  loDiff, range))
+		{
+			xl--;
+		}
+		while ((xr < xMax) && (maskRow[xr + 1] == 0) &&
+			   floatingAccept<cn>(row + (xr + 1) * cn, row + xr * cn,
+								  loDiff, range))
+		{
+			xr++;
+		}
+	}
+}
+
+/*
+ * Sets a span to maskValue in the mask and to color in the filled image
+ * @param maskRow the mask row
+ * @param filledRow the filled image row (or NULL)
+ * @param xl the left end of the span
+ * @param xr the right end of the span
+ * @param maskValue the mask value of flooded pixels
+ * @param color the flood color
+ */
+template<int cn>
+static inline void fillSpan(uchar * maskRow,
+							uchar * filledRow,
+							const int xl,
+							const int xr,
+							const uchar maskValue,
+							const uchar * color)
+{
+	memset(maskRow + xl, maskValue, xr - xl + 1);
+
+	if (filledRow != NULL)
+	{
+		uchar * pixel = filledRow + xl * cn;
+		for (int x = xl; x <= xr; x++, pixel += cn)
+		{
+			for (int c = 0; c < cn; c++)
+			{
+				pixel[c] = color[c];
+			}
+		}
+	}
+}
+
+/*
+ * Computes fixed range acceptance of all pixels of a row of image
+ * (within flood bounds) into rowPass with a branch-free loop the
+ * compiler can vectorize
+ * @param image the image to flood
+ * @param rowPass the acceptance image
+ * @param y the row to compute
+ * @param xMin the first pixel of the row to compute
+ * @param xMax the last pixel of the row to compute
+ * @param low the lowest accepted value of each channel
+ * @param range the width of the accepted range of each channel
+ */
+template<int cn>
+void CvFloodFill::computeRowPass(const Mat & image,
+								 Mat & rowPass,
+								 const int y,
+								 const int xMin,
+								 const int xMax,
+								 const int * low,
+								 const unsigned int * range)
+{
+	const uchar * pixel = image.ptr<uchar>(y) + xMin * cn;
+	uchar * pass = rowPass.ptr<uchar>(y);
+
+	// local copies so the compiler knows they don't alias rows
+	int lows[cn];
+	unsigned int ranges[cn];
+	for (int c = 0; c < cn; c++)
+	{
+		lows[c] = low[c];
+		ranges[c] = range[c];
+	}
+
+	for (int x = xMin; x <= xMax; x++, pixel += cn)
+	{
+		unsigned int accepted = 1;
+		for (int c = 0; c < cn; c++)
+		{
+			accepted &= (unsigned int)((unsigned int)(pixel[c] - lows[c]) <=
+									   ranges[c]);
+		}
+		pass[x] = (uchar)accepted;
+	}
+}
+
+/*
+ * Scanline flood fill of an 8 bits image with cn channels according
+ * to current ffillMode and connectivity: flooded pixels are set to
+ * newMaskVal in the workspace mask and to color in the filled
+ * image. Flooded area bounding box and first order moments are
+ * computed in the workspace while filling. Flood is limited to the
+ * workspace bounds and aborted when it exceeds the workspace maxArea.
+ * @param image the image to flood (only read)
+ * @param filled the image to draw flooded pixels in (may be image
+ * or NULL)
+ * @param seed the flood seed (should be within workspace bounds)
+ * @param loDiff the lower difference for pixel aggregation
+ * @param upDiff the upper difference for pixel aggregation
+ * @param color the flood color in the filled image
+ * @param workspace the flood workspace
+ * @param spans if not NULL flooded spans are added to this vector
+ * @return the number of flooded pixels
+ * @pre workspace mask is cleared
+ */
+template<int cn>
+int CvFloodFill::scanlineFloodFill(const Mat & image,
+								   Mat * filled,
+								   const Point & seed,
+								   const int loDiff,
+								   const int upDiff,
+								   const Scalar & color,
+								   FloodWorkspace & workspace,
+								   vector<FloodSpan> * spans) const
+{
+	const int height = image.rows;
+	const Rect & bounds = workspace.bounds;
+	const int xMin = bounds.x;
+	const int xMax = bounds.x + bounds.width - 1;
+	const int yMin = bounds.y;
+	const int yMax = bounds.y + bounds.height - 1;
+	const bool fixedRange = (ffillMode == FIXED_RANGE);
+	const bool conn8 = (connectivity == 8);
+	const unsigned int range = (unsigned int)(loDiff + upDiff);
+	const uchar maskValue = saturate_cast<uchar>(newMaskVal);
+
+	uchar fillColor[cn];
+	int low[cn];
+	unsigned int ranges[cn];
+	const uchar * seedPixel = image.ptr<uchar>(seed.y) + seed.x * cn;
+	for (int c = 0; c < cn; c++)
+	{
+		fillColor[c] = saturate_cast<uchar>(color[c]);
+		low[c] = seedPixel[c] - loDiff;
+		ranges[c] = range;
+	}
+
+	Mat & wMask = workspace.mask;
+	Mat & rowPass = workspace.rowPass;
+	vector<int> & rowStamp = workspace.rowStamp;
+	vector<FloodSpan> & spanStack = workspace.spanStack;
+
+	if (fixedRange)
+	{
+		// rows computed during previous floods are now invalid
+		if (++workspace.fillStamp == INT_MAX)
+		{
+			rowStamp.assign(height, 0);
+			workspace.fillStamp = 1;
+		}
+	}
+	const int fillStamp = workspace.fillStamp;
+
+	workspace.m10 = 0;
+	workspace.m01 = 0;
+	workspace.touchedBounds = false;
+	workspace.leaked = false;
+	spanStack.clear();
+
+	if (!bounds.contains(seed) ||
+		(wMask.ptr<uchar>(seed.y)[seed.x] != 0))
+	{
+		workspace.boundingBox = Rect(0, 0, 0, 0);
+		return 0;
+	}
+	uchar * maskRow = wMask.ptr<uchar>(seed.y);
+
+	// Seed span
+	const uchar * row = image.ptr<uchar>(seed.y);
+	const uchar * pass = NULL;
+	if (fixedRange)
+	{
+		computeRowPass<cn>(image, rowPass, seed.y, xMin, xMax, low, ranges);
+		rowStamp[seed.y] = fillStamp;
+		pass = rowPass.ptr<uchar>(seed.y);
+	}
+
+	int xl = seed.x;
+	int xr = seed.x;
+	extendSpan<cn>(row, pass, maskRow, xMin, xMax, loDiff, range, xl, xr);
+	fillSpan<cn>(maskRow,
+				 filled != NULL ? filled->ptr<uchar>(seed.y) : NULL,
+				 xl, xr, maskValue, fillColor);
+
+	int area = xr - xl + 1;
+	workspace.m10 += (int64)(xl + xr) * (xr - xl + 1) / 2;
+	workspace.m01 += (int64)seed.y * (xr - xl + 1);
+	int minX = xl;
+	int maxX = xr;
+	int minY = seed.y;
+	int maxY = seed.y;
+
+	FloodSpan seedSpan = {seed.y, xl, xr, 1};
+	if (spans != NULL)
+	{
+		spans->push_back(seedSpan);
+	}
+	spanStack.push_back(seedSpan);
+	seedSpan.dy = -1;
+	spanStack.push_back(seedSpan);
+
+	while (!spanStack.empty())
+	{
+		const FloodSpan span = spanStack.back();
+		spanStack.pop_back();
+
+		const int y = span.y + span.dy;
+		if ((y < yMin) || (y > yMax))
+		{
+			continue;
+		}
+
+		row = image.ptr<uchar>(y);
+		const uchar * parentRow = image.ptr<uchar>(span.y);
+		maskRow = wMask.ptr<uchar>(y);
+		uchar * filledRow = (filled != NULL ? filled->ptr<uchar>(y) : NULL);
+
+		if (fixedRange)
+		{
+			if (rowStamp[y] != fillStamp)
+			{
+				computeRowPass<cn>(image, rowPass, y, xMin, xMax, low, ranges);
+				rowStamp[y] = fillStamp;
+			}
+			pass = rowPass.ptr<uchar>(y);
+		}
+
+		// pixels of row y neighboring the span
+		const int first = conn8 ? max(span.xl - 1, xMin) : span.xl;
+		const int last = conn8 ? min(span.xr + 1, xMax) : span.xr;
+
+		int x = first;
+		while (x <= last)
+		{
+			bool accepted = false;
+			if (maskRow[x] == 0)
+			{
+				if (fixedRange)
+				{
+					accepted = pass[x] != 0;
+				}
+				else
+				{
+					// floating range : compare to flooded neighbors in span
+					const int pl = conn8 ? max(x - 1, span.xl) : x;
+					const int pr = conn8 ? min(x + 1, span.xr) : x;
+					for (int px = pl; (px <= pr) && !accepted; px++)
+					{
+						accepted = floatingAccept<cn>(row + x * cn,
+													  parentRow + px * cn,
+													  loDiff, range);
+					}
+				}
+			}
+
+			if (!accepted)
+			{
+				x++;
+				continue;
+			}
+
+			xl = x;
+			xr = x;
+			extendSpan<cn>(row, pass, maskRow, xMin, xMax, loDiff, range,
+						   xl, xr);
+			fillSpan<cn>(maskRow, filledRow, xl, xr, maskValue, fillColor);
+
+			const int length = xr - xl + 1;
+			area += length;
+			workspace.m10 += (int64)(xl + xr) * length / 2;
+			workspace.m01 += (int64)y * length;
+			minX = min(minX, xl);
+			maxX = max(maxX, xr);
+			minY = min(minY, y);
+			maxY = max(maxY, y);
+
+			if ((workspace.maxArea > 0) && (area > workspace.maxArea))
+			{
+				// runaway flood : abort
+				workspace.leaked = true;
+				spanStack.clear();
+				if (spans != NULL)
+				{
+					FloodSpan last = {y, xl, xr, span.dy};
+					spans->push_back(last);
+				}
+				break;
+			}
+
+			FloodSpan next = {y, xl, xr, span.dy};
+			if (spans != NULL)
+			{
+				spans->push_back(next);
+			}
+			spanStack.push_back(next);
+
+			/*
+			 * Row span.y only needs to be checked again where the new span
+			 * overhangs the span it comes from (and on its ends for
+			 * floating range with 8 connectivity since span ends are then
+			 * diagonal neighbors of unchecked pixels)
+			 */
+			if ((xl < span.xl) || (xr > span.xr) ||
+				(conn8 && !fixedRange && ((xl == span.xl) || (xr == span.xr))))
+			{
+				next.dy = -span.dy;
+				spanStack.push_back(next);
+			}
+
+			// xr + 1 has been rejected from xr but may still be accepted
+			// from row span.y in floating range
+			x = xr + 1;
+		}
+	}
+
+	workspace.boundingBox =
+		Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+
+	// flood reached bounds which are not image borders
+	workspace.touchedBounds = ((minX == xMin) && (xMin > 0)) ||
+							  ((maxX == xMax) && (xMax < image.cols - 1)) ||
+							  ((minY == yMin) && (yMin > 0)) ||
+							  ((maxY == yMax) && (yMax < height - 1));
+
+	return area;
+}
+
+/*
+ * Checks if a pixel q is within fixed range of the seed:
+ * low <= q <= low + range on all channels
+ * @param q the pixel to check
+ * @param low the lowest accepted value of each channel
+ * @param range loDiff + upDiff
+ * @return true if q can be flooded
+ */
+template<int cn>
+static inline bool fixedAccept(const uchar * q,
+							   const int * low,
+							   const unsigned int range)
+{
+	for (int c = 0; c < cn; c++)
+	{
+		if ((unsigned int)(q[c] - low[c]) > range)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Coarse to fine flood fill of the source image with cn channels:
+ * 	- the downscaled source image is flooded with the scanline engine
+ * 	- coarse pixels whose neighbors are all flooded are flooded at
+ * 	full resolution without checking
+ * 	- full resolution pixels of the other coarse pixels neighboring
+ * 	the coarse flood (the border band) are flooded from the trusted
+ * 	pixels with the same loDiff / upDiff criteria and the flood
+ * 	keeps growing at full resolution from there
+ * Result is identical to the full resolution flood as long as all
+ * trusted pixels belong to the full resolution region (which is the
+ * case for uniform regions whose inside has no detail thinner than
+ * the coarse pixels).
+ * Flooded pixels are set in floodMask and floodWorkspace moments
+ * and bounding box are computed like the scanline engine does.
+ * @param filled the image to draw flooded pixels in (or NULL)
+ * @param seed the flood seed
+ * @param color the flood color in the filled image
+ * @return the number of flooded pixels
+ * @pre floodMask is cleared
+ */
+template<int cn>
+int CvFloodFill::pyramidFloodFill(Mat * filled,
+								  const Point & seed,
+								  const Scalar & color)
+{
+	const int scale = 1 << pyramidLevels;
+	const Size coarseSize(dim.width / scale, dim.height / scale);
+	FloodWorkspace & workspace = floodWorkspace;
+
+	// image is too small for this pyramid level
+	if ((coarseSize.width < 3) || (coarseSize.height < 3))
+	{
+		return scanlineFloodFill<cn>(*sourceImage, filled, seed, loDiff,
+									 upDiff, color, workspace);
+	}
+
+	// ------------------------------------------------------------------------
+	// Coarse flood
+	// ------------------------------------------------------------------------
+	const Size scaledSize(coarseSize.width * scale, coarseSize.height * scale);
+	resize((*sourceImage)(Rect(Point(0, 0), scaledSize)), pyramidImage,
+		   coarseSize, 0, 0, INTER_AREA);
+
+	if (pyramidWorkspace.mask.size() != coarseSize)
+	{
+		setupWorkspace(pyramidWorkspace, coarseSize, true);
+	}
+
+	const Point coarseSeed(min(seed.x / scale, coarseSize.width - 1),
+						   min(seed.y / scale, coarseSize.height - 1));
+	const uchar * seedPixel = sourceImage->ptr<uchar>(seed.y) + seed.x * cn;
+	if (ffillMode == FIXED_RANGE)
+	{
+		// coarse flood range is centered on the full resolution seed value
+		uchar * coarseSeedPixel =
+			pyramidImage.ptr<uchar>(coarseSeed.y) + coarseSeed.x * cn;
+		for (int c = 0; c < cn; c++)
+		{
+			coarseSeedPixel[c] = seedPixel[c];
+		}
+	}
+	scanlineFloodFill<cn>(pyramidImage, NULL, coarseSeed, loDiff, upDiff,
+						  color, pyramidWorkspace);
+
+	// State of coarse pixels around the coarse flood (pixels out of image
+	// are considered as flooded by erode) : inside pixels and their
+	// neighbors are flooded, band pixels are next to a flooded pixel
+	const Rect & coarseBox = pyramidWorkspace.boundingBox;
+	const Rect stateBox = Rect(coarseBox.x - 1, coarseBox.y - 1,
+							   coarseBox.width + 2, coarseBox.height + 2) &
+						  Rect(Point(0, 0), coarseSize);
+	erode(pyramidWorkspace.mask, pyramidInside, Mat());
+	dilate(pyramidWorkspace.mask, pyramidState, Mat());
+	pyramidState = min(pyramidState, 1) + min(pyramidInside, 1);
+
+	if (coarseBox.area() > 0)
+	{
+		pyramidWorkspace.mask(coarseBox) = Scalar(0);
+	}
+
+	// ------------------------------------------------------------------------
+	// Full resolution inside : pixels beyond the scaled size (last
+	// columns and rows) are never trusted
+	// ------------------------------------------------------------------------
+	const int stateRight = stateBox.x + stateBox.width;
+	const int stateBottom = stateBox.y + stateBox.height;
+	const uchar maskValue = saturate_cast<uchar>(newMaskVal);
+	const unsigned int range = (unsigned int)(loDiff + upDiff);
+	const bool fixedRange = (ffillMode == FIXED_RANGE);
+	uchar fillColor[cn];
+	int low[cn];
+	for (int c = 0; c < cn; c++)
+	{
+		fillColor[c] = saturate_cast<uchar>(color[c]);
+		low[c] = seedPixel[c] - loDiff;
+	}
+
+	int area = 0;
+	int64 m10 = 0;
+	int64 m01 = 0;
+	int minX = INT_MAX;
+	int maxX = -1;
+	int minY = INT_MAX;
+	int maxY = -1;
+
+	for (int cy = stateBox.y; cy < stateBottom; cy++)
+	{
+		const uchar * stateRow = pyramidState.ptr<uchar>(cy);
+		int cx = stateBox.x;
+		while (cx < stateRight)
+		{
+			// runs of inside coarse pixels
+			if (stateRow[cx] != PYRAMID_INSIDE)
+			{
+				cx++;
+				continue;
+			}
+			const int cl = cx;
+			while ((cx < stateRight) && (stateRow[cx] == PYRAMID_INSIDE))
+			{
+				cx++;
+			}
+
+			const int xl = cl * scale;
+			const int xr = cx * scale - 1;
+			const int length = xr - xl + 1;
+			for (int y = cy * scale; y < (cy + 1) * scale; y++)
+			{
+				fillSpan<cn>(floodMask.ptr<uchar>(y),
+							 (filled != NULL ? filled->ptr<uchar>(y) : NULL),
+							 xl, xr, maskValue, fillColor);
+				m01 += (int64)y * length;
+			}
+			area += length * scale;
+			m10 += (int64)(xl + xr) * length / 2 * scale;
+			minX = min(minX, xl);
+			maxX = max(maxX, xr);
+			minY = min(minY, cy * scale);
+			maxY = max(maxY, (cy + 1) * scale - 1);
+		}
+	}
+
+	// ------------------------------------------------------------------------
+	// Refinement at full resolution : the flood grows from the trusted
+	// pixels through border band pixels (and beyond if the region extends
+	// further than the coarse flood)
+	// ------------------------------------------------------------------------
+	static const int dx[8] = {-1, 1, 0, 0, -1, 1, -1, 1};
+	static const int dy[8] = {0, 0, -1, 1, -1, -1, 1, 1};
+	const int nbNeighbors = connectivity;
+	pyramidStack.clear();
+
+	// the seed is always flooded
+	if (floodMask.ptr<uchar>(seed.y)[seed.x] == 0)
+	{
+		floodMask.ptr<uchar>(seed.y)[seed.x] = maskValue;
+		pyramidStack.push_back(seed);
+	}
+
+	// band pixels (and untrusted pixels of inside coarse pixels beyond
+	// the scaled size) neighboring flooded pixels
+	for (int cy = stateBox.y; cy < stateBottom; cy++)
+	{
+		const uchar * stateRow = pyramidState.ptr<uchar>(cy);
+		const bool lastRow = (cy == coarseSize.height - 1);
+		const int yEnd = (lastRow ? dim.height : (cy + 1) * scale);
+
+		for (int cx = stateBox.x; cx < stateRight; cx++)
+		{
+			const bool lastCol = (cx == coarseSize.width - 1);
+			if ((stateRow[cx] == PYRAMID_OUTSIDE) ||
+				((stateRow[cx] == PYRAMID_INSIDE) && !lastRow && !lastCol))
+			{
+				continue;
+			}
+
+			const int xEnd = (lastCol ? dim.width : (cx + 1) * scale);
+			for (int y = cy * scale; y < yEnd; y++)
+			{
+				const uchar * row = sourceImage->ptr<uchar>(y);
+				uchar * maskRow = floodMask.ptr<uchar>(y);
+
+				for (int x = cx * scale; x < xEnd; x++)
+				{
+					if (maskRow[x] != 0)
+					{
+						continue;
+					}
+
+					const uchar * q = row + x * cn;
+					for (int n = 0; n < nbNeighbors; n++)
+					{
+						const int nx = x + dx[n];
+						const int ny = y + dy[n];
+						if ((nx < 0) || (nx >= dim.width) ||
+							(ny < 0) || (ny >= dim.height) ||
+							(floodMask.ptr<uchar>(ny)[nx] == 0))
+						{
+							continue;
+						}
+
+						if (fixedRange ? fixedAccept<cn>(q, low, range) :
+							floatingAccept<cn>(q,
+								sourceImage->ptr<uchar>(ny) + nx * cn,
+								loDiff, range))
+						{
+							// marked now so it is not pushed twice
+							maskRow[x] = maskValue;
+							pyramidStack.push_back(Point(x, y));
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// flood grows from band pixels
+	for (size_t i = 0; i < pyramidStack.size(); i++)
+	{
+		const Point p = pyramidStack[i];
+		if (filled != NULL)
+		{
+			uchar * pixel = filled->ptr<uchar>(p.y) + p.x * cn;
+			for (int c = 0; c < cn; c++)
+			{
+				pixel[c] = fillColor[c];
+			}
+		}
+		area++;
+		m10 += p.x;
+		m01 += p.y;
+		minX = min(minX, p.x);
+		maxX = max(maxX, p.x);
+		minY = min(minY, p.y);
+		maxY = max(maxY, p.y);
+
+		const uchar * pixel = sourceImage->ptr<uchar>(p.y) + p.x * cn;
+		for (int n = 0; n < nbNeighbors; n++)
+		{
+			const int nx = p.x + dx[n];
+			const int ny = p.y + dy[n];
+			if ((nx < 0) || (nx >= dim.width) || (ny < 0) || (ny >= dim.height))
+			{
+				continue;
+			}
+
+			uchar * maskPixel = floodMask.ptr<uchar>(ny) + nx;
+			const uchar * q = sourceImage->ptr<uchar>(ny) + nx * cn;
+			if ((*maskPixel == 0) &&
+				(fixedRange ? fixedAccept<cn>(q, low, range) :
+				 floatingAccept<cn>(q, pixel, loDiff, range)))
+			{
+				*maskPixel = maskValue;
+				pyramidStack.push_back(Point(nx, ny));
+			}
+		}
+	}
+
+	workspace.m10 = m10;
+	workspace.m01 = m01;
+	workspace.boundingBox = (area > 0 ?
+		Rect(minX, minY, maxX - minX + 1, maxY - minY + 1) : Rect(0, 0, 0, 0));
+	workspace.touchedBounds = false;
+	workspace.leaked = false;
+
+	return area;
+}
+
+/*
+ * Floods the source image at full resolution with the scanline
+ * engine in checkWorkspace and compares it to the last flood in
+ * floodMask
+ * @param seed the seed of the last flood
+ * @return the intersection over union of both floods
+ */
+template<int cn>
+double CvFloodFill::checkPyramidFlood(const Point & seed)
+{
+	if (checkWorkspace.mask.size() != dim)
+	{
+		setupWorkspace(checkWorkspace, dim, true);
+	}
+
+	const int checkArea = scanlineFloodFill<cn>(*sourceImage, NULL, seed,
+												loDiff, upDiff, floodColor,
+												checkWorkspace);
+	const Rect & checkBox = checkWorkspace.boundingBox;
+
+	int intersection = 0;
+	const Rect box = checkBox & floodBoundingBox;
+	for (int y = box.y; y < box.y + box.height; y++)
+	{
+		const uchar * checkRow = checkWorkspace.mask.ptr<uchar>(y);
+		const uchar * maskRow = floodMask.ptr<uchar>(y);
+		for (int x = box.x; x < box.x + box.width; x++)
+		{
+			intersection += ((checkRow[x] != 0) && (maskRow[x] != 0));
+		}
+	}
+
+	if (checkBox.area() > 0)
+	{
+		checkWorkspace.mask(checkBox) = Scalar(0);
+	}
+
+	const int unionArea = floodArea + checkArea - intersection;
+
+	return (unionArea > 0 ? (double) intersection / unionArea : 1.0);
+}
+
+/*
+ * Floods the tracked region within a ROI around its predicted
+ * bounding box. The ROI is enlarged as long as the flood reaches
+ * its borders. Flood exceeding leakFactor times the previous area
+ * is rejected and the previous flood (mask, area, bounding box and
+ * center) is restored with no motion, unless maxConsecutiveLeaks
+ * floods have been rejected in a row, in which case the flood is
+ * unbounded and accepted. Otherwise sets floodArea,
+ * floodBoundingBox, centerSeed and the mask.
+ * @return the seed of the accepted flood
+ * @pre region has been flooded and source image is a 8 bits image
+ */
+Point CvFloodFill::trackFlood()
+{
+	const Rect imageRect(Point(0, 0), dim);
+
+	// predicted displacement of the region since last flood
+	const Point shift(cvRound(floodVelocity.x), cvRound(floodVelocity.y));
+
+	// flood is unbounded after too many consecutive leaks
+	floodWorkspace.maxArea =
+		((leakFactor > 0.0f) && (leakCount < maxConsecutiveLeaks) ?
+		 max(cvRound(leakFactor * floodArea), minLeakArea) : 0);
+
+	/*
+	 * Tries the predicted seed first, then the last barycenter when the
+	 * predicted seed leads to a leak (prediction might be wrong)
+	 */
+	Point seed;
+	Rect roi;
+	int area = 0;
+	const int nbAttempts = (shift == Point(0, 0) ? 1 : 2);
+	for (int attempt = 0; attempt < nbAttempts; attempt++)
+	{
+		const Point attemptShift = (attempt == 0 ? shift : Point(0, 0));
+		seed = centerSeed + attemptShift;
+		seed.x = min(max(seed.x, 0), dim.width - 1);
+		seed.y = min(max(seed.y, 0), dim.height - 1);
+
+		// ROI around predicted bounding box (containing the seed)
+		Rect predicted = floodBoundingBox + attemptShift;
+		int mx = max(cvRound(predicted.width * roiMargin), minRoiMargin);
+		int my = max(cvRound(predicted.height * roiMargin), minRoiMargin);
+		roi = (Rect(predicted.x - mx, predicted.y - my,
+					predicted.width + 2 * mx, predicted.height + 2 * my) |
+			   Rect(seed, Size(1, 1))) & imageRect;
+
+		for (;;)
+		{
+			floodWorkspace.bounds = roi;
+			if (isColor)
+			{
+				area = scanlineFloodFill<3>(*sourceImage, NULL, seed,
+											loDiff, upDiff, floodColor,
+											floodWorkspace);
+			}
+			else
+			{
+				area = scanlineFloodFill<1>(*sourceImage, NULL, seed,
+											loDiff, upDiff, floodColor,
+											floodWorkspace);
+			}
+
+			if (floodWorkspace.leaked || !floodWorkspace.touchedBounds ||
+				(roi == imageRect))
+			{
+				break;
+			}
+
+			// flood reached ROI borders : flood again in a twice larger ROI
+			floodMask(floodWorkspace.boundingBox) = Scalar(0);
+			roi = Rect(roi.x - roi.width / 2, roi.y - roi.height / 2,
+					   roi.width * 2, roi.height * 2) & imageRect;
+		}
+
+		if (!floodWorkspace.leaked)
+		{
+			break;
+		}
+
+		// leaked flood is cleared
+		floodMask(floodWorkspace.boundingBox) = Scalar(0);
+	}
+
+	floodROI = roi;
+	floodLeaked = floodWorkspace.leaked;
+
+	if (floodLeaked)
+	{
+		/*
+		 * previous flood is restored (mask, area, bounding box and center)
+		 * so it is still displayed, motion is lost
+		 */
+		leakCount++;
+		previousMask(floodBoundingBox).copyTo(floodMask(floodBoundingBox));
+		maskDirtyRect = floodBoundingBox;
+		floodVelocity = Point2f(0.0f, 0.0f);
+		return centerSeed;
+	}
+
+	leakCount = 0;
+
+	floodArea = area;
+	floodBoundingBox = floodWorkspace.boundingBox;
+	maskDirtyRect = floodBoundingBox;
+
+	// new barycenter and smoothed motion
+	Point center((int)(floodWorkspace.m10 / area),
+				 (int)(floodWorkspace.m01 / area));
+	Point motion = center - centerSeed;
+	floodVelocity = 0.5f * floodVelocity +
+					0.5f * Point2f((float) motion.x, (float) motion.y);
+	centerSeed = center;
+
+	if (showBoundingBox)
+	{
+		rectangle(*sourceImage, floodROI, Scalar(0, 255, 255), 1);
+	}
+
+	return seed;
+}
+
+/*
+ * Composes the single region flood into source image (which is then
+ * displayed as the merged image): flooded pixels of floodMask are set to
+ * floodColor within the flood bounding box only
+ */
+void CvFloodFill::composeFlood()
+{
+	const Rect box = floodBoundingBox & Rect(Point(0, 0), dim);
+
+	if (box.area() > 0)
+	{
+		(*sourceImage)(box).setTo(floodColor, floodMask(box));
+	}
+}
+
+/*
+ * Parallel loop body flooding regions with #floodRegions
+ */
+class CvFloodFill::RegionFlooder : public ParallelLoopBody
+{
+	private:
+		/**
+		 * The flood fill processor to flood regions of
+		 */
+		CvFloodFill * processor;
+
+		/**
+		 * The number of workers regions are distributed to
+		 */
+		const size_t nbWorkers;
+
+	public:
+		/**
+		 * Region flooder constructor
+		 * @param processor the flood fill processor to flood regions of
+		 * @param nbWorkers the number of workers regions are distributed to
+		 */
+		RegionFlooder(CvFloodFill * processor, const size_t nbWorkers) :
+			processor(processor),
+			nbWorkers(nbWorkers)
+		{}
+
+		/**
+		 * Floods regions of workers in range
+		 * @param range the range of workers
+		 */
+		void operator()(const Range & range) const
+		{
+			for (int w = range.start; w < range.end; w++)
+			{
+				processor->floodRegions((size_t) w, nbWorkers);
+			}
+		}
+};
+
+/*
+ * Floods regions assigned to a worker: regions worker,
+ * worker + nbWorkers, worker + 2 * nbWorkers, ...
+ * @param worker the worker index (which is also the index of the
+ * workspace to use)
+ * @param nbWorkers the number of workers
+ */
+void CvFloodFill::floodRegions(const size_t worker, const size_t nbWorkers)
+{
+	FloodWorkspace & workspace = regionWorkspaces[worker];
+
+	for (size_t i = worker; i < regions.size(); i += nbWorkers)
+	{
+		FloodRegion & region = regions[i];
+		Point seed = region.flooded ? region.center : region.initialSeed;
+
+		// Check seed is inside image
+		seed.x = min(max(seed.x, 0), dim.width - 1);
+		seed.y = min(max(seed.y, 0), dim.height - 1);
+
+		region.spans.clear();
+		if (isColor)
+		{
+			region.area = scanlineFloodFill<3>(*sourceImage, NULL, seed,
+											   region.loDiff, region.upDiff,
+											   region.color, workspace,
+											   &region.spans);
+		}
+		else
+		{
+			region.area = scanlineFloodFill<1>(*sourceImage, NULL, seed,
+											   region.loDiff, region.upDiff,
+											   region.color, workspace,
+											   &region.spans);
+		}
+		region.m10 = workspace.m10;
+		region.m01 = workspace.m01;
+		region.boundingBox = workspace.boundingBox;
+
+		// clears workspace mask for the next region of this worker
+		if (region.boundingBox.area() > 0)
+		{
+			workspace.mask(region.boundingBox) = Scalar(0);
+		}
+	}
+}
+
+/*
+ * Floods all regions in multi-region mode: regions are flooded
+ * independently (in parallel) then merged in regions order into
+ * the label image and the mask (and the merged image when displayed).
+ */
+void CvFloodFill::updateRegions()
+{
+	regionConflicts = 0;
+	floodArea = 0;
+
+	if (regions.empty())
+	{
+		return;
+	}
+
+	// clears labels and mask where previous floods have set them
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		const Rect & box = regions[i].boundingBox;
+		if (box.area() > 0)
+		{
+			labels(box) = Scalar(0);
+			floodMask(box) = Scalar(0);
+		}
+	}
+
+	// Flood each region in its worker's private workspace
+	size_t nbWorkers = min(parallelThreads, regions.size());
+	while (regionWorkspaces.size() < nbWorkers)
+	{
+		regionWorkspaces.push_back(FloodWorkspace());
+		setupWorkspace(regionWorkspaces.back(), dim, true);
+	}
+
+	if (nbWorkers > 1)
+	{
+		parallel_for_(Range(0, (int) nbWorkers),
+					  RegionFlooder(this, nbWorkers),
+					  (double) nbWorkers);
+	}
+	else
+	{
+		floodRegions(0, 1);
+	}
+
+	/*
+	 * Deterministic merge in regions order: pixels flooded by several
+	 * regions belong to the region with the lowest index and are removed
+	 * from the moments of the others.
+	 * Regions colors are composed into source image only when merged
+	 * image is displayed.
+	 */
+	const int cn = isColor ? 3 : 1;
+	const uchar maskValue = saturate_cast<uchar>(newMaskVal);
+	const bool compose = (displayMode == MERGED_IM);
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		FloodRegion & region = regions[i];
+		const int label = (int) i + 1;
+		uchar color[3];
+		for (int c = 0; c < cn; c++)
+		{
+			color[c] = saturate_cast<uchar>(region.color[c]);
+		}
+
+		int lost = 0;
+		int64 lostM10 = 0;
+		int64 lostM01 = 0;
+		for (size_t s = 0; s < region.spans.size(); s++)
+		{
+			const FloodSpan & span = region.spans[s];
+			int * labelRow = labels.ptr<int>(span.y);
+			uchar * maskRow = floodMask.ptr<uchar>(span.y);
+			uchar * pixel = sourceImage->ptr<uchar>(span.y) + span.xl * cn;
+
+			for (int x = span.xl; x <= span.xr; x++, pixel += cn)
+			{
+				if (labelRow[x] == 0)
+				{
+					labelRow[x] = label;
+					maskRow[x] = maskValue;
+					for (int c = 0; compose && (c < cn); c++)
+					{
+						pixel[c] = color[c];
+					}
+				}
+				else
+				{
+					lost++;
+					lostM10 += x;
+					lostM01 += span.y;
+				}
+			}
+		}
+
+		region.area -= lost;
+		region.m10 -= lostM10;
+		region.m01 -= lostM01;
+		regionConflicts += lost;
+		floodArea += region.area;
+
+		// A region which lost all its pixels is flooded again from its
+		// initial seed
+		region.flooded = (region.area > 0);
+
+		if (region.flooded)
+		{
+			region.center.x = (int)(region.m10 / region.area);
+			region.center.y = (int)(region.m01 / region.area);
+		}
+	}
+
+	// Draws regions once all of them have been composed
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		const FloodRegion & region = regions[i];
+		if (region.flooded)
+		{
+			if (showBoundingBox)
+			{
+				rectangle(*sourceImage, region.boundingBox, region.color, 3,
+						  CV_AA);
+			}
+
+			if (showSeed)
+			{
+				circle(*sourceImage, region.center, 3, Scalar(0, 0, 255), 2,
+					   CV_AA);
+			}
+		}
+	}
+}
+
+/*
+ * Checks if two neighbor pixels belong to the same segment: one of them
+ * is within floating range of the other
+ * @param q the first pixel
+ * @param p the second pixel
+ * @param loDiff the lower difference
+ * @param range loDiff + upDiff
+ * @return true if q can be flooded from p or p can be flooded from q
+ */
+template<int cn>
+static inline bool segmentAccept(const uchar * q,
+								 const uchar * p,
+								 const int loDiff,
+								 const unsigned int range)
+{
+	return floatingAccept<cn>(q, p, loDiff, range) ||
+		   floatingAccept<cn>(p, q, loDiff, range);
+}
+
+/*
+ * Finds the root of a pixel in union-find parents and halves its path to
+ * the root on the way
+ * @param parents the parent pixel index of each pixel
+ * @param i the pixel index
+ * @return the root pixel index (which is also the smallest pixel index of
+ * its set)
+ */
+static inline int findRoot(int * parents, int i)
+{
+	while (parents[i] != i)
+	{
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+
+	return i;
+}
+
+/*
+ * Joins the set of a root to the set of a pixel: the largest root is
+ * linked to the smallest one so the root of a set is always its smallest
+ * pixel index
+ * @param parents the parent pixel index of each pixel
+ * @param root the root of the first set
+ * @param j a pixel of the second set
+ * @return the root of the joined set
+ */
+static inline int joinRoots(int * parents, const int root, const int j)
+{
+	const int other = findRoot(parents, j);
+
+	if (other < root)
+	{
+		parents[root] = other;
+		return other;
+	}
+	else if (other > root)
+	{
+		parents[other] = root;
+	}
+
+	return root;
+}
+
+/*
+ * Parallel loop body processing bands of rows with #segmentBand
+ * or #renderSegments
+ */
+class CvFloodFill::Segmenter : public ParallelLoopBody
+{
+	private:
+		/**
+		 * The flood fill processor to segment the image of
+		 */
+		CvFloodFill * processor;
+
+		/**
+		 * The number of bands of rows
+		 */
+		const int nbBands;
+
+		/**
+		 * Renders the segmented image if true, labels bands otherwise
+		 */
+		const bool render;
+
+	public:
+		/**
+		 * Segmenter constructor
+		 * @param processor the flood fill processor to segment the image of
+		 * @param nbBands the number of bands of rows
+		 * @param render renders the segmented image if true, labels bands
+		 * otherwise
+		 */
+		Segmenter(CvFloodFill * processor,
+				  const int nbBands,
+				  const bool render) :
+			processor(processor),
+			nbBands(nbBands),
+			render(render)
+		{}
+
+		/**
+		 * Processes bands in range
+		 * @param range the range of bands
+		 */
+		void operator()(const Range & range) const
+		{
+			for (int b = range.start; b < range.end; b++)
+			{
+				if (render)
+				{
+					processor->renderSegments(b, nbBands);
+				}
+				else if (processor->isColor)
+				{
+					processor->segmentBand<3>(b, nbBands);
+				}
+				else
+				{
+					processor->segmentBand<1>(b, nbBands);
+				}
+			}
+		}
+};
+
+/*
+ * Joins pixels of a band of rows to their left and upper neighbors
+ * within floating range: pixels of a band are only linked to pixels
+ * of the same band so that bands can be processed concurrently.
+ * @param band the band index
+ * @param nbBands the number of bands
+ */
+template<int cn>
+void CvFloodFill::segmentBand(const int band, const int nbBands)
+{
+	const int width = dim.width;
+	const int yStart = (dim.height * band) / nbBands;
+	const int yEnd = (dim.height * (band + 1)) / nbBands;
+	const bool conn8 = (connectivity == 8);
+	const unsigned int range = (unsigned int)(loDiff + upDiff);
+	int * parents = segmentLabels.ptr<int>(0);
+
+	for (int y = yStart; y < yEnd; y++)
+	{
+		const uchar * row = sourceImage->ptr<uchar>(y);
+		const uchar * upRow =
+			(y > yStart ? sourceImage->ptr<uchar>(y - 1) : NULL);
+		int * parentRow = segmentLabels.ptr<int>(y);
+		const int i0 = y * width;
+
+		for (int x = 0; x < width; x++)
+		{
+			const int i = i0 + x;
+			const uchar * pixel = row + x * cn;
+			int root = i;
+
+			if ((x > 0) && segmentAccept<cn>(pixel, pixel - cn, loDiff, range))
+			{
+				root = findRoot(parents, i - 1);
+			}
+			parentRow[x] = root;
+
+			if (upRow == NULL)
+			{
+				continue;
+			}
+
+			const uchar * up = upRow + x * cn;
+			if (segmentAccept<cn>(pixel, up, loDiff, range))
+			{
+				root = joinRoots(parents, root, i - width);
+			}
+
+			if (conn8)
+			{
+				if ((x > 0) && segmentAccept<cn>(pixel, up - cn, loDiff, range))
+				{
+					root = joinRoots(parents, root, i - width - 1);
+				}
+				if ((x < width - 1) &&
+					segmentAccept<cn>(pixel, up + cn, loDiff, range))
+				{
+					root = joinRoots(parents, root, i - width + 1);
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Joins pixels of the first row of a band to their neighbors in the
+ * last row of the previous band
+ * @param y the first row of the band
+ */
+template<int cn>
+void CvFloodFill::joinBands(const int y)
+{
+	const int width = dim.width;
+	const bool conn8 = (connectivity == 8);
+	const unsigned int range = (unsigned int)(loDiff + upDiff);
+	int * parents = segmentLabels.ptr<int>(0);
+	const uchar * row = sourceImage->ptr<uchar>(y);
+	const uchar * upRow = sourceImage->ptr<uchar>(y - 1);
+	const int i0 = y * width;
+
+	for (int x = 0; x < width; x++)
+	{
+		const int i = i0 + x;
+		const uchar * pixel = row + x * cn;
+		const uchar * up = upRow + x * cn;
+		int root = -1;
+
+		if (segmentAccept<cn>(pixel, up, loDiff, range))
+		{
+			root = joinRoots(parents, findRoot(parents, i), i - width);
+		}
+
+		if (conn8)
+		{
+			if ((x > 0) && segmentAccept<cn>(pixel, up - cn, loDiff, range))
+			{
+				root = joinRoots(parents,
+								 root >= 0 ? root : findRoot(parents, i),
+								 i - width - 1);
+			}
+			if ((x < width - 1) &&
+				segmentAccept<cn>(pixel, up + cn, loDiff, range))
+			{
+				root = joinRoots(parents,
+								 root >= 0 ? root : findRoot(parents, i),
+								 i - width + 1);
+			}
+		}
+	}
+}
+
+/*
+ * Adds a run of pixels of a row to a segment area and bounding box
+ * @param segment the segment
+ * @param xl the left end of the run
+ * @param xr the right end of the run
+ * @param y the row of the run (rows are added in increasing order)
+ */
+static inline void addSegmentRun(CvFloodFill::FloodSegment & segment,
+								 const int xl,
+								 const int xr,
+								 const int y)
+{
+	Rect & box = segment.boundingBox;
+	const int left = min(box.x, xl);
+	const int right = max(box.x + box.width - 1, xr);
+	box.x = left;
+	box.width = right - left + 1;
+	box.height = y - box.y + 1;
+	segment.area += xr - xl + 1;
+}
+
+/*
+ * Numbers segments in raster order (replaces parents by segment
+ * indices in segmentLabels) and computes segments statistics
+ */
+template<int cn>
+void CvFloodFill::labelSegments()
+{
+	const int width = dim.width;
+	int * labelsData = segmentLabels.ptr<int>(0);
+
+	segments.clear();
+
+	/*
+	 * Parent of a pixel is always a smaller pixel index of its segment
+	 * so it has already been replaced by the segment index when the pixel
+	 * is reached
+	 */
+	for (int y = 0; y < dim.height; y++)
+	{
+		const uchar * pixel = sourceImage->ptr<uchar>(y);
+		int * labelRow = segmentLabels.ptr<int>(y);
+		const int i0 = y * width;
+		int runLabel = -1;
+		int runStart = 0;
+
+		for (int x = 0; x < width; x++, pixel += cn)
+		{
+			const int parent = labelRow[x];
+			int label;
+			if (parent == i0 + x)
+			{
+				label = (int) segments.size();
+				FloodSegment segment;
+				segment.area = 0;
+				segment.sum[0] = segment.sum[1] = segment.sum[2] = 0;
+				segment.boundingBox = Rect(x, y, 1, 1);
+				segments.push_back(segment);
+			}
+			else
+			{
+				label = labelsData[parent];
+			}
+			labelRow[x] = label;
+
+			int64 * sum = segments[label].sum;
+			for (int c = 0; c < cn; c++)
+			{
+				sum[c] += pixel[c];
+			}
+
+			if (label != runLabel)
+			{
+				if (runLabel >= 0)
+				{
+					addSegmentRun(segments[runLabel], runStart, x - 1, y);
+				}
+				runLabel = label;
+				runStart = x;
+			}
+		}
+
+		if (runLabel >= 0)
+		{
+			addSegmentRun(segments[runLabel], runStart, width - 1, y);
+		}
+	}
+
+	// mean colors
+	segmentPalette.resize(segments.size() * cn);
+	for (size_t i = 0; i < segments.size(); i++)
+	{
+		FloodSegment & segment = segments[i];
+		uchar * color = &segmentPalette[i * cn];
+		for (int c = 0; c < cn; c++)
+		{
+			color[c] = (uchar)((segment.sum[c] + segment.area / 2) /
+							   segment.area);
+			segment.color[c] = color[c];
+		}
+	}
+}
+
+/*
+ * Draws a band of rows of the segmented image with segments mean
+ * colors
+ * @param band the band index
+ * @param nbBands the number of bands
+ */
+void CvFloodFill::renderSegments(const int band, const int nbBands)
+{
+	const int cn = isColor ? 3 : 1;
+	const int yStart = (dim.height * band) / nbBands;
+	const int yEnd = (dim.height * (band + 1)) / nbBands;
+	const uchar * palette = &segmentPalette[0];
+
+	for (int y = yStart; y < yEnd; y++)
+	{
+		const int * labelRow = segmentLabels.ptr<int>(y);
+		uchar * pixel = segmented.ptr<uchar>(y);
+
+		for (int x = 0; x < dim.width; x++, pixel += cn)
+		{
+			const uchar * color = palette + labelRow[x] * cn;
+			for (int c = 0; c < cn; c++)
+			{
+				pixel[c] = color[c];
+			}
+		}
+	}
+}
+
+/*
+ * Segments the whole image into uniform regions (only computed
+ * when SEGMENTED_IM is displayed): this is the result of flooding
+ * from every pixel not flooded yet, computed with a union-find on
+ * pixels instead of floods so it can be parallelized:
+ * 	- each band of rows is labeled independently (in parallel)
+ * 	- labels of neighbor pixels across bands borders are merged
+ * 	- segments are numbered in raster order and their area, mean
+ * 	color and bounding box are computed
+ * 	- segmented image is rendered with segments mean colors (in
+ * 	parallel)
+ * Two neighbor pixels belong to the same segment when one of them
+ * is within floating range [-loDiff, +upDiff] of the other
+ * (ffillMode does not apply since there is no seed value to compare
+ * to).
+ * @pre source image is a 8UC1 or 8UC3 image
+ */
+void CvFloodFill::segmentImage()
+{
+	const int nbBands = (int) min(parallelThreads, (size_t) dim.height);
+
+	// Labels each band independently
+	if (nbBands > 1)
+	{
+		parallel_for_(Range(0, nbBands),
+					  Segmenter(this, nbBands, false),
+					  (double) nbBands);
+	}
+	else if (isColor)
+	{
+		segmentBand<3>(0, 1);
+	}
+	else
+	{
+		segmentBand<1>(0, 1);
+	}
+
+	// Merges segments across bands borders and numbers segments
+	for (int b = 1; b < nbBands; b++)
+	{
+		if (isColor)
+		{
+			joinBands<3>((dim.height * b) / nbBands);
+		}
+		else
+		{
+			joinBands<1>((dim.height * b) / nbBands);
+		}
+	}
+
+	if (isColor)
+	{
+		labelSegments<3>();
+	}
+	else
+	{
+		labelSegments<1>();
+	}
+
+	// Draws segments with their mean color
+	if (nbBands > 1)
+	{
+		parallel_for_(Range(0, nbBands),
+					  Segmenter(this, nbBands, true),
+					  (double) nbBands);
+	}
+	else
+	{
+		renderSegments(0, 1);
+	}
+}
+
+/*
+ * Gets the ROI tracking status
+ * @return true if ROI tracking is on
+ */
+bool CvFloodFill::isRoiTracking() const
+{
+	return roiTracking;
+}
+
+/*
+ * Sets the ROI tracking status
+ * @param roiTracking the new ROI tracking status
+ * @note ROI tracking is only used with the SCANLINE_FLOOD engine
+ */
+void CvFloodFill::setRoiTracking(const bool roiTracking)
+{
+	this->roiTracking = roiTracking;
+	floodVelocity = Point2f(0.0f, 0.0f);
+	floodROI = Rect(0, 0, 0, 0);
+	floodLeaked = false;
+	leakCount = 0;
+
+	resetMeanProcessTime();
+}
+
+/*
+ * Gets the ROI margin relative to the predicted bounding box size
+ * @return the ROI margin
+ */
+float CvFloodFill::getRoiMargin() const
+{
+	return roiMargin;
+}
+
+/*
+ * Sets the ROI margin relative to the predicted bounding box size
+ * @param roiMargin the new ROI margin (should be positive)
+ */
+void CvFloodFill::setRoiMargin(const float roiMargin)
+{
+	if (roiMargin >= 0.0f)
+	{
+		this->roiMargin = roiMargin;
+	}
+	else
+	{
+		cerr << "CvFloodFill::setRoiMargin(" << roiMargin
+			 << ") : invalid value" << endl;
+	}
+}
+
+/*
+ * Gets the leak protection factor
+ * @return the leak protection factor
+ */
+float CvFloodFill::getLeakFactor() const
+{
+	return leakFactor;
+}
+
+/*
+ * Sets the leak protection factor
+ * @param leakFactor the new leak protection factor (should be
+ * greater than 1, or 0 to disable leak protection)
+ */
+void CvFloodFill::setLeakFactor(const float leakFactor)
+{
+	if ((leakFactor == 0.0f) || (leakFactor > 1.0f))
+	{
+		this->leakFactor = leakFactor;
+	}
+	else
+	{
+		cerr << "CvFloodFill::setLeakFactor(" << leakFactor
+			 << ") : invalid value" << endl;
+	}
+}
+
+/*
+ * Gets the ROI used by the last tracked flood
+ * @return the ROI used by the last tracked flood
+ */
+const Rect & CvFloodFill::getFloodROI() const
+{
+	return floodROI;
+}
+
+/*
+ * Indicates if the last tracked flood has been rejected as a leak
+ * @return true if last tracked flood was a leak
+ */
+bool CvFloodFill::isFloodLeaked() const
+{
+	return floodLeaked;
+}
+
+/*
+ * Gets the number of pyramid levels of the pyramid flood
+ * @return the number of pyramid levels
+ */
+int CvFloodFill::getPyramidLevels() const
+{
+	return pyramidLevels;
+}
+
+/*
+ * Sets the number of pyramid levels of the pyramid flood
+ * @param pyramidLevels the new number of pyramid levels in [1..4]
+ */
+void CvFloodFill::setPyramidLevels(const int pyramidLevels)
+{
+	if ((pyramidLevels >= 1) && (pyramidLevels <= 4))
+	{
+		this->pyramidLevels = pyramidLevels;
+		// coarse workspace is recreated on next flood
+		pyramidWorkspace.mask.release();
+	}
+	else
+	{
+		cerr << "CvFloodFill::setPyramidLevels(" << pyramidLevels
+			 << ") : invalid value" << endl;
+	}
+
+	resetMeanProcessTime();
+}
+
+/*
+ * Gets the pyramid flood check status
+ * @return true if pyramid floods are checked against full
+ * resolution floods
+ */
+bool CvFloodFill::isPyramidCheck() const
+{
+	return pyramidCheck;
+}
+
+/*
+ * Sets the pyramid flood check status
+ * @param pyramidCheck the new pyramid flood check status
+ */
+void CvFloodFill::setPyramidCheck(const bool pyramidCheck)
+{
+	this->pyramidCheck = pyramidCheck;
+	pyramidIoU = 0.0;
+}
+
+/*
+ * Gets the intersection over union of the last checked pyramid
+ * flood and the full resolution flood
+ * @return the last pyramid flood intersection over union
+ */
+double CvFloodFill::getPyramidIoU() const
+{
+	return pyramidIoU;
+}
+
+/*
+ * Gets the multi-region mode status
+ * @return true if multi-region mode is on
+ */
+bool CvFloodFill::isMultiRegion() const
+{
+	return multiRegion;
+}
+
+/*
+ * Sets the multi-region mode status. Current flood is cleared.
+ * @param multiRegion the new multi-region mode status
+ * @note multi-region mode requires a 8UC1 or 8UC3 source image
+ */
+void CvFloodFill::setMultiRegion(const bool multiRegion)
+{
+	if (multiRegion && (type != CV_8UC1) && (type != CV_8UC3))
+	{
+		cerr << "CvFloodFill::setMultiRegion : multi-region mode requires "
+			 << "a 8 bits image" << endl;
+		return;
+	}
+
+	clearFlood();
+	this->multiRegion = multiRegion;
+
+	// previous floods are cleared entirely
+	mask = Scalar(0);
+	maskDirtyRect = Rect(0, 0, 0, 0);
+	labels = Scalar(0);
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		regions[i].flooded = false;
+		regions[i].boundingBox = Rect(0, 0, 0, 0);
+	}
+}
+
+/*
+ * Adds a new region to track in multi-region mode with current
+ * loDiff and upDiff and a random color
+ * @param seed the initial seed of the new region
+ */
+void CvFloodFill::addRegion(const Point & seed)
+{
+	FloodRegion region;
+	region.initialSeed = seed;
+	region.center = seed;
+	region.flooded = false;
+	region.loDiff = loDiff;
+	region.upDiff = upDiff;
+
+	// random numbers for region color
+	int b = (unsigned)theRNG() & 255;
+	int g = (unsigned)theRNG() & 255;
+	int r = (unsigned)theRNG() & 255;
+	region.color = isColor ? Scalar(b, g, r) :
+							 Scalar(r*0.299 + g*0.587 + b*0.114);
+
+	region.area = 0;
+	region.m10 = 0;
+	region.m01 = 0;
+	region.boundingBox = Rect(0, 0, 0, 0);
+
+	regions.push_back(region);
+}
+
+/*
+ * Removes all regions of multi-region mode
+ */
+void CvFloodFill::clearRegions()
+{
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		const Rect & box = regions[i].boundingBox;
+		if (box.area() > 0)
+		{
+			labels(box) = Scalar(0);
+			floodMask(box) = Scalar(0);
+		}
+	}
+
+	regions.clear();
+	regionConflicts = 0;
+	floodArea = 0;
+	resetMeanProcessTime();
+}
+
+/*
+ * Gets the number of regions tracked in multi-region mode
+ * @return the number of regions
+ */
+size_t CvFloodFill::getNbRegions() const
+{
+	return regions.size();
+}
+
+/*
+ * Gets a region tracked in multi-region mode
+ * @param i the region index
+ * @return the ith region
+ * @pre i < getNbRegions()
+ */
+const CvFloodFill::FloodRegion & CvFloodFill::getRegion(const size_t i) const
+{
+	assert(i < regions.size());
+
+	return regions[i];
+}
+
+/*
+ * Sets the lower and upper difference of a region
+ * @param i the region index
+ * @param loDiff the new lower difference of the region
+ * @param upDiff the new upper difference of the region
+ */
+void CvFloodFill::setRegionDiffs(const size_t i,
+								 const int loDiff,
+								 const int upDiff)
+{
+	if ((i < regions.size()) &&
+		(loDiff >= 0) && (loDiff <= 255) && (upDiff >= 0) && (upDiff <= 255))
+	{
+		regions[i].loDiff = loDiff;
+		regions[i].upDiff = upDiff;
+	}
+	else
+	{
+		cerr << "CvFloodFill::setRegionDiffs(" << i << ", " << loDiff << ", "
+			 << upDiff << ") : invalid values" << endl;
+	}
+}
+
+/*
+ * Gets the label image of multi-region mode
+ * @return the label image
+ */
+const Mat & CvFloodFill::getLabels() const
+{
+	return labels;
+}
+
+/*
+ * Gets the number of pixels flooded by several regions during
+ * last update
+ * @return the number of conflicting pixels
+ */
+int CvFloodFill::getRegionConflicts() const
+{
+	return regionConflicts;
+}
+
+/*
+ * Gets the number of threads used to flood regions
+ * @return the number of threads used to flood regions
+ */
+size_t CvFloodFill::getParallel() const
+{
+	return parallelThreads;
+}
+
+/*
+ * Sets the number of threads used to flood regions (and to segment
+ * the whole image)
+ * @param threads the number of threads to use (values below 1
+ * are clamped to 1, which means sequential flooding)
+ */
+void CvFloodFill::setParallel(const int threads)
+{
+	parallelThreads = (threads > 1 ? (size_t) threads : 1);
+
+	// Previous timings are irrelevant with the new number of threads
+	resetMeanProcessTime();
+}
+
+/*
+ * Gets the number of segments of the last whole image segmentation
+ * @return the number of segments
+ */
+size_t CvFloodFill::getNbSegments() const
+{
+	return segments.size();
+}
+
+/*
+ * Gets a segment of the last whole image segmentation
+ * @param i the segment index
+ * @return the ith segment
+ * @pre i < getNbSegments()
+ */
+const CvFloodFill::FloodSegment & CvFloodFill::getSegment(const size_t i) const
+{
+	assert(i < segments.size());
+
+	return segments[i];
+}
+
+/*
+ * Gets the segment label image of the last whole image segmentation
+ * @return the segment label image
+ */
+const Mat & CvFloodFill::getSegmentLabels() const
+{
+	return segmentLabels;
+}
+
+/*
+ * Floods the source image several times from the same seed with
+ * the current engine and settings
+ * @param seed the flood seed
+ * @param iterations the number of timed floods (after a first
+ * untimed flood)
+ * @return the mean flood update time in ms
+ * @post the last flood is in floodMask
+ */
+double CvFloodFill::timeFlood(const Point & seed, const int iterations)
+{
+	int64 ticks = 0;
+
+	for (int i = 0; i <= iterations; i++)
+	{
+		clearFlood();
+		setInitialSeed(seed);
+
+		int64 start = getTickCount();
+		update();
+		if (i > 0) // first flood warms up
+		{
+			ticks += getTickCount() - start;
+		}
+	}
+
+	return (ticks * 1000.0) / (getTickFrequency() * (double) iterations);
+}
+
+/*
+ * Benchmarks flood engines on an image: mean flood time of the
+ * cv::floodFill engine, of the scanline engine and of the pyramid
+ * engine (with 1 to 4 levels) from the same seed in fixed and
+ * floating range modes, number of mask pixels differing from the
+ * cv::floodFill flood and intersection over union of pyramid floods
+ * with full resolution floods
+ * @param image the image to flood (8UC1 or 8UC3)
+ * @param seed the flood seed
+ * @param out the stream to print results on
+ * @param iterations the number of timed floods of each engine
+ */
+void CvFloodFill::benchmark(Mat * image,
+							const Point & seed,
+							ostream & out,
+							const int iterations)
+{
+	const FloodFillMode modes[2] = {FIXED_RANGE, FLOATING_RANGE};
+	const char * modeNames[2] = {"fixed", "floating"};
+	const FloodEngine engines[2] = {OPENCV_FLOOD, SCANLINE_FLOOD};
+	const char * engineNames[2] = {"opencv", "scanline"};
+
+	CvFloodFill flood(image);
+	flood.setDisplayMode(MASK_IM);
+	flood.setShowSeed(false);
+	flood.setShowBoundingBox(false);
+
+	Mat reference;
+
+	out << "Flood engines benchmark on " << image->cols << "x" << image->rows
+		<< " " << image->channels() << " channel(s) image from ("
+		<< seed.x << ", " << seed.y << "): mean flood time (ms)" << endl;
+	out << setw(10) << "mode" << setw(10) << "engine" << setw(10) << "area"
+		<< setw(10) << "time" << setw(10) << "diff" << setw(8) << "IoU"
+		<< endl;
+
+	for (int m = 0; m < 2; m++)
+	{
+		flood.setFfillMode(modes[m]);
+
+		for (int e = 0; e < 2; e++)
+		{
+			flood.setFloodEngine(engines[e]);
+
+			double time = flood.timeFlood(seed, iterations);
+
+			if (engines[e] == OPENCV_FLOOD)
+			{
+				flood.floodMask.copyTo(reference);
+			}
+
+			out << setw(10) << modeNames[m] << setw(10) << engineNames[e]
+				<< setw(10) << flood.floodArea
+				<< setw(10) << fixed << setprecision(3) << time
+				<< setw(10) << countNonZero(flood.floodMask != reference)
+				<< setw(8) << "-" << endl;
+		}
+
+		// Pyramid floods (full resolution check is not included in time)
+		flood.setFloodEngine(PYRAMID_FLOOD);
+		for (int levels = 1; levels <= 4; levels++)
+		{
+			flood.setPyramidLevels(levels);
+			flood.setPyramidCheck(false);
+
+			double time = flood.timeFlood(seed, iterations);
+
+			out << setw(10) << modeNames[m] << setw(8) << "pyramid"
+				<< setw(2) << levels
+				<< setw(10) << flood.floodArea
+				<< setw(10) << fixed << setprecision(3) << time
+				<< setw(10) << countNonZero(flood.floodMask != reference);
+
+			flood.setPyramidCheck(true);
+			flood.clearFlood();
+			flood.setInitialSeed(seed);
+			flood.update();
+
+			out << setw(8) << fixed << setprecision(4)
+				<< flood.getPyramidIoU() << endl;
+		}
+		flood.setPyramidCheck(false);
+	}
+}
@@ -8,6 +8,9 @@
 #ifndef CVGFLOODFILL_H_
 #define CVGFLOODFILL_H_
 
+#include <vector>
+using namespace std;
+
 #include "CvProcessor.h"
 
 /**
@@ -24,6 +27,7 @@ class CvFloodFill: virtual public CvProcessor
 			INPUT_IM = 0, //!< Input image
 			MASK_IM, //!< Flood fill mask
 			MERGED_IM, //!< Mixes Input dans flood fill image
+			SEGMENTED_IM, //!< Whole image segmented regions in mean color
 			NBDISPLAY_IM //!< Number of elements in this enum
 		} ImageDisplay;
 
@@ -46,7 +50,220 @@ class CvFloodFill: virtual public CvProcessor
 			NBFILLING_MODES
 		} FloodFillMode;
 
+		/**
+		 * Flood fill engine
+		 */
+		typedef enum
+		{
+			/**
+			 * OpenCV cv::floodFill
+			 */
+			OPENCV_FLOOD = 0,
+			/**
+			 * In-house scanline flood fill (8UC1 and 8UC3 images only, other
+			 * images are flooded with cv::floodFill) reusing its span stack
+			 * between frames and computing flood moments while filling
+			 */
+			SCANLINE_FLOOD,
+			/**
+			 * Coarse to fine scanline flood fill (8UC1 and 8UC3 images only):
+			 * image is flooded at a downscaled pyramid level first, then
+			 * inside of the coarse flood is trusted and only its border band
+			 * is flooded again at full resolution
+			 */
+			PYRAMID_FLOOD,
+			NBFLOOD_ENGINES
+		} FloodEngine;
+
+		/**
+		 * Horizontal span of flooded pixels whose neighbors in the
+		 * next row (y + dy) remain to be checked
+		 */
+		typedef struct
+		{
+			int y;	//!< row of the span
+			int xl;	//!< leftmost flooded pixel of the span
+			int xr;	//!< rightmost flooded pixel of the span
+			int dy;	//!< direction of the row to check (-1 or +1)
+		} FloodSpan;
+
+		/**
+		 * Scanline flood workspace: everything a scanline flood needs
+		 * besides the image, so that several floods can run concurrently,
+		 * each one in its own workspace.
+		 */
+		typedef struct
+		{
+			/**
+			 * Image aligned flood mask (flooded pixels are set to
+			 * newMaskVal)
+			 */
+			Mat mask;
+
+			/**
+			 * Span stack. Only cleared before each flood so its storage is
+			 * reused from one frame to the other.
+			 */
+			vector<FloodSpan> spanStack;
+
+			/**
+			 * Fixed range acceptance of each pixel (1 when pixel value is
+			 * within seed value range, 0 otherwise) computed lazily a whole
+			 * row at a time
+			 */
+			Mat rowPass;
+
+			/**
+			 * Flood index of the last flood which computed each row of
+			 * rowPass
+			 */
+			vector<int> rowStamp;
+
+			/**
+			 * Index of the current flood (used with rowStamp)
+			 */
+			int fillStamp;
+
+			/**
+			 * First order moment m10 (sum of x) of the last flood
+			 */
+			int64 m10;
+
+			/**
+			 * First order moment m01 (sum of y) of the last flood
+			 */
+			int64 m01;
+
+			/**
+			 * Bounding box of the last flood
+			 */
+			Rect boundingBox;
+
+			/**
+			 * Flood bounds: pixels outside bounds are never flooded
+			 * [default value is the whole image]
+			 */
+			Rect bounds;
+
+			/**
+			 * Maximum number of pixels to flood: flood is aborted beyond
+			 * (0 means no limit) [default value is 0]
+			 */
+			int maxArea;
+
+			/**
+			 * Indicates last flood reached bounds where they are not image
+			 * borders
+			 */
+			bool touchedBounds;
+
+			/**
+			 * Indicates last flood has been aborted because it exceeded
+			 * maxArea
+			 */
+			bool leaked;
+		} FloodWorkspace;
+
+		/**
+		 * Region tracked in multi-region mode
+		 */
+		typedef struct
+		{
+			/**
+			 * The initial seed of the region
+			 */
+			Point initialSeed;
+
+			/**
+			 * The last flooded area barycenter: seed of the next flood
+			 */
+			Point center;
+
+			/**
+			 * Indicates the region has been flooded and center can be used
+			 * as the next seed
+			 */
+			bool flooded;
+
+			/**
+			 * Lower difference for pixel aggregation of this region
+			 */
+			int loDiff;
+
+			/**
+			 * Upper difference for pixel aggregation of this region
+			 */
+			int upDiff;
+
+			/**
+			 * Region color in the merged image
+			 */
+			Scalar color;
+
+			/**
+			 * Number of pixels of the region in the label image
+			 */
+			int area;
+
+			/**
+			 * First order moment m10 of the region in the label image
+			 */
+			int64 m10;
+
+			/**
+			 * First order moment m01 of the region in the label image
+			 */
+			int64 m01;
+
+			/**
+			 * Bounding box of the last flood of this region (which contains
+			 * all pixels of this region in the label image)
+			 */
+			Rect boundingBox;
+
+			/**
+			 * Spans flooded by this region during the last update
+			 */
+			vector<FloodSpan> spans;
+		} FloodRegion;
+
+		/**
+		 * Uniform region of the whole image segmentation
+		 */
+		typedef struct
+		{
+			/**
+			 * Number of pixels of the segment
+			 */
+			int area;
+
+			/**
+			 * Sum of each channel values over the segment pixels
+			 */
+			int64 sum[3];
+
+			/**
+			 * Mean color of the segment
+			 */
+			Scalar color;
+
+			/**
+			 * Bounding box of the segment
+			 */
+			Rect boundingBox;
+		} FloodSegment;
+
 	protected:
+		/**
+		 * State of coarse pixels of the pyramid flood
+		 */
+		typedef enum
+		{
+			PYRAMID_OUTSIDE = 0,	//!< away from the coarse flood: not flooded
+			PYRAMID_BAND,			//!< near the coarse flood border: refined
+			PYRAMID_INSIDE			//!< inside the coarse flood: flooded
+		} PyramidState;
+
 		// --------------------------------------------------------------------
 		// image parameters
 		// --------------------------------------------------------------------
@@ -71,9 +288,17 @@ class CvFloodFill: virtual public CvProcessor
 		Mat mask;
 
 		/**
-		 * Merged Source and flood fill image
+		 * Image aligned view of the mask image (mask without its 1 pixel
+		 * border) so that mask pixel of image pixel (x, y) is at (x, y)
 		 */
-		Mat merged;
+		Mat floodMask;
+
+		/**
+		 * Region of floodMask set by the last flood which should be cleared
+		 * before next flood (mask is never written outside the flooded area
+		 * bounding box so there is no need to clear the whole mask)
+		 */
+		Rect maskDirtyRect;
 
 		/**
 		 * Image display mode.
@@ -182,6 +407,211 @@ class CvFloodFill: virtual public CvProcessor
 		 */
 		bool showBoundingBox;
 
+		// -------------------------------------------------------------------
+		// Scanline flood engine
+		// -------------------------------------------------------------------
+		/**
+		 * The flood fill engine used to flood the image
+		 * [default value is OPENCV_FLOOD]
+		 */
+		FloodEngine floodEngine;
+
+		/**
+		 * Scanline engine workspace of the single region flood (its mask is
+		 * floodMask)
+		 */
+		FloodWorkspace floodWorkspace;
+
+		// -------------------------------------------------------------------
+		// Pyramid flood engine
+		// -------------------------------------------------------------------
+		/**
+		 * Number of pyramid levels of the pyramid flood: coarse image is
+		 * 2^pyramidLevels times smaller [default value is 2]
+		 */
+		int pyramidLevels;
+
+		/**
+		 * Downscaled source image flooded by the pyramid flood
+		 */
+		Mat pyramidImage;
+
+		/**
+		 * Scanline engine workspace of the coarse flood
+		 */
+		FloodWorkspace pyramidWorkspace;
+
+		/**
+		 * State (PyramidState) of each pixel of the coarse image
+		 */
+		Mat pyramidState;
+
+		/**
+		 * Eroded coarse flood mask
+		 */
+		Mat pyramidInside;
+
+		/**
+		 * Pixels queue of the full resolution refinement
+		 */
+		vector<Point> pyramidStack;
+
+		/**
+		 * Indicates pyramid flood is checked against a full resolution
+		 * scanline flood (which is not included in process time)
+		 * [default value is false]
+		 */
+		bool pyramidCheck;
+
+		/**
+		 * Full resolution flood workspace of the pyramid flood check
+		 */
+		FloodWorkspace checkWorkspace;
+
+		/**
+		 * Intersection over union of the last checked pyramid flood and
+		 * the full resolution flood from the same seed
+		 */
+		double pyramidIoU;
+
+		// -------------------------------------------------------------------
+		// ROI tracking
+		// -------------------------------------------------------------------
+		/**
+		 * Indicates ROI tracking is on: once flooded, the region is
+		 * flooded again only within a ROI around its predicted bounding
+		 * box (requires the SCANLINE_FLOOD engine and a 8 bits image)
+		 * [default value is false]
+		 */
+		bool roiTracking;
+
+		/**
+		 * Smoothed motion of the flood barycenter between two frames
+		 * (used to predict the next flood bounding box)
+		 */
+		Point2f floodVelocity;
+
+		/**
+		 * ROI margin around the predicted bounding box relative to its size
+		 * [default value is 0.25]
+		 */
+		float roiMargin;
+
+		/**
+		 * Minimum ROI margin around the predicted bounding box (in pixels)
+		 */
+		static const int minRoiMargin;
+
+		/**
+		 * Leak protection: a tracked flood is rejected when its area
+		 * exceeds leakFactor times the previous flood area (0 means no leak
+		 * protection) [default value is 4]
+		 */
+		float leakFactor;
+
+		/**
+		 * Minimum area allowed to a tracked flood by leak protection so
+		 * that small regions can still grow
+		 */
+		static const int minLeakArea;
+
+		/**
+		 * The ROI used by the last tracked flood
+		 */
+		Rect floodROI;
+
+		/**
+		 * Indicates the last tracked flood has been rejected as a leak
+		 */
+		bool floodLeaked;
+
+		/**
+		 * Number of consecutive tracked floods rejected as leaks
+		 */
+		int leakCount;
+
+		/**
+		 * Number of consecutive leaks after which the region is considered
+		 * as really grown (e.g. when an occluder leaves) and the next
+		 * tracked flood is accepted whatever its area
+		 */
+		static const int maxConsecutiveLeaks;
+
+		/**
+		 * Copy of the last accepted flood mask (within its bounding box
+		 * only) restored when a tracked flood is rejected as a leak
+		 */
+		Mat previousMask;
+
+		// -------------------------------------------------------------------
+		// Multi-region mode
+		// -------------------------------------------------------------------
+		/**
+		 * Indicates multi-region mode is on: all regions are flooded with
+		 * the scanline engine instead of the single seed flood
+		 * [default value is false]
+		 */
+		bool multiRegion;
+
+		/**
+		 * Regions tracked in multi-region mode
+		 */
+		vector<FloodRegion> regions;
+
+		/**
+		 * Label image (CV_32SC1) of multi-region mode: 0 for background
+		 * and i + 1 for pixels of region i
+		 */
+		Mat labels;
+
+		/**
+		 * Number of threads used to flood regions in multi-region mode
+		 * and to segment the whole image.
+		 * 1 means sequential flooding [default value is the number of
+		 * OpenCV threads]
+		 */
+		size_t parallelThreads;
+
+		/**
+		 * Flood workspaces of the threads flooding regions (each with its
+		 * own mask since regions may overlap)
+		 */
+		vector<FloodWorkspace> regionWorkspaces;
+
+		/**
+		 * Number of pixels flooded by several regions during last update.
+		 * Such pixels are given to the region with the lowest index.
+		 */
+		int regionConflicts;
+
+		// -------------------------------------------------------------------
+		// Whole image segmentation
+		// -------------------------------------------------------------------
+		/**
+		 * Segment label image (CV_32SC1) of the whole image segmentation:
+		 * index of the segment of each pixel. Also used as the union-find
+		 * parents image (parent pixel index of each pixel) while
+		 * segmenting.
+		 */
+		Mat segmentLabels;
+
+		/**
+		 * Segments of the whole image segmentation (in label order)
+		 */
+		vector<FloodSegment> segments;
+
+		/**
+		 * Mean color of each segment (channels of segment i start at
+		 * i * channels) used to render the segmented image
+		 */
+		vector<uchar> segmentPalette;
+
+		/**
+		 * Segmented image: each pixel is drawn with the mean color of its
+		 * segment
+		 */
+		Mat segmented;
+
 		// --------------------------------------------------------------------
 		// Utility methods
 		// --------------------------------------------------------------------
@@ -200,9 +630,34 @@ class CvFloodFill: virtual public CvProcessor
 		virtual void cleanup();
 
 		/**
-		 * Compute barycenter of last flooded mask
+		 * Computes elapsed wall clock time since start (in clock ticks so
+		 * it can be used as processTime).
+		 * @param start the starting time obtained with getTickCount()
+		 * @return the elapsed time in clock ticks
+		 * @note clock() measures CPU time of all threads and can not
+		 * report the speedups of parallel floods and segmentation bands
+		 */
+		static clock_t elapsedTicks(const int64 start);
+
+		/**
+		 * Floods the source image several times from the same seed with
+		 * the current engine and settings
+		 * @param seed the flood seed
+		 * @param iterations the number of timed floods (after a first
+		 * untimed flood)
+		 * @return the mean flood update time in ms
+		 * @post the last flood is in floodMask
+		 */
+		double timeFlood(const Point & seed, const int iterations);
+
+		/**
+		 * Compute barycenter of last flooded mask within the flooded area
+		 * bounding box
 		 * @param mask the mask image where mask pixels are set to newMaskVal
-		 * @param center the barycenter point computed here
+		 * @param area the region of the mask containing all flooded pixels
+		 * (typically the flood bounding box). Only this region is scanned.
+		 * @param center the barycenter point computed here (in mask
+		 * coordinates)
 		 * @param threshold the value to use as threshold to find flooded area
 		 * pixels in the mask image
 		 * @note One can also use the OpenCV function moments(...) to compute
@@ -216,8 +671,207 @@ class CvFloodFill: virtual public CvProcessor
 		 */
 		template<typename T>
 		bool computeFloodCenter(const Mat & mask,
+								const Rect & area,
 								Point & center,
 								const T threshold = numeric_limits<T>::max());
+
+		/**
+		 * Scanline flood fill of an 8 bits image with cn channels according
+		 * to current ffillMode and connectivity: flooded pixels are set to
+		 * newMaskVal in the workspace mask and to color in the filled
+		 * image. Flooded area bounding box and first order moments are
+		 * computed in the workspace while filling. Flood is limited to the
+		 * workspace bounds and aborted when it exceeds the workspace
+		 * maxArea.
+		 * @param image the image to flood (only read)
+		 * @param filled the image to draw flooded pixels in (may be image
+		 * or NULL)
+		 * @param seed the flood seed (should be within workspace bounds)
+		 * @param loDiff the lower difference for pixel aggregation
+		 * @param upDiff the upper difference for pixel aggregation
+		 * @param color the flood color in the filled image
+		 * @param workspace the flood workspace
+		 * @param spans if not NULL flooded spans are added to this vector
+		 * @return the number of flooded pixels
+		 * @pre workspace mask is cleared
+		 */
+		template<int cn>
+		int scanlineFloodFill(const Mat & image,
+							  Mat * filled,
+							  const Point & seed,
+							  const int loDiff,
+							  const int upDiff,
+							  const Scalar & color,
+							  FloodWorkspace & workspace,
+							  vector<FloodSpan> * spans = NULL) const;
+
+		/**
+		 * Computes fixed range acceptance of all pixels of a row of image
+		 * (within flood bounds) into rowPass with a branch-free loop the
+		 * compiler can vectorize
+		 * @param image the image to flood
+		 * @param rowPass the acceptance image
+		 * @param y the row to compute
+		 * @param xMin the first pixel of the row to compute
+		 * @param xMax the last pixel of the row to compute
+		 * @param low the lowest accepted value of each channel
+		 * @param range the width of the accepted range of each channel
+		 */
+		template<int cn>
+		static void computeRowPass(const Mat & image,
+								   Mat & rowPass,
+								   const int y,
+								   const int xMin,
+								   const int xMax,
+								   const int * low,
+								   const unsigned int * range);
+
+		/**
+		 * Setup a flood workspace for an image size
+		 * @param workspace the workspace to setup
+		 * @param size the size of the images to flood
+		 * @param withMask creates the workspace mask if true (otherwise
+		 * mask is expected to be set by the caller)
+		 */
+		void setupWorkspace(FloodWorkspace & workspace,
+							const Size & size,
+							const bool withMask);
+
+		/**
+		 * Coarse to fine flood fill of the source image with cn channels:
+		 * 	- the downscaled source image is flooded with the scanline engine
+		 * 	- coarse pixels whose neighbors are all flooded are flooded at
+		 * 	full resolution without checking
+		 * 	- full resolution pixels of the other coarse pixels neighboring
+		 * 	the coarse flood (the border band) are flooded from the trusted
+		 * 	pixels with the same loDiff / upDiff criteria and the flood
+		 * 	keeps growing at full resolution from there
+		 * Result is identical to the full resolution flood as long as all
+		 * trusted pixels belong to the full resolution region (which is the
+		 * case for uniform regions whose inside has no detail thinner than
+		 * the coarse pixels).
+		 * Flooded pixels are set in floodMask and floodWorkspace moments
+		 * and bounding box are computed like the scanline engine does.
+		 * @param filled the image to draw flooded pixels in (or NULL)
+		 * @param seed the flood seed
+		 * @param color the flood color in the filled image
+		 * @return the number of flooded pixels
+		 * @pre floodMask is cleared
+		 */
+		template<int cn>
+		int pyramidFloodFill(Mat * filled,
+							 const Point & seed,
+							 const Scalar & color);
+
+		/**
+		 * Floods the source image at full resolution with the scanline
+		 * engine in checkWorkspace and compares it to the last flood in
+		 * floodMask
+		 * @param seed the seed of the last flood
+		 * @return the intersection over union of both floods
+		 */
+		template<int cn>
+		double checkPyramidFlood(const Point & seed);
+
+		/**
+		 * Floods the tracked region within a ROI around its predicted
+		 * bounding box. The ROI is enlarged as long as the flood reaches
+		 * its borders. Flood exceeding leakFactor times the previous area
+		 * is rejected and the previous flood (mask, area, bounding box and
+		 * center) is restored with no motion, unless maxConsecutiveLeaks
+		 * floods have been rejected in a row, in which case the flood is
+		 * unbounded and accepted. Otherwise sets floodArea,
+		 * floodBoundingBox, centerSeed and the mask.
+		 * @return the seed of the accepted flood
+		 * @pre region has been flooded and source image is a 8 bits image
+		 */
+		Point trackFlood();
+
+		/**
+		 * Composes the single region flood into source image (which is then
+		 * displayed as the merged image): flooded pixels of floodMask are set
+		 * to floodColor within the flood bounding box only
+		 */
+		void composeFlood();
+
+		/**
+		 * Floods all regions in multi-region mode: regions are flooded
+		 * independently (in parallel) then merged in regions order into
+		 * the label image and the mask (and the merged image when displayed).
+		 */
+		void updateRegions();
+
+		/**
+		 * Floods regions assigned to a worker: regions worker,
+		 * worker + nbWorkers, worker + 2 * nbWorkers, ...
+		 * @param worker the worker index (which is also the index of the
+		 * workspace to use)
+		 * @param nbWorkers the number of workers
+		 */
+		void floodRegions(const size_t worker, const size_t nbWorkers);
+
+		/**
+		 * Parallel loop body flooding regions with #floodRegions
+		 */
+		class RegionFlooder;
+
+		/**
+		 * Segments the whole image into uniform regions (only computed
+		 * when SEGMENTED_IM is displayed): this is the result of flooding
+		 * from every pixel not flooded yet, computed with a union-find on
+		 * pixels instead of floods so it can be parallelized:
+		 * 	- each band of rows is labeled independently (in parallel)
+		 * 	- labels of neighbor pixels across bands borders are merged
+		 * 	- segments are numbered in raster order and their area, mean
+		 * 	color and bounding box are computed
+		 * 	- segmented image is rendered with segments mean colors (in
+		 * 	parallel)
+		 * Two neighbor pixels belong to the same segment when one of them
+		 * is within floating range [-loDiff, +upDiff] of the other
+		 * (ffillMode does not apply since there is no seed value to compare
+		 * to).
+		 * @pre source image is a 8UC1 or 8UC3 image
+		 */
+		void segmentImage();
+
+		/**
+		 * Joins pixels of a band of rows to their left and upper neighbors
+		 * within floating range: pixels of a band are only linked to pixels
+		 * of the same band so that bands can be processed concurrently.
+		 * @param band the band index
+		 * @param nbBands the number of bands
+		 */
+		template<int cn>
+		void segmentBand(const int band, const int nbBands);
+
+		/**
+		 * Joins pixels of the first row of a band to their neighbors in the
+		 * last row of the previous band
+		 * @param y the first row of the band
+		 */
+		template<int cn>
+		void joinBands(const int y);
+
+		/**
+		 * Numbers segments in raster order (replaces parents by segment
+		 * indices in segmentLabels) and computes segments statistics
+		 */
+		template<int cn>
+		void labelSegments();
+
+		/**
+		 * Draws a band of rows of the segmented image with segments mean
+		 * colors
+		 * @param band the band index
+		 * @param nbBands the number of bands
+		 */
+		void renderSegments(const int band, const int nbBands);
+
+		/**
+		 * Parallel loop body processing bands of rows with #segmentBand
+		 * or #renderSegments
+		 */
+		class Segmenter;
 	public:
 		/**
 		 * Flood fill class constructor
@@ -232,21 +886,24 @@ class CvFloodFill: virtual public CvProcessor
 
 		/**
 		 * Flood fill update:
-		 * 	- Copy source image to merged image
-		 * 	- if image has already been flooded compute Flood barycenter
-		 * 		- if flood has succeded set seed as the barycenter
-		 * 		- else reset seeded and flooded states
+		 * 	- if segmented image is displayed, segments the whole image
+		 * 	- if image has already been flooded use the last flood barycenter
+		 * 	as the seed
 		 * 	- else
 		 * 		- if image has been seed manually then use this seed
-		 * 	- clears mask with zeros
+		 * 	- clears mask with zeros where the last flood has set it
 		 * 	- if there is a seed
 		 * 		- flood fill the image
 		 * 		- if flood area counts some pixels then sets flooded state
 		 * 		- if flooded
+		 * 			- compute flood barycenter within flood bounding box
+		 * 			- if barycenter can't be computed reset seeded and
+		 * 			flooded states
+		 * 			- if merged image is displayed, compose flood into source
+		 * 				image within flood bounding box
 		 * 			- if show bounding box is on then draw bouding box rectangle
 		 * 				in source image
-		 * 			- if show seed is on then draw seed in source image and
-		 * 				merged image
+		 * 			- if show seed is on then draw seed in source image
 		 *	- according to displayMode set displayImage
 		 *
 		 */
@@ -321,6 +978,18 @@ class CvFloodFill: virtual public CvProcessor
 		 */
 		virtual void setFfillMode(const FloodFillMode ffillMode);
 
+		/**
+		 * Gets the current flood fill engine
+		 * @return the current flood fill engine
+		 */
+		FloodEngine getFloodEngine() const;
+
+		/**
+		 * Sets a new flood fill engine
+		 * @param floodEngine the new flood fill engine
+		 */
+		virtual void setFloodEngine(const FloodEngine floodEngine);
+
 		/**
 		 * Gets the lower difference in pixel values for flooding
 		 * @return the current lower difference for flooding
@@ -433,6 +1102,213 @@ class CvFloodFill: virtual public CvProcessor
 		 * @param showBoundingBox the new show/hide bounding box status
 		 */
 		virtual void setShowBoundingBox(const bool showBoundingBox);
+
+		// --------------------------------------------------------------------
+		// ROI tracking related methods
+		// --------------------------------------------------------------------
+		/**
+		 * Gets the ROI tracking status
+		 * @return true if ROI tracking is on
+		 */
+		bool isRoiTracking() const;
+
+		/**
+		 * Sets the ROI tracking status
+		 * @param roiTracking the new ROI tracking status
+		 * @note ROI tracking is only used with the SCANLINE_FLOOD engine
+		 */
+		virtual void setRoiTracking(const bool roiTracking);
+
+		/**
+		 * Gets the ROI margin relative to the predicted bounding box size
+		 * @return the ROI margin
+		 */
+		float getRoiMargin() const;
+
+		/**
+		 * Sets the ROI margin relative to the predicted bounding box size
+		 * @param roiMargin the new ROI margin (should be positive)
+		 */
+		virtual void setRoiMargin(const float roiMargin);
+
+		/**
+		 * Gets the leak protection factor
+		 * @return the leak protection factor
+		 */
+		float getLeakFactor() const;
+
+		/**
+		 * Sets the leak protection factor
+		 * @param leakFactor the new leak protection factor (should be
+		 * greater than 1, or 0 to disable leak protection)
+		 */
+		virtual void setLeakFactor(const float leakFactor);
+
+		/**
+		 * Gets the ROI used by the last tracked flood
+		 * @return the ROI used by the last tracked flood
+		 */
+		const Rect & getFloodROI() const;
+
+		/**
+		 * Indicates if the last tracked flood has been rejected as a leak
+		 * @return true if last tracked flood was a leak
+		 */
+		bool isFloodLeaked() const;
+
+		// --------------------------------------------------------------------
+		// Pyramid flood related methods
+		// --------------------------------------------------------------------
+		/**
+		 * Gets the number of pyramid levels of the pyramid flood
+		 * @return the number of pyramid levels
+		 */
+		int getPyramidLevels() const;
+
+		/**
+		 * Sets the number of pyramid levels of the pyramid flood
+		 * @param pyramidLevels the new number of pyramid levels in [1..4]
+		 */
+		virtual void setPyramidLevels(const int pyramidLevels);
+
+		/**
+		 * Gets the pyramid flood check status
+		 * @return true if pyramid floods are checked against full
+		 * resolution floods
+		 */
+		bool isPyramidCheck() const;
+
+		/**
+		 * Sets the pyramid flood check status
+		 * @param pyramidCheck the new pyramid flood check status
+		 */
+		virtual void setPyramidCheck(const bool pyramidCheck);
+
+		/**
+		 * Gets the intersection over union of the last checked pyramid
+		 * flood and the full resolution flood
+		 * @return the last pyramid flood intersection over union
+		 */
+		double getPyramidIoU() const;
+
+		// --------------------------------------------------------------------
+		// Multi-region related methods
+		// --------------------------------------------------------------------
+		/**
+		 * Gets the multi-region mode status
+		 * @return true if multi-region mode is on
+		 */
+		bool isMultiRegion() const;
+
+		/**
+		 * Sets the multi-region mode status. Current flood is cleared.
+		 * @param multiRegion the new multi-region mode status
+		 * @note multi-region mode requires a 8UC1 or 8UC3 source image
+		 */
+		virtual void setMultiRegion(const bool multiRegion);
+
+		/**
+		 * Adds a new region to track in multi-region mode with current
+		 * loDiff and upDiff and a random color
+		 * @param seed the initial seed of the new region
+		 */
+		virtual void addRegion(const Point & seed);
+
+		/**
+		 * Removes all regions of multi-region mode
+		 */
+		virtual void clearRegions();
+
+		/**
+		 * Gets the number of regions tracked in multi-region mode
+		 * @return the number of regions
+		 */
+		size_t getNbRegions() const;
+
+		/**
+		 * Gets a region tracked in multi-region mode
+		 * @param i the region index
+		 * @return the ith region
+		 * @pre i < getNbRegions()
+		 */
+		const FloodRegion & getRegion(const size_t i) const;
+
+		/**
+		 * Sets the lower and upper difference of a region
+		 * @param i the region index
+		 * @param loDiff the new lower difference of the region
+		 * @param upDiff the new upper difference of the region
+		 */
+		virtual void setRegionDiffs(const size_t i,
+									const int loDiff,
+									const int upDiff);
+
+		/**
+		 * Gets the label image of multi-region mode
+		 * @return the label image
+		 */
+		const Mat & getLabels() const;
+
+		/**
+		 * Gets the number of pixels flooded by several regions during
+		 * last update
+		 * @return the number of conflicting pixels
+		 */
+		int getRegionConflicts() const;
+
+		/**
+		 * Gets the number of threads used to flood regions
+		 * @return the number of threads used to flood regions
+		 */
+		size_t getParallel() const;
+
+		/**
+		 * Sets the number of threads used to flood regions (and to segment
+		 * the whole image)
+		 * @param threads the number of threads to use (values below 1
+		 * are clamped to 1, which means sequential flooding)
+		 */
+		virtual void setParallel(const int threads);
+
+		// --------------------------------------------------------------------
+		// Whole image segmentation related methods
+		// --------------------------------------------------------------------
+		/**
+		 * Gets the number of segments of the last whole image segmentation
+		 * @return the number of segments
+		 */
+		size_t getNbSegments() const;
+
+		/**
+		 * Gets a segment of the last whole image segmentation
+		 * @param i the segment index
+		 * @return the ith segment
+		 * @pre i < getNbSegments()
+		 */
+		const FloodSegment & getSegment(const size_t i) const;
+
+		/**
+		 * Gets the segment label image of the last whole image segmentation
+		 * @return the segment label image
+		 */
+		const Mat & getSegmentLabels() const;
+
+		/**
+		 * Benchmarks flood engines on an image: mean flood time of the
+		 * cv::floodFill engine, of the scanline engine and of the pyramid
+		 * engine (with 1 to 4 levels) from the same seed in fixed and
+		 * floating range modes, number of mask pixels differing from the
+		 * cv::floodFill flood and intersection over union of pyramid floods
+		 * with full resolution floods
+		 * @param image the image to flood (8UC1 or 8UC3)
+		 * @param seed the flood seed
+		 * @param out the stream to print results on
+		 * @param iterations the number of timed floods of each engine
+		 */
+		static void benchmark(Mat * image,
+							  const Point & seed,
+							  ostream & out,
+							  const int iterations = 100);
 };
 
 #endif /* CVGFLOODFILL_H_ */
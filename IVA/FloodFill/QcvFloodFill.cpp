@@ -47,7 +47,8 @@ QcvFloodFill::~QcvFloodFill()
 
 /*
  * Update computed images and sends displayImageChanged signal if
- * required
+ * required. Tracked flood leaks and pyramid flood IoU (when
+ * pyramid check is on) are reported in status messages.
  */
 void QcvFloodFill::update()
 {
@@ -84,6 +85,21 @@ void QcvFloodFill::update()
 		emit imageChanged(&displayImage);
 	}
 
+	// Reports tracked flood leaks and pyramid flood accuracy
+	if (isFloodLeaked())
+	{
+		message.clear();
+		message.append(tr("Tracked flood rejected as a leak"));
+		emit sendMessage(message, defaultTimeOut);
+	}
+	else if (flooded && pyramidCheck && (floodEngine == PYRAMID_FLOOD))
+	{
+		message.clear();
+		message.append(tr("Pyramid flood IoU: %1")
+					   .arg(getPyramidIoU(), 0, 'f', 3));
+		emit sendMessage(message, defaultTimeOut);
+	}
+
 	/*
 	 * emit updated signal
 	 */
@@ -122,6 +138,9 @@ void QcvFloodFill::setDisplayMode(const ImageDisplay index)
 		case MERGED_IM:
 			message.append(tr("Merged Mask/Input"));
 			break;
+		case SEGMENTED_IM:
+			message.append(tr("Segmented regions"));
+			break;
 		case NBDISPLAY_IM:
 		default:
 			message.append(tr("Unknown"));
@@ -170,6 +189,46 @@ void QcvFloodFill::setFfillMode(const FloodFillMode ffillMode)
 	emit sendMessage(message, defaultTimeOut);
 }
 
+/*
+ * Sets a new flood fill engine with notification
+ * @param floodEngine the new flood fill engine
+ */
+void QcvFloodFill::setFloodEngine(const FloodEngine floodEngine)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvFloodFill::setFloodEngine(floodEngine);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Flood engine set to "));
+	switch (getFloodEngine())
+	{
+		case OPENCV_FLOOD:
+			message.append(tr("OpenCV floodFill"));
+			break;
+		case SCANLINE_FLOOD:
+			message.append(tr("scanline"));
+			break;
+		case PYRAMID_FLOOD:
+			message.append(tr("coarse to fine scanline"));
+			break;
+		default:
+			message.append(tr("Unknown"));
+			break;
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
 /*
  * Sets a new lower difference in pixels values for flooding
  * @param loDiff the new lower difference for flooding
@@ -330,15 +389,204 @@ void QcvFloodFill::setShowBoundingBox(const bool showBoundingBox)
 	emit sendMessage(message, defaultTimeOut);
 }
 
+/*
+ * Sets the ROI tracking status with notification
+ * @param roiTracking the new ROI tracking status
+ */
+void QcvFloodFill::setRoiTracking(const bool roiTracking)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvFloodFill::setRoiTracking(roiTracking);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("ROI tracking is "));
+	if (isRoiTracking())
+	{
+		message.append(tr("on"));
+		if (getFloodEngine() != SCANLINE_FLOOD)
+		{
+			message.append(tr(" (requires scanline engine)"));
+		}
+	}
+	else
+	{
+		message.append(tr("off"));
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Sets the pyramid flood check status with notification
+ * @param pyramidCheck the new pyramid flood check status
+ */
+void QcvFloodFill::setPyramidCheck(const bool pyramidCheck)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvFloodFill::setPyramidCheck(pyramidCheck);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Pyramid flood check is "));
+	if (isPyramidCheck())
+	{
+		message.append(tr("on"));
+		if (getFloodEngine() != PYRAMID_FLOOD)
+		{
+			message.append(tr(" (requires pyramid engine)"));
+		}
+	}
+	else
+	{
+		message.append(tr("off"));
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Sets the multi-region mode status with notification
+ * @param multiRegion the new multi-region mode status
+ */
+void QcvFloodFill::setMultiRegion(const bool multiRegion)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvFloodFill::setMultiRegion(multiRegion);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Multi-region mode is "));
+	if (isMultiRegion())
+	{
+		message.append(tr("on"));
+	}
+	else
+	{
+		message.append(tr("off"));
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Adds a new region to track in multi-region mode
+ * @param seed the initial seed of the new region
+ */
+void QcvFloodFill::addRegion(const Point & seed)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvFloodFill::addRegion(seed);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("%1 regions tracked").arg(getNbRegions()));
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Removes all regions of multi-region mode with notification
+ */
+void QcvFloodFill::clearRegions()
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvFloodFill::clearRegions();
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("All regions cleared"));
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Sets the number of threads used to flood regions with
+ * notification
+ * @param threads the number of threads to use
+ */
+void QcvFloodFill::setParallel(const int threads)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvFloodFill::setParallel(threads);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Regions flooded with %1 thread(s)").arg(getParallel()));
+	emit sendMessage(message, defaultTimeOut);
+}
+
 /*
  * Slot to clear current flood when left or right mouse button is
  * pressed (should be connected to QcvMatWigdet::pressPoint signal)
- * Later relase event will evt trigger new seed for flood
+ * Later relase event will evt trigger new seed for flood.
+ * In multi-region mode only the right button clears all regions.
  * @param p the point the event occured
  * @param button the pressed button
  */
 void QcvFloodFill::clearFloodPoint(const QPoint &, const Qt::MouseButton & button)
 {
+	if (isMultiRegion())
+	{
+		if (button == Qt::RightButton)
+		{
+			clearRegions();
+		}
+		return;
+	}
+
 	// if button is left or right
 	if ((button == Qt::LeftButton) || (button == Qt::RightButton))
 	{
@@ -364,11 +612,18 @@ void QcvFloodFill::clearFloodPoint(const QPoint &, const Qt::MouseButton & butto
  */
 void QcvFloodFill::setSeedPoint(const QPoint & p, const Qt::MouseButton & button)
 {
-	// if button left initiate new seed
+	// if button left initiate new seed (or new region)
 	if (button == Qt::LeftButton)
 	{
 		int px = (p.x() > 0 ? p.x() : 0);
 		int py = (p.y() > 0 ? p.y() : 0);
-		setInitialSeed(Point(px, py));
+		if (isMultiRegion())
+		{
+			addRegion(Point(px, py));
+		}
+		else
+		{
+			setInitialSeed(Point(px, py));
+		}
 	}
 }
@@ -50,7 +50,8 @@ class QcvFloodFill : public QcvProcessor, public CvFloodFill
 	public slots:
 		/**
 		 * Update computed images and sends displayImageChanged signal if
-		 * required
+		 * required. Tracked flood leaks and pyramid flood IoU (when
+		 * pyramid check is on) are reported in status messages.
 		 */
 		void update();
 
@@ -66,6 +67,12 @@ class QcvFloodFill : public QcvProcessor, public CvFloodFill
 		 */
 		void setFfillMode(const FloodFillMode ffillMode);
 
+		/**
+		 * Sets a new flood fill engine with notification
+		 * @param floodEngine the new flood fill engine
+		 */
+		void setFloodEngine(const FloodEngine floodEngine);
+
 		/**
 		 * Sets a new lower difference in pixels values for flooding
 		 * @param loDiff the new lower difference for flooding
@@ -104,10 +111,47 @@ class QcvFloodFill : public QcvProcessor, public CvFloodFill
 		 */
 		void setShowBoundingBox(const bool showBoundingBox);
 
+		/**
+		 * Sets the ROI tracking status with notification
+		 * @param roiTracking the new ROI tracking status
+		 */
+		void setRoiTracking(const bool roiTracking);
+
+		/**
+		 * Sets the pyramid flood check status with notification
+		 * @param pyramidCheck the new pyramid flood check status
+		 */
+		void setPyramidCheck(const bool pyramidCheck);
+
+		/**
+		 * Sets the multi-region mode status with notification
+		 * @param multiRegion the new multi-region mode status
+		 */
+		void setMultiRegion(const bool multiRegion);
+
+		/**
+		 * Adds a new region to track in multi-region mode
+		 * @param seed the initial seed of the new region
+		 */
+		void addRegion(const Point & seed);
+
+		/**
+		 * Removes all regions of multi-region mode with notification
+		 */
+		void clearRegions();
+
+		/**
+		 * Sets the number of threads used to flood regions with
+		 * notification
+		 * @param threads the number of threads to use
+		 */
+		void setParallel(const int threads);
+
 		/**
 		 * Slot to clear current flood when left or right mouse button is
 		 * pressed (should be connected to QcvMatWigdet::pressPoint signal)
-		 * Later relase event will evt trigger new seed for flood
+		 * Later relase event will evt trigger new seed for flood.
+		 * In multi-region mode only the right button clears all regions.
 		 * @param p the point the event occured
 		 * @param button the pressed button
 		 */
@@ -115,7 +159,8 @@ class QcvFloodFill : public QcvProcessor, public CvFloodFill
 
 		/**
 		 * Slot to set intialSeed point (should be connected to
-		 * QcvMatWidget::releasePoint signal)
+		 * QcvMatWidget::releasePoint signal) or to add a new region in
+		 * multi-region mode
 		 * @param p the initial seed point
 		 * @param button the button pressed and released
 		 */
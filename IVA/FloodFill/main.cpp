@@ -4,6 +4,8 @@
 
 using namespace std;
 
+#include <opencv2/imgproc/imgproc.hpp>	// for drawing & cvtColor
+
 #include "QcvVideoCapture.h"
 #include "CaptureFactory.h"
 #include "QcvFloodFill.h"
@@ -25,6 +27,8 @@ using namespace std;
  *		- GL for OpenGL rendering
  *	- size : [--size | -s] <width>x<height> resize capture to fit desired <width>
  *	and <height>
+ *	- benchmark : [--benchmark | -b] benchmarks flood engines on a synthetic
+ *	image then exits
  *
  * @section Manual
  */
@@ -52,6 +56,8 @@ void usage(char * name);
  *		- GL for OpenGL rendering
  *	- size : [--size | -s] <width>x<height> resize capture to fit desired <width>
  *	and <height>
+ *	- benchmark : [--benchmark | -b] benchmarks flood engines on a synthetic
+ *	image then exits
  */
 int main(int argc, char *argv[])
 {
@@ -64,6 +70,7 @@ int main(int argc, char *argv[])
 	QStringList argList = QCoreApplication::arguments();
 
     int threadNumber = 1;
+	bool benchmark = false;
 	// parse arguments for --threads tag
 	for (QListIterator<QString> it(argList); it.hasNext(); )
 	{
@@ -88,6 +95,34 @@ int main(int argc, char *argv[])
 				qWarning("Warning: thread tag found with no following thread number");
 			}
 		}
+		else if (currentArg == "-b" || currentArg == "--benchmark")
+		{
+			benchmark = true;
+		}
+	}
+
+	// ------------------------------------------------------------------------
+	// Benchmark flood engines on a synthetic noisy image (a disk containing
+	// a rectangle on a uniform background) then exit
+	// ------------------------------------------------------------------------
+	if (benchmark)
+	{
+		Mat colorImage(480, 640, CV_8UC3, Scalar(160, 170, 180));
+		circle(colorImage, Point(320, 240), 160, Scalar(60, 120, 200), -1);
+		rectangle(colorImage, Rect(280, 190, 140, 100), Scalar(200, 60, 60),
+				  -1);
+		Mat noise(colorImage.size(), CV_8UC3);
+		randu(noise, Scalar::all(0), Scalar::all(8));
+		colorImage += noise;
+		Point seed(220, 240); // inside the disk, outside the rectangle
+
+		CvFloodFill::benchmark(&colorImage, seed, cout);
+
+		Mat grayImage;
+		cvtColor(colorImage, grayImage, CV_BGR2GRAY);
+		CvFloodFill::benchmark(&grayImage, seed, cout);
+
+		return 0;
 	}
 
 	// ------------------------------------------------------------------------
@@ -204,19 +239,24 @@ void usage(char * name)
 		 << "[-d | --device] <device number> "
 		 << "[-v | --video] <video file> "
 		 << "[-s | --size] <width>x<height> "
-		 << "[-m | --mirror]  " << endl
+		 << "[-m | --mirror] "
+		 << "[-b | --benchmark]  " << endl
 		 << "Keys : " << endl
 		 << "\t i: color input image" << endl
-		 << "\t r: toggle between image sizes" << endl
 		 << "\t m: mask image" << endl
 		 << "\t e: merged input/mask image" << endl
+		 << "\t r: segmented regions image" << endl
 		 << "\t x: clears current flood" << endl
 		 << "\t n: sets new color for flood" << endl
 		 << "\t f: toggle between absolute or relative threshold" << endl
 		 << "\t b: show/hides flooded area bounding box in source image" << endl
 		 << "\t s: show/hides seed point" << endl
+		 << "\t t: toggles ROI tracking (scanline engine)" << endl
+		 << "\t g: toggles multi-region mode" << endl
 		 << "\t ESCAPE | CTRL-Q quits" << endl
 		 << "Mouse : " << endl
-		 << "\t left button : selects new seed point" << endl
-		 << "\t right button : clears current seed" << endl;
+		 << "\t left button : selects new seed point (adds a new region "
+		 << "in multi-region mode)" << endl
+		 << "\t right button : clears current seed (all regions in "
+		 << "multi-region mode)" << endl;
 }
@@ -280,6 +280,9 @@ void MainWindow::setupUIfromProcessor()
 		case CvFloodFill::MERGED_IM:
 			ui->radioButtonMerged->setChecked(true);
 			break;
+		case CvFloodFill::SEGMENTED_IM:
+			ui->radioButtonSegmented->setChecked(true);
+			break;
 		case CvFloodFill::NBDISPLAY_IM:
 		default:
 			// Do nothing
@@ -299,6 +302,15 @@ void MainWindow::setupUIfromProcessor()
 		break;
 	}
 
+	// Sets flood engine combobox and engine options checkboxes
+	ui->comboBoxEngine->setCurrentIndex((int)processor->getFloodEngine());
+	ui->checkBoxRoiTracking->setChecked(processor->isRoiTracking());
+	ui->checkBoxPyramidCheck->setChecked(processor->isPyramidCheck());
+
+	// Sets multi-region checkbox and threads spinbox
+	ui->checkBoxMultiRegion->setChecked(processor->isMultiRegion());
+	ui->spinBoxThreads->setValue((int)processor->getParallel());
+
 	// Sets show Bounding box
 	ui->checkBoxBBox->setChecked(processor->isShowBoundingBox());
 
@@ -344,6 +356,11 @@ void MainWindow::setupProcessorfromUI()
 		processor->setDisplayMode(CvFloodFill::MERGED_IM);
 	}
 
+	if (ui->radioButtonSegmented->isChecked())
+	{
+		processor->setDisplayMode(CvFloodFill::SEGMENTED_IM);
+	}
+
 	if (ui->radioButtonAbsThreshold->isChecked())
 	{
 		processor->setFfillMode(CvFloodFill::FIXED_RANGE);
@@ -354,6 +371,13 @@ void MainWindow::setupProcessorfromUI()
 		processor->setFfillMode(CvFloodFill::FLOATING_RANGE);
 	}
 
+	processor->setFloodEngine(
+		(CvFloodFill::FloodEngine)ui->comboBoxEngine->currentIndex());
+	processor->setRoiTracking(ui->checkBoxRoiTracking->isChecked());
+	processor->setPyramidCheck(ui->checkBoxPyramidCheck->isChecked());
+	processor->setMultiRegion(ui->checkBoxMultiRegion->isChecked());
+	processor->setParallel(ui->spinBoxThreads->value());
+
 	processor->setShowBoundingBox(ui->checkBoxBBox->isChecked());
 	processor->setShowSeed(ui->checkBoxCenter->isChecked());
 
@@ -644,6 +668,14 @@ void MainWindow::on_radioButtonMerged_clicked()
 	processor->setDisplayMode(CvFloodFill::MERGED_IM);
 }
 
+/*
+ * Select segmented image for display
+ */
+void MainWindow::on_radioButtonSegmented_clicked()
+{
+	processor->setDisplayMode(CvFloodFill::SEGMENTED_IM);
+}
+
 /*
  * Select absolute threshold mode for flood fill
  */
@@ -660,6 +692,48 @@ void MainWindow::on_radioButtonRelThreshold_clicked()
 	processor->setFfillMode(CvFloodFill::FLOATING_RANGE);
 }
 
+/*
+ * Selects flood fill engine
+ * @param index the index of the selected engine
+ */
+void MainWindow::on_comboBoxEngine_currentIndexChanged(int index)
+{
+	processor->setFloodEngine((CvFloodFill::FloodEngine)index);
+}
+
+/*
+ * Sets ROI tracking on/off
+ */
+void MainWindow::on_checkBoxRoiTracking_clicked()
+{
+	processor->setRoiTracking(ui->checkBoxRoiTracking->isChecked());
+}
+
+/*
+ * Sets pyramid flood check on/off
+ */
+void MainWindow::on_checkBoxPyramidCheck_clicked()
+{
+	processor->setPyramidCheck(ui->checkBoxPyramidCheck->isChecked());
+}
+
+/*
+ * Sets multi-region mode on/off
+ */
+void MainWindow::on_checkBoxMultiRegion_clicked()
+{
+	processor->setMultiRegion(ui->checkBoxMultiRegion->isChecked());
+}
+
+/*
+ * Changes the number of threads used to flood regions
+ * @param value the new number of threads
+ */
+void MainWindow::on_spinBoxThreads_valueChanged(int value)
+{
+	processor->setParallel(value);
+}
+
 /*
  * Clears current floor
  */
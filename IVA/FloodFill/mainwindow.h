@@ -276,6 +276,11 @@ class MainWindow : public QMainWindow
 		 */
 		void on_radioButtonMerged_clicked();
 
+		/**
+		 * Select segmented image for display
+		 */
+		void on_radioButtonSegmented_clicked();
+
 		/**
 		 * Select absolute threshold mode for flood fill
 		 */
@@ -286,6 +291,33 @@ class MainWindow : public QMainWindow
 		 */
 		void on_radioButtonRelThreshold_clicked();
 
+		/**
+		 * Selects flood fill engine
+		 * @param index the index of the selected engine
+		 */
+		void on_comboBoxEngine_currentIndexChanged(int index);
+
+		/**
+		 * Sets ROI tracking on/off
+		 */
+		void on_checkBoxRoiTracking_clicked();
+
+		/**
+		 * Sets pyramid flood check on/off
+		 */
+		void on_checkBoxPyramidCheck_clicked();
+
+		/**
+		 * Sets multi-region mode on/off
+		 */
+		void on_checkBoxMultiRegion_clicked();
+
+		/**
+		 * Changes the number of threads used to flood regions
+		 * @param value the new number of threads
+		 */
+		void on_spinBoxThreads_valueChanged(int value);
+
 		/**
 		 * Clears current floor
 		 */
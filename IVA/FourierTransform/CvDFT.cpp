@@ -7,10 +7,12 @@
 
 #include <limits>
 #include <cmath>
+#include <iomanip>	// for setw & setprecision
 
 //#include <iostream>
 //using namespace std;
 
+#include <opencv2/core/core.hpp>	// for parallel_for_
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include "CvDFT.h"
@@ -36,9 +38,14 @@ CvDFT::CvDFT(Mat * sourceImage) :
 	minSize(MIN(sourceImage->rows, sourceImage->cols)),
 	maxSize(MAX(sourceImage->rows, sourceImage->cols)),
 	borderSize((maxSize-minSize)/2),
+	frameMode(SQUARE_FRAME),
 	optimalDFTSize(getOptimalDFTSize(minSize)),
 	filtering(false),
 	filterType(BOX_FILTER),
+	singlePrecision(false),
+	parallelChannels(getNumThreads() > 1),
+	fftBackend(CvFFTBackend::isAvailable(CvFFTBackend::FFTW_BACKEND) ?
+			   CvFFTBackend::FFTW_BACKEND : CvFFTBackend::OPENCV_BACKEND),
 	dftSize(optimalDFTSize, optimalDFTSize),
 	inFrameSquare(dftSize, type),
 	logScaleFactor(10.0),
@@ -78,74 +85,75 @@ void CvDFT::setup(Mat *sourceImage, bool fullSetup)
 		minSize = MIN(sourceImage->rows, sourceImage->cols);
 		maxSize = MAX(sourceImage->rows, sourceImage->cols);
 		borderSize = (maxSize-minSize)/2;
-		optimalDFTSize = getOptimalDFTSize(minSize);
-		dftSize.height = optimalDFTSize;
-		dftSize.width = optimalDFTSize;
+		if (frameMode == SQUARE_FRAME)
+		{
+			optimalDFTSize = getOptimalDFTSize(minSize);
+			dftSize.height = optimalDFTSize;
+			dftSize.width = optimalDFTSize;
+		}
+		else // Full frame is padded to optimal sizes
+		{
+			dftSize.height = getOptimalDFTSize(sourceImage->rows);
+			dftSize.width = getOptimalDFTSize(sourceImage->cols);
+			optimalDFTSize = MIN(dftSize.width, dftSize.height);
+		}
 		inFrameSquare = Mat(dftSize, type);
 //		logScaleFactor = 10.0;
 		spectrumMagnitudeImage = Mat(dftSize, type);
 		spectrumMaskImage = Mat(dftSize, type);
-		inverseImage = Mat(dftSize, type);
 		filterMaxSize = (int)((double)optimalDFTSize / sqrt(2.0));
 		filterMinSize = 0;
 	}
 
 	// Partial setup starting point
+	if (frameMode == SQUARE_FRAME)
+	{
+		frameRect = Rect(Point(0, 0), dftSize);
+	}
+	else // centered frame within padding
+	{
+		frameRect = Rect((dftSize.width - sourceImage->cols) / 2,
+						 (dftSize.height - sourceImage->rows) / 2,
+						 sourceImage->cols,
+						 sourceImage->rows);
+	}
+	inverseImage.create(frameRect.size(), type);
+
 	for (int i=0; i < nbChannels; i++)
 	{
 		channels.push_back(Mat(dftSize, CV_8UC1));
-		channelsDouble.push_back(Mat(dftSize, CV_64FC1));
-		channelsDoubleComplexComponents.push_back(vector<Mat>());
-		channelsComplexImages.push_back(Mat(dftSize, CV_64FC2));
-		channelsComplexSpectrums.push_back(Mat(dftSize, CV_64FC2));
-		channelsComplexSpectrumComponents.push_back(vector<Mat>());
-		channelsSpectrumMagnitude.push_back(Mat(dftSize, CV_64FC1));
-		channelsSpectrumLogMagnitude.push_back(Mat(dftSize, CV_64FC1));
+		channelsShifted.push_back(Mat());
+		channelsPackedSpectrums.push_back(Mat());
+		channelsSpectrumMagnitude.push_back(Mat());
+		channelsSpectrumLogMagnitude.push_back(Mat());
 		channelsSpectrumLogMagnitudeDisplay.push_back(Mat(dftSize, CV_8UC1));
-		channelsLowPassMask.push_back(Mat(dftSize, CV_64FC1));
-		channelsHighPassMask.push_back(Mat(dftSize, CV_64FC1));
-		channelsHighPassMaskReverse.push_back(Mat(dftSize, CV_64FC1));
-		channelsSpectrumMask.push_back(Mat(dftSize, CV_64FC1));
+		channelsLowPassMask.push_back(Mat());
+		channelsHighPassMask.push_back(Mat());
+		channelsHighPassMaskReverse.push_back(Mat());
+		channelsSpectrumMask.push_back(Mat());
 		channelsSpectrumMaskDisplay.push_back(Mat(dftSize, CV_8UC1));
-		channelsComplexSpectrumsMasked.push_back(Mat(dftSize, CV_64FC2));
-		channelsComplexInverseImages.push_back(Mat(dftSize, CV_64FC2));
-		channelsComplexInverseComponents.push_back(vector<Mat>());
-		channelsRealInverse.push_back(Mat(dftSize, CV_64FC1));
+		channelsPackedSpectrumMask.push_back(Mat());
+		channelsPackedSpectrumsMasked.push_back(Mat());
+		channelsInverse.push_back(Mat());
 		channelsRealInverseDisplay.push_back(Mat(dftSize, CV_8UC1));
 
-		// complex channels
-		for (int j=0; j < 2; j++)
-		{
-			channelsDoubleComplexComponents[i].push_back(Mat(dftSize, CV_64FC1));
-			channelsComplexSpectrumComponents[i].push_back(Mat(dftSize, CV_64FC1));
-			channelsComplexInverseComponents[i].push_back(Mat(dftSize, CV_64FC1));
-		}
-
 		lowPassFilterSize.push_back(filterMaxSize);
 		highPassFilterSize.push_back(filterMinSize);
-
-		// fill complex channels of channelsDoubleComplexComponents with 0
-		channelsDoubleComplexComponents[i][1] = Scalar(0.0);
+		channelsMaskValid.push_back(false);
 	}
+
+	// floating point attributes according to precision
+	setupPrecision();
 }
 
 void CvDFT::cleanup()
 {
 	for (int i=0; i < nbChannels; i++)
 	{
-		// complex channels
-		for (int j=0; j < 2; j++)
-		{
-			channelsComplexInverseComponents[i][j].release();
-			channelsComplexSpectrumComponents[i][j].release();
-			channelsDoubleComplexComponents[i][j].release();
-		}
-
 		channelsRealInverseDisplay[i].release();
-		channelsRealInverse[i].release();
-		channelsComplexInverseComponents[i].clear();
-		channelsComplexInverseImages[i].release();
-		channelsComplexSpectrumsMasked[i].release();
+		channelsInverse[i].release();
+		channelsPackedSpectrumsMasked[i].release();
+		channelsPackedSpectrumMask[i].release();
 		channelsSpectrumMaskDisplay[i].release();
 		channelsSpectrumMask[i].release();
 		channelsHighPassMask[i].release();
@@ -154,21 +162,20 @@ void CvDFT::cleanup()
 		channelsSpectrumLogMagnitudeDisplay[i].release();
 		channelsSpectrumLogMagnitude[i].release();
 		channelsSpectrumMagnitude[i].release();
-		channelsComplexSpectrumComponents[i].clear();
-		channelsComplexSpectrums[i].release();
-		channelsComplexImages[i].release();
-		channelsDoubleComplexComponents[i].clear();
-		channelsDouble[i].release();
+		channelsPackedSpectrums[i].release();
+		channelsShifted[i].release();
 		channels[i].release();
 	}
 
+	cleanupFFTBackends();
+
+	channelsMaskValid.clear();
 	highPassFilterSize.clear();
 	lowPassFilterSize.clear();
 	channelsRealInverseDisplay.clear();
-	channelsRealInverse.clear();
-	channelsComplexInverseComponents.clear();
-	channelsComplexInverseImages.clear();
-	channelsComplexSpectrumsMasked.clear();
+	channelsInverse.clear();
+	channelsPackedSpectrumsMasked.clear();
+	channelsPackedSpectrumMask.clear();
 	channelsSpectrumMaskDisplay.clear();
 	channelsSpectrumMask.clear();
 	channelsHighPassMask.clear();
@@ -177,13 +184,11 @@ void CvDFT::cleanup()
 	channelsSpectrumLogMagnitudeDisplay.clear();
 	channelsSpectrumLogMagnitude.clear();
 	channelsSpectrumMagnitude.clear();
-	channelsComplexSpectrumComponents.clear();
-	channelsComplexSpectrums.clear();
-	channelsComplexImages.clear();
-	channelsDoubleComplexComponents.clear();
-	channelsDouble.clear();
+	channelsPackedSpectrums.clear();
+	channelsShifted.clear();
 	channels.clear();
 
+	shiftSigns.release();
 	inverseImage.release();
 	spectrumMaskImage.release();
 	spectrumMagnitudeImage.release();
@@ -193,6 +198,120 @@ void CvDFT::cleanup()
 	CvProcessor::cleanup();
 }
 
+/*
+ * (Re)allocates floating point attributes according to current precision:
+ * CV_32F when singlePrecision is on and CV_64F otherwise, and invalidates
+ * spectrum masks
+ */
+void CvDFT::setupPrecision()
+{
+	int realType = (singlePrecision ? CV_32FC1 : CV_64FC1);
+
+	// frequency shift signs
+	Mat signs(dftSize, CV_64FC1);
+	for (int i = 0; i < signs.rows; i++)
+	{
+		double * row = signs.ptr<double>(i);
+		for (int j = 0; j < signs.cols; j++)
+		{
+			row[j] = ((i + j) % 2 == 0 ? 1.0 : -1.0);
+		}
+	}
+	signs.convertTo(shiftSigns, realType);
+
+	for (int i=0; i < nbChannels; i++)
+	{
+		channelsShifted[i].create(dftSize, realType);
+		channelsPackedSpectrums[i].create(dftSize, realType);
+		channelsSpectrumMagnitude[i].create(dftSize, realType);
+		channelsSpectrumLogMagnitude[i].create(dftSize, realType);
+		channelsLowPassMask[i].create(dftSize, realType);
+		channelsHighPassMask[i].create(dftSize, realType);
+		channelsHighPassMaskReverse[i].create(dftSize, realType);
+		channelsSpectrumMask[i] = Mat(dftSize, realType);
+		channelsPackedSpectrumMask[i] = Mat(dftSize, realType);
+		channelsPackedSpectrumsMasked[i].create(dftSize, realType);
+		channelsInverse[i].create(dftSize, realType);
+	}
+
+	setupFFTBackends();
+
+	invalidateSpectrumMasks(nbChannels);
+}
+
+/*
+ * Creates missing channels FFT backends and plans them for current
+ * DFT size and precision (planning is skipped when size and
+ * precision have not changed)
+ */
+void CvDFT::setupFFTBackends()
+{
+	int realType = (singlePrecision ? CV_32FC1 : CV_64FC1);
+
+	for (int i = (int)channelsFFT.size(); i < nbChannels; i++)
+	{
+		channelsFFT.push_back(CvFFTBackend::create(fftBackend));
+	}
+
+	for (int i=0; i < nbChannels; i++)
+	{
+		channelsFFT[i]->plan(dftSize, realType);
+	}
+}
+
+/*
+ * Deletes channels FFT backends
+ */
+void CvDFT::cleanupFFTBackends()
+{
+	for (size_t i=0; i < channelsFFT.size(); i++)
+	{
+		delete channelsFFT[i];
+	}
+
+	channelsFFT.clear();
+}
+
+/*
+ * Parallel loop body processing color channels with #updateChannel
+ */
+class CvDFT::ChannelProcessor : public ParallelLoopBody
+{
+	private:
+		/**
+		 * The DFT processor to process channels of
+		 */
+		CvDFT * processor;
+
+	public:
+		/**
+		 * Channel processor constructor
+		 * @param processor the DFT processor to process channels of
+		 */
+		ChannelProcessor(CvDFT * processor) :
+			processor(processor)
+		{}
+
+		/**
+		 * Processes channels in range in processor precision
+		 * @param range the range of channels
+		 */
+		void operator()(const Range & range) const
+		{
+			for (int i = range.start; i < range.end; i++)
+			{
+				if (processor->singlePrecision)
+				{
+					processor->updateChannel<float>(i);
+				}
+				else
+				{
+					processor->updateChannel<double>(i);
+				}
+			}
+		}
+};
+
 /*
  * Update
  */
@@ -200,13 +319,29 @@ void CvDFT::update()
 {
 //	clog << "CvDFT::update()" << endl;
 
-	Scalar one(1.0);
-	Scalar zero(0.0);
+	// wall clock time since channels may be processed concurrently
+	int64 start = getTickCount();
+
+	/*
+	 * Pad full source image to DFT optimal sizes in full frame modes
+	 */
+	if (frameMode != SQUARE_FRAME)
+	{
+		copyMakeBorder(*sourceImage,
+					   inFrameSquare,
+					   frameRect.y,
+					   dftSize.height - frameRect.y - frameRect.height,
+					   frameRect.x,
+					   dftSize.width - frameRect.x - frameRect.width,
+					   (frameMode == FULL_FRAME_MIRROR ?
+						BORDER_REFLECT_101 : BORDER_CONSTANT),
+					   Scalar::all(0));
+	}
 	/*
 	 * Crop source image to center square and resize it to nearest
 	 * DFT optimal size
 	 */
-	if (sourceImage->cols > sourceImage->rows)
+	else if (sourceImage->cols > sourceImage->rows)
 	{
 		resize(sourceImage->colRange(borderSize, borderSize + minSize),
 			   inFrameSquare,
@@ -230,230 +365,35 @@ void CvDFT::update()
 	 */
 	split(inFrameSquare, channels);
 
-	// Process each component
-	for (int i=0; i < nbChannels; i++)
-	{
-		/*
-		 * Fourier transform processing
-		 * 	- Convert uchar center square image to CV_64F real component
-		 * 	- perform frequency shift on real image to obtain low frequencies
-		 * 		in the middle of the DFT image rather than in the corners
-		 * 	- merge real & imag component to complexImage before DFT
-		 * 		imag component could be filled with 0
-		 * 	- compute DFT
-		 * 	- split DFT channels
-		 * 	- compute DFT magnitude from DFT channels
-		 * 	- logScale magnitude with factor (5 to 20)
-		 * 	- convertScaleAbs logMagnitude to CV_8UC1 to display image
-		 *
-		 */
-
-		// convert component to float
-		channels[i].convertTo(channelsDouble[i], CV_64FC1);
-
-		// Frequency shift channelsDouble to real complex component
-		// Frequency shift allow to prepare spatial image components to
-		// produce frequency image later with low frequencies in the center
-		// of frequency image
-		frequencyShift<double>(channelsDouble[i],
-							   channelsDoubleComplexComponents[i][0]);
-		// channelsDoubleComplexComponents[i][1] is already filled with 0
-
-		// Merge Real and Imaginary into a complex component image
-		merge(channelsDoubleComplexComponents[i],
-			  channelsComplexImages[i]);
-
-		// Perform Fourier transform on Complex component image
-		dft(channelsComplexImages[i],
-			channelsComplexSpectrums[i],
-			DFT_COMPLEX_OUTPUT);
-
-		// Split component Complex spectrum to real/imag channels
-		split(channelsComplexSpectrums[i],
-			  channelsComplexSpectrumComponents[i]);
-
-		// Compute component spectrum magnitude
-		magnitude(channelsComplexSpectrumComponents[i][0],
-				  channelsComplexSpectrumComponents[i][1],
-				  channelsSpectrumMagnitude[i]);
-
-		// Log scale magnitude
-		logScaleImg<double>(channelsSpectrumMagnitude[i],
-							channelsSpectrumLogMagnitude[i],
-							logScaleFactor);
-
-		if (filtering)
-		{
-			// Clear lowpass mask with black
-			channelsLowPassMask[i] = zero;
-			// Clear highpass mask with white
-			channelsHighPassMask[i] = one;
-
-			// Compute lowpass and highpass masks
-			// Mask center
-			double gsize = (double) (optimalDFTSize-1) / 2.0;
-			// filter amplitude
-			double amplitude = 1.0;
-			switch (filterType)
-			{
-				case BOX_FILTER:
-					// Draw white filled circle on mask
-					if (lowPassFilterSize[i] < filterMaxSize+1)
-					{
-						// Draws a white circle in channelsLowPassMask[i]
-						// - point : (optimalDFTSize/2, optimalDFTSize/2)
-						// - color : one (see above)
-						// - filled circle
-						// - with size from lowPassFilterSize[]
-						// - use CV_AA as lineType
-						// - no shift
-						// TODO Compléter ...
-						// circle(...);
-                        circle(channelsLowPassMask[i],Point(optimalDFTSize/2, optimalDFTSize/2),lowPassFilterSize[i],one,-1,CV_AA);
-					}
-
-					// Draw black circle inside white filled circle
-					if (highPassFilterSize[i] > 0)
-					{
-						// Draws a black circle in channelsHighPassMask[i]
-						// - point : (optimalDFTSize/2, optimalDFTSize/2)
-						// - color : zero (see above)
-						// - filled circle
-						// - with size from highPassFilterSize[]
-						// - use CV_AA as lineType
-						// - no shift
-						// TODO Compléter ...
-						// circle(...);
-                        circle(channelsLowPassMask[i],Point(optimalDFTSize/2, optimalDFTSize/2),highPassFilterSize[i],zero,-1,CV_AA);
-					}
-					break;
-				case GAUSS_FILTER:
-					// TODO Compléter la méthode gaussian2D<T>(...) en fin de fichier
-
-					// positive gaussian for low pass freq filter
-					if (lowPassFilterSize[i] < filterMaxSize+1)
-					{
-						gaussian2D<double> (channelsLowPassMask[i],
-											gsize,
-											gsize,
-											(double) lowPassFilterSize[i],
-											amplitude);
-					}
-
-					// negative gaussian for high pass freq filter
-					if (highPassFilterSize[i] > filterMinSize)
-					{
-						gaussian2D<double> (channelsHighPassMaskReverse[i],
-											gsize,
-											gsize,
-											(double) highPassFilterSize[i],
-											amplitude);
-
-						reverseValues<double>(channelsHighPassMaskReverse[i],
-											  channelsHighPassMask[i],
-											  1.0);
-					}
-					break;
-				case SINC_FILTER:
-
-					// TODO Compléter la méthode sinc2D<T>(...) en fin de fichier
-
-					// positive sinc
-					if (lowPassFilterSize[i] < filterMaxSize+1)
-					{
-						sinc2D<double> (channelsLowPassMask[i],
-										gsize,
-										gsize,
-										(double) lowPassFilterSize[i],
-										amplitude);
-					}
-
-					// negative sinc
-					if (highPassFilterSize[i] > filterMinSize)
-					{
-						sinc2D<double> (channelsHighPassMaskReverse[i],
-										gsize,
-										gsize,
-										(double) highPassFilterSize[i],
-										amplitude);
-
-						reverseValues<double>(channelsHighPassMaskReverse[i],
-											  channelsHighPassMask[i],
-											  1.0);
-					}
-					break;
-				default:
-					break;
-			} // end switch (filterType)
-
-			// multiply lowpass and highpass
-			multiply(channelsLowPassMask[i],
-					 channelsHighPassMask[i],
-					 channelsSpectrumMask[i]);
-
-			// multiply spectrum LogMagnitude by Spectrum mask when filtering
-			multiply(channelsSpectrumLogMagnitude[i],
-					 channelsSpectrumMask[i],
-					 channelsSpectrumLogMagnitude[i]);
-
-		} // end if (filtering)
-		else // No filtering: spectrum mask is completely white
-		{
-			channelsSpectrumMask[i] = one;
-		}
-
-		// Converts Spectrum mask for display
-		convertScaleAbs(channelsSpectrumMask[i],
-						channelsSpectrumMaskDisplay[i]);
-
-		// Convert Log scale channels Spectrum to display channels
-		convertScaleAbs(channelsSpectrumLogMagnitude[i],
-						channelsSpectrumLogMagnitudeDisplay[i]);
-
-		/*
-		 * Inverse Fourier transform processing
-		 * Principle : Multiply spectrum by a mask and then compute inverse
-		 * transform which is equivalent convolve input image with the
-		 * inverse transform of the mask
-		 * - Creates a uchar mask same size as the DFT
-		 * 	- Draw white filled circle on the mask to represent frequencies to filter
-		 * - Creates a complex floating point mask with the original mask
-		 * - Multiply complex spectrum with complex mask to procude the filtered spectrum
-		 * - Inverse filtered spectrum
-		 * 	- split inverse Fourier complex image to channels
-		 * 	- convert real channel to CV_8UC1 to display filtered image
-		 */
+	/*
+	 * Rebuilds spectrum masks (and their display) invalidated since last
+	 * update
+	 */
+	updateSpectrumMasks();
 
-		// multiply spectrum real and imaginary channels with mask
-		for (int j = 0; j < 2; j++)
+	// Process each component in selected precision
+	if (parallelChannels && (nbChannels > 1))
+	{
+		parallel_for_(Range(0, nbChannels),
+					  ChannelProcessor(this),
+					  (double) nbChannels);
+	}
+	else
+	{
+		for (int i=0; i < nbChannels; i++)
 		{
-			multiply(channelsComplexSpectrumComponents[i][j],
-					 channelsSpectrumMask[i],
-					 channelsComplexSpectrumComponents[i][j]);
+			if (singlePrecision)
+			{
+				updateChannel<float>(i);
+			}
+			else
+			{
+				updateChannel<double>(i);
+			}
 		}
+	}
 
-		// remerge filtered component Spectrum Components to complex image
-		merge(channelsComplexSpectrumComponents[i],
-			  channelsComplexSpectrumsMasked[i]);
-
-		// perform inverse Fourier Transform
-		// with specific flags : DFT_REAL_OUTPUT + DFT_SCALE
-		idft(channelsComplexSpectrumsMasked[i],
-			 channelsComplexInverseImages[i],
-			 DFT_REAL_OUTPUT + DFT_SCALE);
-
-		// split inverse FFT to real/imag channels
-		split(channelsComplexInverseImages[i],
-			  channelsComplexInverseComponents[i]);
-
-		// Reperform frequency shift on resulting real component
-		frequencyShift<double>(channelsComplexInverseComponents[i][0],
-							   channelsRealInverse[i]);
-
-		// Convert real channel to display component
-		convertScaleAbs(channelsRealInverse[i],
-						channelsRealInverseDisplay[i]);
-	} // end for (int i=0; i < nbChannels; i++)
+	// Channels processing is complete here
 
 	// Merge channels spectrum Log magnitude to color spectrum image
 	merge(channelsSpectrumLogMagnitudeDisplay,
@@ -463,9 +403,200 @@ void CvDFT::update()
 	merge(channelsSpectrumMaskDisplay,
 		  spectrumMaskImage);
 
-	// Merge channels inverse real parts into inverse image
-	merge(channelsRealInverseDisplay, inverseImage);
+	// Merge channels inverse real parts (without padding) into inverse image
+	vector<Mat> inverseFrames;
+	for (int i=0; i < nbChannels; i++)
+	{
+		inverseFrames.push_back(channelsRealInverseDisplay[i](frameRect));
+	}
+	merge(inverseFrames, inverseImage);
+
+	processTime = elapsedTicks(start);
+	meanProcessTime += processTime;
+}
+
+/*
+ * Computes elapsed wall clock time since start (in clock ticks so
+ * it can be compared with other processors times).
+ * @param start the starting time obtained with getTickCount()
+ * @return the elapsed time in clock ticks
+ */
+clock_t CvDFT::elapsedTicks(const int64 start)
+{
+	return (clock_t) (((double) (getTickCount() - start) * CLOCKS_PER_SEC) /
+					  getTickFrequency());
+}
+
+/*
+ * Process one color channel of the square input frame: forward DFT,
+ * spectrum log magnitude, spectrum masking, inverse DFT and conversions
+ * for display.
+ * @param channel channel index
+ * @tparam T floating point type of the spectral pipeline (float or
+ * double) which should match the depth of floating point attributes
+ */
+template <typename T>
+void CvDFT::updateChannel(const int channel)
+{
+	/*
+	 * Fourier transform processing
+	 * 	- Convert uchar center square image to T real component with
+	 * 		frequency shift to obtain low frequencies in the middle of the
+	 * 		DFT image rather than in the corners
+	 * 	- compute real DFT into packed (CCS) spectrum: since input is real
+	 * 		its spectrum is hermitian and only half of it is computed
+	 * 	- compute DFT magnitude from packed spectrum
+	 * 	- logScale magnitude with factor (5 to 20)
+	 * 	- convertScaleAbs logMagnitude to CV_8UC1 to display image
+	 *
+	 */
+
+	// convert component to floating point (T) with frequency shift
+	// Frequency shift allow to prepare spatial image components to
+	// produce frequency image later with low frequencies in the center
+	// of frequency image
+	frequencyShift(channels[channel], channelsShifted[channel]);
+
+	// Perform Fourier transform on real component image to packed spectrum
+	channelsFFT[channel]->forward(channelsShifted[channel],
+								  channelsPackedSpectrums[channel]);
+
+	// Compute component spectrum magnitude
+	packedMagnitude<T>(channelsPackedSpectrums[channel],
+					   channelsSpectrumMagnitude[channel]);
+
+	// Log scale magnitude
+	logScaleImg<T>(channelsSpectrumMagnitude[channel],
+				   channelsSpectrumLogMagnitude[channel],
+				   (T) logScaleFactor);
+
+	/*
+	 * Inverse Fourier transform processing
+	 * Principle : Multiply spectrum by a mask and then compute inverse
+	 * transform which is equivalent convolve input image with the
+	 * inverse transform of the mask
+	 * - Multiply packed spectrum with packed mask to produce the filtered
+	 * 	spectrum (each real and imaginary part is multiplied by the mask
+	 * 	value of its frequency)
+	 * - Inverse filtered packed spectrum to real image
+	 * - convert real image to CV_8UC1 to display filtered image: since
+	 * 	display is the absolute value of the real image, the frequency
+	 * 	shift (sign changes) does not need to be performed again
+	 */
+	Mat * packedSpectrum = &channelsPackedSpectrums[channel];
+
+	if (filtering)
+	{
+		// multiply spectrum LogMagnitude by Spectrum mask when filtering
+		multiply(channelsSpectrumLogMagnitude[channel],
+				 channelsSpectrumMask[channel],
+				 channelsSpectrumLogMagnitude[channel]);
+
+		// multiply packed spectrum with packed mask
+		multiply(channelsPackedSpectrums[channel],
+				 channelsPackedSpectrumMask[channel],
+				 channelsPackedSpectrumsMasked[channel]);
+
+		packedSpectrum = &channelsPackedSpectrumsMasked[channel];
+	}
+	// else spectrum mask is completely white: spectrum is left unchanged
+
+	// Convert Log scale channels Spectrum to display channels
+	convertScaleAbs(channelsSpectrumLogMagnitude[channel],
+					channelsSpectrumLogMagnitudeDisplay[channel]);
+
+	// perform scaled inverse Fourier Transform of packed spectrum
+	// to real image (as idft with DFT_REAL_OUTPUT + DFT_SCALE)
+	channelsFFT[channel]->inverse(*packedSpectrum,
+								  channelsInverse[channel]);
+
+	// Convert real channel to display component
+	convertScaleAbs(channelsInverse[channel],
+					channelsRealInverseDisplay[channel]);
+}
+
+/*
+ * Benchmarks single precision pipeline against double precision
+ * pipeline on an image with gaussian low pass filtering: mean
+ * update time of each precision and max absolute errors of single
+ * precision spectrum magnitude (relative to the max magnitude),
+ * of single precision inverse images and of their displayed 8 bits
+ * conversion.
+ * @param image the image to transform
+ * @param out the stream to print results on
+ * @param iterations the number of timed updates of each precision
+ */
+void CvDFT::benchmarkPrecision(Mat * image,
+							   ostream & out,
+							   const int iterations)
+{
+	double tickPeriod = 1000.0 / getTickFrequency(); // in ms
+	CvDFT single(image);
+	CvDFT reference(image);
+	CvDFT * dfts[2] = {&single, &reference};
+	double times[2];
+
+	single.setSinglePrecision(true);
+	reference.setSinglePrecision(false);
 
+	for (int p = 0; p < 2; p++)
+	{
+		dfts[p]->setFiltering(true);
+		dfts[p]->setFilterType(GAUSS_FILTER);
+		for (int c = 0; c < dfts[p]->nbChannels; c++)
+		{
+			dfts[p]->setLowPassFilterSize(c, dfts[p]->filterMaxSize / 4);
+		}
+
+		// warm up (builds spectrum masks)
+		dfts[p]->update();
+
+		int64 start = getTickCount();
+		for (int i = 0; i < iterations; i++)
+		{
+			dfts[p]->update();
+		}
+		times[p] = (getTickCount() - start) * tickPeriod / (double) iterations;
+	}
+
+	double magnitudeError = 0.0;
+	double inverseError = 0.0;
+	Mat converted;
+	for (int c = 0; c < single.nbChannels; c++)
+	{
+		double maxMagnitude;
+		minMaxLoc(reference.channelsSpectrumMagnitude[c], NULL,
+				  &maxMagnitude);
+		single.channelsSpectrumMagnitude[c].convertTo(converted, CV_64F);
+		magnitudeError = MAX(magnitudeError,
+							 norm(converted,
+								  reference.channelsSpectrumMagnitude[c],
+								  NORM_INF) / maxMagnitude);
+
+		single.channelsInverse[c].convertTo(converted, CV_64F);
+		inverseError = MAX(inverseError,
+						   norm(converted,
+								reference.channelsInverse[c],
+								NORM_INF));
+	}
+
+	Mat displayDiff;
+	absdiff(single.inverseImage, reference.inverseImage, displayDiff);
+	double displayError = norm(displayDiff, NORM_INF);
+	int displayDiffs = countNonZero(displayDiff.reshape(1));
+
+	out << "DFT precision benchmark on " << image->cols << "x" << image->rows
+		<< " image (" << single.dftSize.width << "x"
+		<< single.dftSize.height << " DFT, gaussian low pass)" << endl;
+	out << setw(40) << "mean update time float / double (ms): " << fixed
+		<< setprecision(3) << times[0] << " / " << times[1] << endl;
+	out << setw(40) << "max relative magnitude error: "
+		<< scientific << setprecision(2) << magnitudeError << endl;
+	out << setw(40) << "max inverse image error: "
+		<< scientific << setprecision(2) << inverseError << endl;
+	out << setw(40) << "max displayed inverse error: " << fixed
+		<< setprecision(0) << displayError << " (" << displayDiffs
+		<< " values)" << endl;
 }
 
 /*
@@ -485,7 +616,11 @@ void CvDFT::setFilterType(const FilterType filterType)
 {
 	if (filterType < NB_FILTERS)
 	{
-		this->filterType = filterType;
+		if (filterType != this->filterType)
+		{
+			this->filterType = filterType;
+			invalidateSpectrumMasks(nbChannels);
+		}
 	}
 	else
 	{
@@ -509,7 +644,96 @@ bool CvDFT::isFiltering() const
  */
 void CvDFT::setFiltering(bool filtering)
 {
-	this->filtering = filtering;
+	if (filtering != this->filtering)
+	{
+		this->filtering = filtering;
+		invalidateSpectrumMasks(nbChannels);
+	}
+}
+
+/*
+ * Spectral pipeline precision
+ * @return true if spectral pipeline is computed with single precision
+ * (float) values, false if it is computed with double precision values
+ */
+bool CvDFT::isSinglePrecision() const
+{
+	return singlePrecision;
+}
+
+/*
+ * Setting spectral pipeline precision.
+ * Floating point attributes are reallocated when precision changes.
+ * @param singlePrecision the new precision status: true for single
+ * precision (float) and false for double precision
+ */
+void CvDFT::setSinglePrecision(const bool singlePrecision)
+{
+	if (singlePrecision != this->singlePrecision)
+	{
+		this->singlePrecision = singlePrecision;
+		setupPrecision();
+		resetMeanProcessTime();
+	}
+}
+
+/*
+ * Channels parallel processing status
+ * @return true if color channels are processed concurrently
+ */
+bool CvDFT::isParallelChannels() const
+{
+	return parallelChannels;
+}
+
+/*
+ * Setting channels parallel processing status
+ * @param parallelChannels the new channels parallel processing
+ * status
+ */
+void CvDFT::setParallelChannels(const bool parallelChannels)
+{
+	if (parallelChannels != this->parallelChannels)
+	{
+		this->parallelChannels = parallelChannels;
+
+		// Previous timings are irrelevant with the new processing
+		resetMeanProcessTime();
+	}
+}
+
+/*
+ * FFT backend read access
+ * @return the current FFT backend
+ */
+CvFFTBackend::BackendType CvDFT::getFFTBackend() const
+{
+	return fftBackend;
+}
+
+/*
+ * Setting FFT backend. Backends are created and planned again for
+ * current DFT size and precision.
+ * @param fftBackend the new FFT backend
+ * @note unavailable backends are ignored
+ */
+void CvDFT::setFFTBackend(const CvFFTBackend::BackendType fftBackend)
+{
+	if (!CvFFTBackend::isAvailable(fftBackend))
+	{
+		cerr << "FFT backend " << fftBackend << " is not available" << endl;
+		return;
+	}
+
+	if (fftBackend != this->fftBackend)
+	{
+		this->fftBackend = fftBackend;
+		cleanupFFTBackends();
+		setupFFTBackends();
+
+		// Previous timings are irrelevant with the new backend
+		resetMeanProcessTime();
+	}
 }
 
 /*
@@ -521,6 +745,46 @@ int CvDFT::getOptimalDftSize() const
 	return optimalDFTSize;
 }
 
+/*
+ * Dft size for current source image and frame mode
+ * @return the current dft size
+ */
+const Size & CvDFT::getDftSize() const
+{
+	return dftSize;
+}
+
+/*
+ * Frame mode read access
+ * @return the current frame mode
+ */
+CvDFT::FrameMode CvDFT::getFrameMode() const
+{
+	return frameMode;
+}
+
+/*
+ * Frame mode setting.
+ * Attributes are set up again since dft size changes (filter sizes
+ * are reset)
+ * @param frameMode the new frame mode
+ */
+void CvDFT::setFrameMode(const FrameMode frameMode)
+{
+	if (frameMode < NB_FRAME_MODES)
+	{
+		if (frameMode != this->frameMode)
+		{
+			this->frameMode = frameMode;
+			CvProcessor::setSourceImage(sourceImage);
+		}
+	}
+	else
+	{
+		cerr << "unknown frame mode " << frameMode;
+	}
+}
+
 /*
  * Get current log scale factor
  * @return the current log scale factor
@@ -614,6 +878,7 @@ void CvDFT::setLowPassFilterSize(const int channel, const int filterSize)
 {
 	if ((channel >= 0) && (channel < nbChannels))
 	{
+		int previousSize = lowPassFilterSize[channel];
 		if (filterSize < highPassFilterSize[channel])
 		{
 			lowPassFilterSize[channel] = highPassFilterSize[channel];
@@ -626,6 +891,11 @@ void CvDFT::setLowPassFilterSize(const int channel, const int filterSize)
 		{
 			lowPassFilterSize[channel] = filterSize;
 		}
+
+		if (lowPassFilterSize[channel] != previousSize)
+		{
+			invalidateSpectrumMasks(channel);
+		}
 	}
 }
 
@@ -641,6 +911,7 @@ void CvDFT::setHighPassFilterSize(const int channel, const int filterSize)
 {
 	if ((channel >= 0) && (channel < nbChannels))
 	{
+		int previousSize = highPassFilterSize[channel];
 		if (filterSize > lowPassFilterSize[channel])
 		{
 			highPassFilterSize[channel] = lowPassFilterSize[channel];
@@ -653,9 +924,255 @@ void CvDFT::setHighPassFilterSize(const int channel, const int filterSize)
 		{
 			highPassFilterSize[channel] = filterSize;
 		}
+
+		if (highPassFilterSize[channel] != previousSize)
+		{
+			invalidateSpectrumMasks(channel);
+		}
 	}
 }
 
+// --------------------------------------------------------------------
+// Spectrum masks cache
+// --------------------------------------------------------------------
+/*
+ * Invalidates spectrum mask of a channel so it will be rebuilt during
+ * next update
+ * @param channel channel index. If channel index == number of channels
+ * then invalidates all channels masks
+ */
+void CvDFT::invalidateSpectrumMasks(const int channel)
+{
+	if ((channel >= 0) && (channel < nbChannels))
+	{
+		channelsMaskValid[channel] = false;
+	}
+	else if (channel == nbChannels)
+	{
+		for (int i = 0; i < nbChannels; i++)
+		{
+			channelsMaskValid[i] = false;
+		}
+	}
+}
+
+/*
+ * Checks if two channels spectrum masks are identical according to
+ * current filtering status and filter type
+ * @param channel1 first channel index
+ * @param channel2 second channel index
+ * @return true if both channels have the same spectrum mask
+ */
+bool CvDFT::sameSpectrumMasks(const int channel1, const int channel2) const
+{
+	return !filtering ||
+		   ((lowPassFilterSize[channel1] == lowPassFilterSize[channel2]) &&
+			(highPassFilterSize[channel1] == highPassFilterSize[channel2]));
+}
+
+/*
+ * Rebuilds invalidated spectrum masks and their display.
+ * An invalidated channel mask identical to another valid channel mask
+ * shares this mask (its packed version and its display) instead of being
+ * computed again, otherwise a new mask is allocated (so masks shared with
+ * other channels are left unchanged) and computed.
+ */
+void CvDFT::updateSpectrumMasks()
+{
+	for (int i = 0; i < nbChannels; i++)
+	{
+		if (channelsMaskValid[i])
+		{
+			continue;
+		}
+
+		int shared = -1;
+		for (int j = 0; (j < nbChannels) && (shared < 0); j++)
+		{
+			if ((j != i) && channelsMaskValid[j] && sameSpectrumMasks(i, j))
+			{
+				shared = j;
+			}
+		}
+
+		if (shared >= 0)
+		{
+			channelsSpectrumMask[i] = channelsSpectrumMask[shared];
+			channelsPackedSpectrumMask[i] = channelsPackedSpectrumMask[shared];
+			channelsSpectrumMaskDisplay[i] = channelsSpectrumMaskDisplay[shared];
+		}
+		else
+		{
+			int realType = (singlePrecision ? CV_32FC1 : CV_64FC1);
+			channelsSpectrumMask[i] = Mat(dftSize, realType);
+			channelsPackedSpectrumMask[i] = Mat(dftSize, realType);
+			channelsSpectrumMaskDisplay[i] = Mat(dftSize, CV_8UC1);
+			if (singlePrecision)
+			{
+				computeSpectrumMask<float>(i);
+			}
+			else
+			{
+				computeSpectrumMask<double>(i);
+			}
+		}
+
+		channelsMaskValid[i] = true;
+	}
+}
+
+/*
+ * Computes spectrum mask of a channel and its display according to
+ * filtering status, filter type and channel filter sizes
+ * @param channel channel index
+ * @tparam T floating point type of the masks (float or double)
+ * @pre channelsSpectrumMask[channel] is not shared with other channels
+ */
+template <typename T>
+void CvDFT::computeSpectrumMask(const int channel)
+{
+	Scalar one(1.0);
+	Scalar zero(0.0);
+
+	if (filtering)
+	{
+		// Clear lowpass mask with black
+		channelsLowPassMask[channel] = zero;
+		// Clear highpass mask with white
+		channelsHighPassMask[channel] = one;
+
+		// Compute lowpass and highpass masks
+		// Mask center
+		double gx = (double) (dftSize.width - 1) / 2.0;
+		double gy = (double) (dftSize.height - 1) / 2.0;
+		// Elliptic masks axes ratios (1 for square DFT size)
+		double xRatio = (double) dftSize.width / (double) optimalDFTSize;
+		double yRatio = (double) dftSize.height / (double) optimalDFTSize;
+		// filter amplitude
+		double amplitude = 1.0;
+		switch (filterType)
+		{
+			case BOX_FILTER:
+				// Draw white filled circle on mask
+				if (lowPassFilterSize[channel] < filterMaxSize+1)
+				{
+					// Draws a white circle in channelsLowPassMask[channel]
+					// - point : (optimalDFTSize/2, optimalDFTSize/2)
+					// - color : one (see above)
+					// - filled circle
+					// - with size from lowPassFilterSize[]
+					// - use CV_AA as lineType
+					// - no shift
+					// TODO Compléter ...
+					// circle(...);
+					drawMaskDisk(channelsLowPassMask[channel],
+								 lowPassFilterSize[channel],
+								 one);
+				}
+
+				// Draw black circle inside white filled circle
+				if (highPassFilterSize[channel] > 0)
+				{
+					// Draws a black circle in channelsHighPassMask[channel]
+					// - point : (optimalDFTSize/2, optimalDFTSize/2)
+					// - color : zero (see above)
+					// - filled circle
+					// - with size from highPassFilterSize[]
+					// - use CV_AA as lineType
+					// - no shift
+					// TODO Compléter ...
+					// circle(...);
+					drawMaskDisk(channelsLowPassMask[channel],
+								 highPassFilterSize[channel],
+								 zero);
+				}
+				break;
+			case GAUSS_FILTER:
+				// TODO Compléter la méthode gaussian2D<T>(...) en fin de fichier
+
+				// positive gaussian for low pass freq filter
+				if (lowPassFilterSize[channel] < filterMaxSize+1)
+				{
+					gaussian2D<T> (channelsLowPassMask[channel],
+								   gx,
+								   gy,
+								   (double) lowPassFilterSize[channel],
+								   amplitude,
+								   xRatio,
+								   yRatio);
+				}
+
+				// negative gaussian for high pass freq filter
+				if (highPassFilterSize[channel] > filterMinSize)
+				{
+					gaussian2D<T> (channelsHighPassMaskReverse[channel],
+								   gx,
+								   gy,
+								   (double) highPassFilterSize[channel],
+								   amplitude,
+								   xRatio,
+								   yRatio);
+
+					reverseValues<T>(channelsHighPassMaskReverse[channel],
+									 channelsHighPassMask[channel],
+									 1.0);
+				}
+				break;
+			case SINC_FILTER:
+
+				// TODO Compléter la méthode sinc2D<T>(...) en fin de fichier
+
+				// positive sinc
+				if (lowPassFilterSize[channel] < filterMaxSize+1)
+				{
+					sinc2D<T> (channelsLowPassMask[channel],
+							   gx,
+							   gy,
+							   (double) lowPassFilterSize[channel],
+							   amplitude,
+							   xRatio,
+							   yRatio);
+				}
+
+				// negative sinc
+				if (highPassFilterSize[channel] > filterMinSize)
+				{
+					sinc2D<T> (channelsHighPassMaskReverse[channel],
+							   gx,
+							   gy,
+							   (double) highPassFilterSize[channel],
+							   amplitude,
+							   xRatio,
+							   yRatio);
+
+					reverseValues<T>(channelsHighPassMaskReverse[channel],
+									 channelsHighPassMask[channel],
+									 1.0);
+				}
+				break;
+			default:
+				break;
+		} // end switch (filterType)
+
+		// multiply lowpass and highpass
+		multiply(channelsLowPassMask[channel],
+				 channelsHighPassMask[channel],
+				 channelsSpectrumMask[channel]);
+
+		// mask layout for packed spectrums
+		packSpectrumMask<T>(channelsSpectrumMask[channel],
+							channelsPackedSpectrumMask[channel]);
+	}
+	else // No filtering: spectrum mask is completely white
+	{
+		channelsSpectrumMask[channel] = one;
+	}
+
+	// Converts Spectrum mask for display
+	convertScaleAbs(channelsSpectrumMask[channel],
+					channelsSpectrumMaskDisplay[channel]);
+}
+
 // --------------------------------------------------------------------
 // Utility methods
 // --------------------------------------------------------------------
@@ -664,26 +1181,42 @@ void CvDFT::setHighPassFilterSize(const int channel, const int filterSize)
  * (low frequencies at the center of the image and high frequencies on
  * the border), or modify image obtained from reverse Fourier transform
  * with reversed frequencies.
- * @param imgIn source image
- * @param imgOut destination image
+ * @param imgIn source image (uchar or floating point)
+ * @param imgOut destination image with shiftSigns type
  */
-template <typename T>
-void CvDFT::frequencyShift(Mat & imgIn, Mat & imgOut)
+void CvDFT::frequencyShift(const Mat & imgIn, Mat & imgOut)
 {
-	int i, j;
+	/*
+	 * Performance issue : using pow(-1.0, i + j) makes frequencyShift
+	 * use up to 42.6 % of CPU time of update loop whereas using
+	 * ((i+j)%2 == 0 ? 1.0 : -1.0) reduces this to 5.8 % of CPU time.
+	 * Multiplying by precomputed signs (and converting input at the same
+	 * time) is vectorized and removes the per pixel access and modulo.
+	 */
+	multiply(imgIn, shiftSigns, imgOut, 1.0, shiftSigns.type());
+}
 
-	for (i = 0; i < imgIn.rows; i++)
+/*
+ * Draws a filled disk centered in a DFT sized mask: a circle for
+ * square DFT sizes or an ellipse with axes proportional to DFT sizes
+ * for rectangular DFT sizes
+ * @param mask the mask to draw in
+ * @param radius the disk radius relative to optimalDFTSize
+ * @param color the disk color
+ */
+void CvDFT::drawMaskDisk(Mat & mask, const int radius, const Scalar & color)
+{
+	Point center(dftSize.width / 2, dftSize.height / 2);
+
+	if (dftSize.width == dftSize.height)
 	{
-		for (j = 0; j < imgIn.cols; j++)
-		{
-			/*
-			 * Performance issue : using pow(-1.0, i + j) makes frequencyShift
-			 * use up to 42.6 % of CPU time of update loop whereas using
-			 * ((i+j)%2 == 0 ? 1.0 : -1.0) reduces this to 5.8 % of CPU time.
-			 */
-			// imgOut.at<T> (i, j) = imgIn.at<T> (i, j) * (T)pow(-1.0, i + j);
-			imgOut.at<T>(i, j) = imgIn.at<T>(i, j) * (T) ((i + j) % 2 == 0 ? 1.0 : -1.0);
-		}
+		circle(mask, center, radius, color, -1, CV_AA);
+	}
+	else
+	{
+		Size axes(cvRound((double) radius * dftSize.width / optimalDFTSize),
+				  cvRound((double) radius * dftSize.height / optimalDFTSize));
+		ellipse(mask, center, axes, 0.0, 0.0, 360.0, color, -1, CV_AA);
 	}
 }
 
@@ -698,7 +1231,7 @@ void CvDFT::frequencyShift(Mat & imgIn, Mat & imgOut)
  */
 template <typename T>
 void CvDFT::gaussian2D(Mat & image, double x0, double y0, double sigma,
-	double amp)
+	double amp, double xRatio, double yRatio)
 {
 	if (sigma > 0.0)
 	{
@@ -711,14 +1244,16 @@ void CvDFT::gaussian2D(Mat & image, double x0, double y0, double sigma,
 			// yterms in the gaussian (y - y0)^2 / (2 * sigma^2)
 			// TODO compléter
 			// double yterms = ...
-            double yterms = (i - y0)*(i-y0) / sigmaFactor;
+            double dy = (i - y0) / yRatio;
+            double yterms = dy*dy / sigmaFactor;
 
 			for (int j = 0; j < image.cols; j++)
 			{
 				// xterms in the gaussian (x - x0)^2 / (2 * sigma^2)
 				// TODO compléter
 				// double xterms = ...
-                double xterms = (j - x0)*(j - x0) / sigmaFactor;
+                double dx = (j - x0) / xRatio;
+                double xterms = dx*dx / sigmaFactor;
 
 				// Gaussian = (T) (amp * exp(-(xterms + yterms))
 				// TODO remplacer
@@ -745,7 +1280,7 @@ void CvDFT::gaussian2D(Mat & image, double x0, double y0, double sigma,
  */
 template <typename T>
 void CvDFT::sinc2D(Mat & image, double x0, double y0, double sigma,
-	double amp)
+	double amp, double xRatio, double yRatio)
 {
 	// h : mid height width
 	double h = 0.6033 * M_PI / sigma;
@@ -758,13 +1293,15 @@ void CvDFT::sinc2D(Mat & image, double x0, double y0, double sigma,
 		{
 			// yterms in sinc (y-y0)^2
 			// TODO Compléter ...
-            double yterms = (i-y0)*(i-y0);
+            double dy = (i - y0) / yRatio;
+            double yterms = dy*dy;
 
 			for (int j = 0; j < image.cols; j++)
 			{
 				// xterms in sinc (x-x0)^2
 				// TODO Compléter ...
-                double xterms = (j-x0)*(j-x0);
+                double dx = (j - x0) / xRatio;
+                double xterms = dx*dx;
 
 				// TODO Remplacer ...
                 //double valTerm = 0;
@@ -793,6 +1330,120 @@ void CvDFT::sinc2D(Mat & image, double x0, double y0, double sigma,
 }
 
 
+/*
+ * Computes spectrum magnitude of all frequencies from a spectrum in
+ * packed (CCS) format.
+ * Magnitudes of frequencies which are not stored in packed spectrum
+ * are obtained from the hermitian symmetry of real signals spectrum:
+ * \f$|X(u,v)| = |X(-u,-v)|\f$
+ * @param packed the packed spectrum
+ * @param magnitude the magnitude image (same size as packed)
+ * @par Packed layout:
+ * 	- columns 2j-1 and 2j of row u contain real and imaginary parts of
+ * 	X(u,j) for 0 < j < cols/2
+ * 	- first column (and last column when cols is even) contain X(u,0)
+ * 	(and X(u,cols/2)) for 0 <= u <= rows/2: X(0,.) real part in row 0,
+ * 	X(u,.) real and imaginary parts in rows 2u-1 and 2u and
+ * 	X(rows/2,.) real part in last row when rows is even
+ */
+template <typename T>
+void CvDFT::packedMagnitude(const Mat & packed, Mat & magnitude)
+{
+	const int rows = packed.rows;
+	const int cols = packed.cols;
+
+	// Inner columns
+	for (int u = 0; u < rows; u++)
+	{
+		const T * in = packed.ptr<T>(u);
+		T * out = magnitude.ptr<T>(u);
+		for (int j = 1; 2 * j < cols; j++)
+		{
+			T re = in[2 * j - 1];
+			T im = in[2 * j];
+			out[j] = (T) sqrt(re * re + im * im);
+		}
+	}
+
+	// First column and last column when cols is even
+	const int nbEdges = (cols % 2 == 0 ? 2 : 1);
+	for (int e = 0; e < nbEdges; e++)
+	{
+		const int c = (e == 0 ? 0 : cols / 2);
+		const int pc = (e == 0 ? 0 : cols - 1);
+		magnitude.at<T>(0, c) = abs(packed.at<T>(0, pc));
+		for (int u = 1; 2 * u < rows; u++)
+		{
+			T re = packed.at<T>(2 * u - 1, pc);
+			T im = packed.at<T>(2 * u, pc);
+			T value = (T) sqrt(re * re + im * im);
+			magnitude.at<T>(u, c) = value;
+			magnitude.at<T>(rows - u, c) = value;
+		}
+		if (rows % 2 == 0)
+		{
+			magnitude.at<T>(rows / 2, c) = abs(packed.at<T>(rows - 1, pc));
+		}
+	}
+
+	// Other half of the spectrum from hermitian symmetry
+	for (int u = 0; u < rows; u++)
+	{
+		const T * mirror = magnitude.ptr<T>((rows - u) % rows);
+		T * out = magnitude.ptr<T>(u);
+		for (int v = cols / 2 + 1; v < cols; v++)
+		{
+			out[v] = mirror[cols - v];
+		}
+	}
+}
+
+/*
+ * Packs a real spectrum mask in the layout of a packed (CCS) spectrum
+ * so packed spectrum can be masked with a single multiplication:
+ * real and imaginary parts of a frequency receive the mask value of
+ * this frequency.
+ * @param mask the spectrum mask
+ * @param packed the packed mask (same size as mask)
+ * @see #packedMagnitude for packed layout
+ */
+template <typename T>
+void CvDFT::packSpectrumMask(const Mat & mask, Mat & packed)
+{
+	const int rows = mask.rows;
+	const int cols = mask.cols;
+
+	// Inner columns
+	for (int u = 0; u < rows; u++)
+	{
+		const T * in = mask.ptr<T>(u);
+		T * out = packed.ptr<T>(u);
+		for (int j = 1; 2 * j < cols; j++)
+		{
+			out[2 * j - 1] = in[j];
+			out[2 * j] = in[j];
+		}
+	}
+
+	// First column and last column when cols is even
+	const int nbEdges = (cols % 2 == 0 ? 2 : 1);
+	for (int e = 0; e < nbEdges; e++)
+	{
+		const int c = (e == 0 ? 0 : cols / 2);
+		const int pc = (e == 0 ? 0 : cols - 1);
+		packed.at<T>(0, pc) = mask.at<T>(0, c);
+		for (int u = 1; 2 * u < rows; u++)
+		{
+			packed.at<T>(2 * u - 1, pc) = mask.at<T>(u, c);
+			packed.at<T>(2 * u, pc) = mask.at<T>(u, c);
+		}
+		if (rows % 2 == 0)
+		{
+			packed.at<T>(rows - 1, pc) = mask.at<T>(rows / 2, c);
+		}
+	}
+}
+
 /*
  * Log scale T valued image
  * @param imgIn input image
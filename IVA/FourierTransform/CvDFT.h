@@ -15,6 +15,7 @@ using namespace std;
 using namespace cv;
 
 #include "CvProcessor.h"
+#include "CvFFTBackend.h"
 
 /**
  * Class to compute DFT on input image, then apply filters on the resulting
@@ -51,6 +52,31 @@ class CvDFT : virtual public CvProcessor
 			NB_FILTERS
 		} FilterType;
 
+		/**
+		 * Frame mode: part of the source image which is transformed
+		 */
+		typedef enum
+		{
+			/**
+			 * Center square of the source image resized to optimal DFT size
+			 */
+			SQUARE_FRAME = 0,
+			/**
+			 * Full source image padded with zeros to optimal DFT sizes
+			 * (optimal DFT size of each axis)
+			 */
+			FULL_FRAME_ZERO,
+			/**
+			 * Full source image padded with mirrored borders to optimal DFT
+			 * sizes (optimal DFT size of each axis)
+			 */
+			FULL_FRAME_MIRROR,
+			/**
+			 * Number of available frame modes
+			 */
+			NB_FRAME_MODES
+		} FrameMode;
+
 		/**
 		 * Minimum log scale factor.
 		 * Default value is 5.
@@ -80,7 +106,13 @@ class CvDFT : virtual public CvProcessor
 		int borderSize;
 
 		/**
-		 * DFT optimal size
+		 * Frame mode: center square or padded full frame
+		 */
+		FrameMode frameMode;
+
+		/**
+		 * DFT optimal size (smallest DFT size in full frame modes): filter
+		 * sizes are relative to this size
 		 */
 		int optimalDFTSize;
 
@@ -95,45 +127,69 @@ class CvDFT : virtual public CvProcessor
 		FilterType filterType;
 
 		/**
-		 * Optimal Fourier size
+		 * Precision of the spectral pipeline: when true all floating point
+		 * attributes are single precision (CV_32F) instead of double
+		 * precision (CV_64F), halving memory traffic in DFTs and spectrum
+		 * operations. Floating point attributes below are documented as
+		 * CV_64F and are CV_32F in single precision.
 		 */
-		Size dftSize;
+		bool singlePrecision;
 
 		/**
-		 * Input frame cropped to square size for FFT: CV_8UC<nbChannels>
+		 * Indicates if color channels are processed concurrently (each
+		 * channel is processed independently until final merges)
+		 * [default value is true when OpenCV uses several threads]
 		 */
-		Mat inFrameSquare;
+		bool parallelChannels;
 
 		/**
-		 * Input frame cropped color channels: CV_8UC1 x <nbChannels>
+		 * FFT backend used for forward and inverse DFTs [default value is
+		 * FFTW when available and OpenCV otherwise]
 		 */
-		vector<Mat> channels;
+		CvFFTBackend::BackendType fftBackend;
 
 		/**
-		 * Input frame square channels converted to doubles: CV_64FC1 x <nbChannels>
+		 * Optimal Fourier size
+		 */
+		Size dftSize;
+
+		/**
+		 * Region of the source frame in DFT sized images: the whole DFT
+		 * size in square mode or the region which is not padded in full
+		 * frame modes
+		 */
+		Rect frameRect;
+
+		/**
+		 * Input frame cropped to square size (or padded full frame) for FFT:
+		 * CV_8UC<nbChannels>
 		 */
-		vector<Mat> channelsDouble;
+		Mat inFrameSquare;
 
 		/**
-		 * Input frame square channels complex channels:
-		 * CV_64FC1 x 2 x <nbChannels>
+		 * Input frame cropped color channels: CV_8UC1 x <nbChannels>
 		 */
-		vector<vector<Mat> > channelsDoubleComplexComponents;
+		vector<Mat> channels;
 
 		/**
-		 * Input frame square complex image: CV_64FC2 x <nbChannels>
+		 * Frequency shift signs pattern \f$(-1)^{i+j}\f$: CV_64FC1
+		 * @see #frequencyShift
 		 */
-		vector<Mat> channelsComplexImages;
+		Mat shiftSigns;
 
 		/**
-		 * Complex spectrum images: CV_64FC2 x <nbChannels>
+		 * Input frame square channels converted to doubles with frequency
+		 * shift (real input of the DFT): CV_64FC1 x <nbChannels>
 		 */
-		vector<Mat> channelsComplexSpectrums;
+		vector<Mat> channelsShifted;
 
 		/**
-		 * Complex spectrum channels: CV_64FC1 x 2 x <nbChannels>
+		 * Spectrum of real channels in packed format (CCS: only half of the
+		 * hermitian spectrum is stored as real and imaginary parts):
+		 * CV_64FC1 x <nbChannels>
+		 * @see cv::dft
 		 */
-		vector<vector<Mat> > channelsComplexSpectrumComponents;
+		vector<Mat> channelsPackedSpectrums;
 
 		/**
 		 * Spectrum magnitude: CV_64FC1 x <nbChannels>
@@ -188,6 +244,15 @@ class CvDFT : virtual public CvProcessor
 		 */
 		vector<Mat> channelsSpectrumMask;
 
+		/**
+		 * Indicates if spectrum mask (and its display) of each channel is up
+		 * to date with filtering status, filter type and channel filter sizes.
+		 * Masks are only rebuilt during update when invalidated by a setter:
+		 * they do not need to be computed again for each frame.
+		 * @note identical masks are shared among channels
+		 */
+		vector<bool> channelsMaskValid;
+
 		/**
 		 * Channel spectrum mask converted for display :
 		 * CV_8UC1 x <nbChannels>
@@ -200,26 +265,30 @@ class CvDFT : virtual public CvProcessor
 		Mat spectrumMaskImage;
 
 		/**
-		 * Complex spectrum masked: CV_64FC2 x <nbChannels>
+		 * Channel spectrum mask in packed format: each real and imaginary
+		 * part of the packed spectrum is associated to the mask value of
+		 * its frequency: CV_64FC1 x <nbChannels>
 		 */
-		vector<Mat> channelsComplexSpectrumsMasked;
+		vector<Mat> channelsPackedSpectrumMask;
 
 		/**
-		 * Complex channels resulting from inverse Fourier transform
-		 * of the masked complex spectrums: CV_64FC2 x <nbChannels>
+		 * Packed spectrum masked: CV_64FC1 x <nbChannels>
 		 */
-		vector<Mat> channelsComplexInverseImages;
+		vector<Mat> channelsPackedSpectrumsMasked;
 
 		/**
-		 * Complex inverse image channels: CV_64FC1 x 2 x <nbChannels>
+		 * Real channels resulting from inverse Fourier transform of the
+		 * masked packed spectrums: CV_64FC1 x <nbChannels>
+		 * @note these channels still contain the frequency shift signs
+		 * which are removed by absolute values when converted for display
 		 */
-		vector<vector<Mat> > channelsComplexInverseComponents;
+		vector<Mat> channelsInverse;
 
 		/**
-		 * Real part of FFT inverse channels (with fft shift):
-		 * CV_64FC1 x <nbChannels>
+		 * FFT backends (one per channel since channels may be processed
+		 * concurrently) planned for current DFT size and precision
 		 */
-		vector<Mat> channelsRealInverse;
+		vector<CvFFTBackend *> channelsFFT;
 
 		/**
 		 * Real part of FFT inverse channels converted for display:
@@ -228,7 +297,8 @@ class CvDFT : virtual public CvProcessor
 		vector<Mat> channelsRealInverseDisplay;
 
 		/**
-		 * Image composed with display real parts: CV_8UC<nbChannels>
+		 * Image composed with display real parts (within frameRect):
+		 * CV_8UC<nbChannels>
 		 */
 		Mat inverseImage;
 
@@ -270,39 +340,31 @@ class CvDFT : virtual public CvProcessor
 		 * DFT Update.
 		 * Steps in update
 		 * 	- crop source image to a square according to optima FFT size
+		 * 	(or pad full source image to optimal FFT sizes in full frame
+		 * 	modes)
 		 * 	- split in frame square into color channels
-		 *	- converts these color channels to double
-		 *	- apply frequency shift on double channels to
-		 *		- produce the shifted real component of source channels
+		 * 	- rebuild invalidated channels spectrum masks (see
+		 * 	#updateSpectrumMasks)
+		 * 	- for each channel (concurrently if parallelChannels is on)
+		 *	- converts these color channels to double (or float in single
+		 *	precision) with frequency shift to
+		 *		- produce the shifted real input of the DFT
 		 *		- produce later a spectrum with low frequencies at image center
-		 *	- merge real/image channels into complex image per channel
-		 *	- compute dft on each channel
-		 *	- split channels complex spectrum in to real/imag components
-		 *	- compute channels spectrum magnitude from real/imag components
+		 *	- compute real dft on each channel into packed (CCS) spectrum
+		 *	- compute channels spectrum magnitude from packed spectrum
 		 *	- log scale channels spectrum magnitude
-		 *	- if filtering
-		 *		- fill lowpass channel masks with 0
-		 *		- fill highpass channel masks with 1
-		 *		- draw white low pass filter in lowpass channels
-		 *		- draw white high pass filters in revrse highpass channels
-		 *		- reverse highpass reverse channels to produce high pass
-		 *		channels
-		 *		- multiply lowpass & highpass channels into channel spectrum
-		 *		masks
-		 *		- multiply log magnitude spectrum channels by masks
-		 *	- if not filtering then fill channels spectum masks with ones
-		 *	- converts channels spectum masks for display
+		 *	- if filtering multiply log magnitude spectrum channels by masks
 		 *	- converts channels log magnitude for display
-		 *	- multiply channels complex spectrum components by masks
-		 *	- perform inverse dft on masked spectrum channel complex to produce
-		 *	inverse complex channels
-		 *	- split inverse channels complex image into real/imag components
-		 *	- perform frequency shift on real part o channels inverse component
-		 *	- convert channels real inverse part for display
+		 *	- if filtering multiply channels packed spectrum by packed masks
+		 *	- perform inverse dft on [masked] packed spectrum channels to
+		 *	produce real inverse channels
+		 *	- convert channels real inverse part for display (absolute values
+		 *	so no inverse frequency shift is needed)
 		 *	- merge channels spectrum log magnidude channels to displayable
 		 *	image
 		 *	- merge channels spectrum masks into a displayable image
-		 *	- merge real channels of inverse dft into displayable image
+		 *	- merge real channels of inverse dft (within frameRect) into
+		 *	displayable image
 		 */
 		virtual void update();
 
@@ -324,10 +386,31 @@ class CvDFT : virtual public CvProcessor
 
 		/**
 		 * Optimal dft size for current source image
-		 * @return the current optimal dft size
+		 * @return the current optimal dft size (smallest dft size in full
+		 * frame modes)
 		 */
 		int getOptimalDftSize() const;
 
+		/**
+		 * Dft size for current source image and frame mode
+		 * @return the current dft size
+		 */
+		const Size & getDftSize() const;
+
+		/**
+		 * Frame mode read access
+		 * @return the current frame mode
+		 */
+		FrameMode getFrameMode() const;
+
+		/**
+		 * Frame mode setting.
+		 * Attributes are set up again since dft size changes (filter sizes
+		 * are reset)
+		 * @param frameMode the new frame mode
+		 */
+		virtual void setFrameMode(const FrameMode frameMode);
+
 		/**
 		 * Filtering status
 		 * @return the filtering status. true if filtering is on, false
@@ -341,6 +424,48 @@ class CvDFT : virtual public CvProcessor
 		 */
 		virtual void setFiltering(bool filtering);
 
+		/**
+		 * Spectral pipeline precision
+		 * @return true if spectral pipeline is computed with single precision
+		 * (float) values, false if it is computed with double precision values
+		 */
+		bool isSinglePrecision() const;
+
+		/**
+		 * Setting spectral pipeline precision.
+		 * Floating point attributes are reallocated when precision changes.
+		 * @param singlePrecision the new precision status: true for single
+		 * precision (float) and false for double precision
+		 */
+		virtual void setSinglePrecision(const bool singlePrecision);
+
+		/**
+		 * Channels parallel processing status
+		 * @return true if color channels are processed concurrently
+		 */
+		bool isParallelChannels() const;
+
+		/**
+		 * Setting channels parallel processing status
+		 * @param parallelChannels the new channels parallel processing
+		 * status
+		 */
+		virtual void setParallelChannels(const bool parallelChannels);
+
+		/**
+		 * FFT backend read access
+		 * @return the current FFT backend
+		 */
+		CvFFTBackend::BackendType getFFTBackend() const;
+
+		/**
+		 * Setting FFT backend. Backends are created and planned again for
+		 * current DFT size and precision.
+		 * @param fftBackend the new FFT backend
+		 * @note unavailable backends are ignored
+		 */
+		virtual void setFFTBackend(const CvFFTBackend::BackendType fftBackend);
+
 		/**
 		 * Get current log scale factor
 		 * @return the current log scale factor
@@ -401,6 +526,21 @@ class CvDFT : virtual public CvProcessor
 		virtual void setHighPassFilterSize(const int channel,
 										   const int filterSize);
 
+		/**
+		 * Benchmarks single precision pipeline against double precision
+		 * pipeline on an image with gaussian low pass filtering: mean
+		 * update time of each precision and max absolute errors of single
+		 * precision spectrum magnitude (relative to the max magnitude),
+		 * of single precision inverse images and of their displayed 8 bits
+		 * conversion.
+		 * @param image the image to transform
+		 * @param out the stream to print results on
+		 * @param iterations the number of timed updates of each precision
+		 */
+		static void benchmarkPrecision(Mat * image,
+									   ostream & out,
+									   const int iterations = 20);
+
 	protected:
 
 		// --------------------------------------------------------------------
@@ -420,6 +560,112 @@ class CvDFT : virtual public CvProcessor
 		 */
 		void cleanup();
 
+		/**
+		 * (Re)allocates floating point attributes according to current
+		 * precision: CV_32F when singlePrecision is on and CV_64F otherwise,
+		 * and invalidates spectrum masks
+		 */
+		void setupPrecision();
+
+		/**
+		 * Creates missing channels FFT backends and plans them for current
+		 * DFT size and precision (planning is skipped when size and
+		 * precision have not changed)
+		 */
+		void setupFFTBackends();
+
+		/**
+		 * Deletes channels FFT backends
+		 */
+		void cleanupFFTBackends();
+
+		/**
+		 * Process one color channel of the square input frame: forward DFT,
+		 * spectrum log magnitude, spectrum masking, inverse DFT and
+		 * conversions for display.
+		 * @param channel channel index
+		 * @tparam T floating point type of the spectral pipeline (float or
+		 * double) which should match the depth of floating point attributes
+		 */
+		template <typename T>
+		void updateChannel(const int channel);
+
+		/**
+		 * Parallel loop body processing color channels with #updateChannel
+		 */
+		class ChannelProcessor;
+
+		/**
+		 * Computes elapsed wall clock time since start (in clock ticks so
+		 * it can be compared with other processors times).
+		 * @param start the starting time obtained with getTickCount()
+		 * @return the elapsed time in clock ticks
+		 * @note clock() measures CPU time of all threads and can not
+		 * report parallel channels speedups
+		 */
+		static clock_t elapsedTicks(const int64 start);
+
+		// --------------------------------------------------------------------
+		// Spectrum masks cache
+		// --------------------------------------------------------------------
+		/**
+		 * Invalidates spectrum mask of a channel so it will be rebuilt during
+		 * next update
+		 * @param channel channel index. If channel index == number of channels
+		 * then invalidates all channels masks
+		 */
+		void invalidateSpectrumMasks(const int channel);
+
+		/**
+		 * Checks if two channels spectrum masks are identical according to
+		 * current filtering status and filter type
+		 * @param channel1 first channel index
+		 * @param channel2 second channel index
+		 * @return true if both channels have the same spectrum mask
+		 */
+		bool sameSpectrumMasks(const int channel1, const int channel2) const;
+
+		/**
+		 * Rebuilds invalidated spectrum masks and their display.
+		 * An invalidated channel mask identical to another valid channel mask
+		 * shares this mask (its packed version and its display) instead of
+		 * being computed again, otherwise a new mask is allocated (so masks
+		 * shared with other channels are left unchanged) and computed.
+		 */
+		void updateSpectrumMasks();
+
+		/**
+		 * Computes spectrum mask of a channel and its display according to
+		 * filtering status, filter type and channel filter sizes:
+		 * 	- if filtering
+		 *		- fill lowpass channel mask with 0
+		 *		- fill highpass channel mask with 1
+		 *		- draw white low pass filter in lowpass channel
+		 *		- draw white high pass filter in reverse highpass channel
+		 *		- reverse highpass reverse channel to produce high pass
+		 *		channel
+		 *		- multiply lowpass & highpass channels into channel spectrum
+		 *		mask
+		 *		- pack channel spectrum mask into packed spectrum mask
+		 *	- if not filtering then fill channel spectum mask with ones
+		 *	- converts channel spectum mask for display
+		 * @param channel channel index
+		 * @tparam T floating point type of the masks (float or double)
+		 * @pre channelsSpectrumMask[channel] is not shared with other channels
+		 */
+		template <typename T>
+		void computeSpectrumMask(const int channel);
+
+		/**
+		 * Draws a filled disk centered in a DFT sized mask: a circle for
+		 * square DFT sizes or an ellipse with axes proportional to DFT sizes
+		 * for rectangular DFT sizes
+		 * @param mask the mask to draw in
+		 * @param radius the disk radius relative to optimalDFTSize
+		 * @param color the disk color
+		 */
+		void drawMaskDisk(Mat & mask, const int radius, const Scalar & color);
+
 		// --------------------------------------------------------------------
 		// Utility methods
 		// --------------------------------------------------------------------
@@ -428,8 +674,8 @@ class CvDFT : virtual public CvProcessor
 		 * (low frequencies at the center of the image and high frequencies on
 		 * the border), or modify image obtained from reverse Fourier transform
 		 * with reversed frequencies.
-		 * @param imgIn source image
-		 * @param imgOut destination image
+		 * @param imgIn source image (uchar or floating point)
+		 * @param imgOut destination image with shiftSigns type
 		 * @par Algorithm:
 		 * This is based on the following property of the Z transform :
 		 * \f[
@@ -463,9 +709,13 @@ class CvDFT : virtual public CvProcessor
 		 * \f]
 		 * \f$f_{e}\f$ is at the center of the spectrum image in 2D, which
 		 * means, low frequencies will be located at the center of the image.
+		 * @note signs are precomputed in #shiftSigns so the shift is a single
+		 * (vectorized) multiplication. Multiplying by +/-1 is exact, so
+		 * results are identical to a per pixel computation. Quadrant swaps of
+		 * the spectrum are not used since they would change DFT rounding and
+		 * are not equivalent for odd DFT sizes.
 		 */
-		template <typename T>
-		void frequencyShift(Mat & imgIn, Mat & imgOut);
+		void frequencyShift(const Mat & imgIn, Mat & imgOut);
 
 		/**
 		 * Computes a 2D gaussian on image
@@ -475,18 +725,23 @@ class CvDFT : virtual public CvProcessor
 		 * @param sigma gaussian width (at half height). If sigma <= 0 no
 		 * output is performed
 		 * @param amp amplitude
+		 * @param xRatio x axis ratio for elliptic gaussians (sigma along x
+		 * axis is sigma * xRatio)
+		 * @param yRatio y axis ratio for elliptic gaussians (sigma along y
+		 * axis is sigma * yRatio)
 		 * @post Compute a 2D gaussian in image:
 		 * \f[
 		 * g(x,y) = amp \cdot exp^{-
 		 * \left(
-		 * 	\frac{(x - x_{0})^{2} + (y - y_{0})^{2}}{2 \sigma^{2}}
+		 * 	\frac{(\frac{x - x_{0}}{x_{r}})^{2} +
+		 * 	(\frac{y - y_{0}}{y_{r}})^{2}}{2 \sigma^{2}}
 		 * 	\right)
 		 * 	}
 		 * \f]
 		 */
 		template <typename T>
 		void gaussian2D(Mat & image, double x0, double y0, double sigma,
-			double amp);
+			double amp, double xRatio = 1.0, double yRatio = 1.0);
 		/**
 		 * Computes a 2D sinc on image
 		 * @param image output (and/or input) image
@@ -495,10 +750,37 @@ class CvDFT : virtual public CvProcessor
 		 * @param sigma width (at half height). If sigma <= 0 no
 		 * output is performed
 		 * @param amp amplitude
+		 * @param xRatio x axis ratio for elliptic sincs (width along x
+		 * axis is sigma * xRatio)
+		 * @param yRatio y axis ratio for elliptic sincs (width along y
+		 * axis is sigma * yRatio)
 		 */
 		template <typename T>
 		void sinc2D(Mat & image, double x0, double y0, double sigma,
-			double amp);
+			double amp, double xRatio = 1.0, double yRatio = 1.0);
+
+		/**
+		 * Computes spectrum magnitude of all frequencies from a spectrum in
+		 * packed (CCS) format.
+		 * Magnitudes of frequencies which are not stored in packed spectrum
+		 * are obtained from the hermitian symmetry of real signals spectrum:
+		 * \f$|X(u,v)| = |X(-u,-v)|\f$
+		 * @param packed the packed spectrum
+		 * @param magnitude the magnitude image (same size as packed)
+		 */
+		template <typename T>
+		void packedMagnitude(const Mat & packed, Mat & magnitude);
+
+		/**
+		 * Packs a real spectrum mask in the layout of a packed (CCS) spectrum
+		 * so packed spectrum can be masked with a single multiplication:
+		 * real and imaginary parts of a frequency receive the mask value of
+		 * this frequency.
+		 * @param mask the spectrum mask
+		 * @param packed the packed mask (same size as mask)
+		 */
+		template <typename T>
+		void packSpectrumMask(const Mat & mask, Mat & packed);
 
 		/**
 		 * Log scale T valued image
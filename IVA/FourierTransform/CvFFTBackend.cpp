@@ -0,0 +1,191 @@
+/*
+ * CvFFTBackend.cpp
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#include <iomanip>	// for setw
+
+#include "CvFFTBackend.h"
+#include "CvOpenCVFFTBackend.h"
+#ifdef HAVE_FFTW
+#include "CvFFTWBackend.h"
+#endif
+
+/*
+ * Backends names
+ */
+const char * CvFFTBackend::BackendNames[NB_BACKENDS] =
+{
+	"OpenCV",
+	"FFTW"
+};
+
+/*
+ * FFT backend default constructor: backend is not planned yet
+ */
+CvFFTBackend::CvFFTBackend() :
+	size(0, 0),
+	type(CV_64FC1)
+{
+}
+
+/*
+ * FFT backend destructor
+ */
+CvFFTBackend::~CvFFTBackend()
+{
+}
+
+/*
+ * Plans transforms of a new DFT size and type. Planning is only
+ * performed when size or type differs from current plan.
+ * @param size the DFT size
+ * @param type the DFT type: CV_32FC1 or CV_64FC1
+ */
+void CvFFTBackend::plan(const Size & size, const int type)
+{
+	this->size = size;
+	this->type = type;
+}
+
+/*
+ * Planned DFT size read access
+ * @return the current planned size
+ */
+const Size & CvFFTBackend::getSize() const
+{
+	return size;
+}
+
+/*
+ * Planned DFT type read access
+ * @return the current planned type
+ */
+int CvFFTBackend::getType() const
+{
+	return type;
+}
+
+/*
+ * Checks if a backend is available in this build
+ * @param backend the backend to check
+ * @return true if this backend can be created
+ */
+bool CvFFTBackend::isAvailable(const BackendType backend)
+{
+	switch (backend)
+	{
+		case OPENCV_BACKEND:
+			return true;
+		case FFTW_BACKEND:
+#ifdef HAVE_FFTW
+			return true;
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+/*
+ * FFT backend factory
+ * @param backend the required backend
+ * @return a new (not planned) backend or NULL if this backend is not
+ * available
+ */
+CvFFTBackend * CvFFTBackend::create(const BackendType backend)
+{
+	switch (backend)
+	{
+		case OPENCV_BACKEND:
+			return new CvOpenCVFFTBackend();
+#ifdef HAVE_FFTW
+		case FFTW_BACKEND:
+			return new CvFFTWBackend();
+#endif
+		default:
+			cerr << "FFT backend " << backend << " is not available" << endl;
+			return NULL;
+	}
+}
+
+/*
+ * Benchmarks available backends on square DFTs of every size
+ * produced by getOptimalDFTSize in [minSize..maxSize] in single and
+ * double precision and prints plan time and mean forward + inverse
+ * time of each backend
+ * @param out the stream to print results to
+ * @param minSize the minimum DFT size
+ * @param maxSize the maximum DFT size
+ * @param iterations the number of forward + inverse transforms
+ * timed for each size
+ */
+void CvFFTBackend::benchmark(ostream & out,
+							 const int minSize,
+							 const int maxSize,
+							 const int iterations)
+{
+	const int types[2] = {CV_32FC1, CV_64FC1};
+	double tickPeriod = 1000.0 / getTickFrequency(); // in ms
+
+	out << "FFT backends benchmark: plan time and mean forward + inverse "
+		<< "time (ms)" << endl;
+	out << setw(6) << "size" << setw(8) << "type";
+	for (int b = 0; b < NB_BACKENDS; b++)
+	{
+		if (isAvailable((BackendType)b))
+		{
+			out << setw(10) << BackendNames[b] << " plan"
+				<< setw(10) << BackendNames[b] << " run";
+		}
+	}
+	out << endl;
+
+	for (int n = getOptimalDFTSize(minSize);
+		 n <= maxSize;
+		 n = getOptimalDFTSize(n + 1))
+	{
+		for (int t = 0; t < 2; t++)
+		{
+			Mat source(n, n, types[t]);
+			Mat spectrum;
+			Mat result;
+			randu(source, Scalar::all(-1.0), Scalar::all(1.0));
+
+			out << setw(6) << n
+				<< setw(8) << (types[t] == CV_32FC1 ? "float" : "double");
+
+			for (int b = 0; b < NB_BACKENDS; b++)
+			{
+				if (!isAvailable((BackendType)b))
+				{
+					continue;
+				}
+
+				CvFFTBackend * backend = create((BackendType)b);
+
+				int64 start = getTickCount();
+				backend->plan(source.size(), types[t]);
+				double planTime = (getTickCount() - start) * tickPeriod;
+
+				start = getTickCount();
+				for (int i = 0; i < iterations; i++)
+				{
+					backend->forward(source, spectrum);
+					backend->inverse(spectrum, result);
+				}
+				double runTime = (getTickCount() - start) * tickPeriod /
+					(double) iterations;
+
+				out << setw(15) << fixed << setprecision(3) << planTime
+					<< setw(14) << fixed << setprecision(3) << runTime;
+
+				delete backend;
+			}
+			out << endl;
+		}
+	}
+}
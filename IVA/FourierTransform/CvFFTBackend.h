@@ -0,0 +1,145 @@
+/*
+ * CvFFTBackend.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#ifndef CVFFTBACKEND_H_
+#define CVFFTBACKEND_H_
+
+#include <iostream>
+using namespace std;
+
+#include <cv.h>
+using namespace cv;
+
+/**
+ * FFT backend interface used by CvDFT to compute real 2D DFTs into packed
+ * (CCS) spectrums and inverse DFTs from packed spectrums back to real
+ * images.
+ * Backends are planned once for a DFT size and type (CV_32FC1 or CV_64FC1)
+ * and then reused for every frame with the same size and type.
+ * @note A backend instance is not meant to be used concurrently from
+ * several threads: use one backend per concurrently processed channel.
+ */
+class CvFFTBackend
+{
+	public:
+		/**
+		 * Available FFT backends
+		 */
+		typedef enum
+		{
+			/**
+			 * OpenCV cv::dft / cv::idft
+			 */
+			OPENCV_BACKEND = 0,
+			/**
+			 * FFTW library (only available when built with HAVE_FFTW)
+			 */
+			FFTW_BACKEND,
+			/**
+			 * Number of FFT backends
+			 */
+			NB_BACKENDS
+		} BackendType;
+
+		/**
+		 * Backends names
+		 */
+		static const char * BackendNames[NB_BACKENDS];
+
+	protected:
+		/**
+		 * Planned DFT size (empty when not planned yet)
+		 */
+		Size size;
+
+		/**
+		 * Planned DFT type: CV_32FC1 or CV_64FC1
+		 */
+		int type;
+
+	public:
+		/**
+		 * FFT backend default constructor: backend is not planned yet
+		 */
+		CvFFTBackend();
+
+		/**
+		 * FFT backend destructor
+		 */
+		virtual ~CvFFTBackend();
+
+		/**
+		 * Plans transforms of a new DFT size and type. Planning is only
+		 * performed when size or type differs from current plan.
+		 * @param size the DFT size
+		 * @param type the DFT type: CV_32FC1 or CV_64FC1
+		 */
+		virtual void plan(const Size & size, const int type);
+
+		/**
+		 * Computes forward DFT of a real image into packed (CCS) spectrum
+		 * (same layout as cv::dft on real images)
+		 * @param src the real source image of planned size and type
+		 * @param dst the packed spectrum (allocated with planned size and
+		 * type if needed)
+		 */
+		virtual void forward(const Mat & src, Mat & dst) = 0;
+
+		/**
+		 * Computes scaled inverse DFT of a packed (CCS) spectrum into a
+		 * real image (same as cv::idft with DFT_REAL_OUTPUT + DFT_SCALE)
+		 * @param src the packed spectrum of planned size and type
+		 * @param dst the real image (allocated with planned size and
+		 * type if needed)
+		 */
+		virtual void inverse(const Mat & src, Mat & dst) = 0;
+
+		/**
+		 * Planned DFT size read access
+		 * @return the current planned size
+		 */
+		const Size & getSize() const;
+
+		/**
+		 * Planned DFT type read access
+		 * @return the current planned type
+		 */
+		int getType() const;
+
+		/**
+		 * Checks if a backend is available in this build
+		 * @param backend the backend to check
+		 * @return true if this backend can be created
+		 */
+		static bool isAvailable(const BackendType backend);
+
+		/**
+		 * FFT backend factory
+		 * @param backend the required backend
+		 * @return a new (not planned) backend or NULL if this backend is not
+		 * available
+		 */
+		static CvFFTBackend * create(const BackendType backend);
+
+		/**
+		 * Benchmarks available backends on square DFTs of every size
+		 * produced by getOptimalDFTSize in [minSize..maxSize] in single and
+		 * double precision and prints plan time and mean forward + inverse
+		 * time of each backend
+		 * @param out the stream to print results to
+		 * @param minSize the minimum DFT size
+		 * @param maxSize the maximum DFT size
+		 * @param iterations the number of forward + inverse transforms
+		 * timed for each size
+		 */
+		static void benchmark(ostream & out,
+							  const int minSize = 64,
+							  const int maxSize = 1024,
+							  const int iterations = 20);
+};
+
+#endif /* CVFFTBACKEND_H_ */
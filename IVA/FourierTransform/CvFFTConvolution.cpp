@@ -0,0 +1,583 @@
+/*
+ * CvFFTConvolution.cpp
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#include <climits>	// for INT_MAX
+#include <cmath>	// for sqrt
+#include <iomanip>	// for setw
+
+#include <opencv2/core/core.hpp>	// for parallel_for_
+#include <opencv2/imgproc/imgproc.hpp>	// for filter2D
+
+#include "CvFFTConvolution.h"
+
+/*
+ * Crossover kernel size used when no calibration has been performed
+ */
+const int CvFFTConvolution::defaultCrossoverSize = 11;
+
+/*
+ * Minimum tile size
+ */
+const int CvFFTConvolution::minTileSize = 64;
+
+/*
+ * Floating point type of the frequency path
+ */
+const int CvFFTConvolution::workType = CV_32FC1;
+
+/*
+ * Calibrated crossover size
+ */
+int CvFFTConvolution::crossoverSize = CvFFTConvolution::defaultCrossoverSize;
+
+/*
+ * Indicates crossover size has been calibrated
+ */
+bool CvFFTConvolution::calibrated = false;
+
+/*
+ * Lock protecting crossover size and calibration status which are
+ * shared by all engines (and lazily calibrated by the first
+ * AUTO_PATH convolution of any thread)
+ */
+Mutex CvFFTConvolution::calibrationLock;
+
+/*
+ * Convolution engine constructor
+ * @param kernel the convolution kernel (single channel)
+ * @param borderType border extrapolation type
+ * @param fftBackend FFT backend used in the frequency path
+ */
+CvFFTConvolution::CvFFTConvolution(const Mat & kernel,
+								   const int borderType,
+								   const CvFFTBackend::BackendType fftBackend) :
+	borderType(borderType),
+	path(AUTO_PATH),
+	fftBackend(CvFFTBackend::isAvailable(fftBackend) ?
+			   fftBackend : CvFFTBackend::OPENCV_BACKEND),
+	frameSize(0, 0),
+	kernelSize(0, 0),
+	dftSize(0, 0),
+	tileStep(0, 0),
+	nbTiles(0, 0),
+	kernelSpectrumValid(false),
+	nbStripes(0)
+{
+	if (!kernel.empty())
+	{
+		setKernel(kernel);
+	}
+}
+
+/*
+ * Convolution engine destructor
+ */
+CvFFTConvolution::~CvFFTConvolution()
+{
+	cleanupTiles();
+	kernelSpectrum.release();
+	result.release();
+	padded.release();
+	kernel.release();
+}
+
+/*
+ * Kernel read access
+ * @return the current kernel
+ */
+const Mat & CvFFTConvolution::getKernel() const
+{
+	return kernel;
+}
+
+/*
+ * Setting a new kernel: kernel spectrum will be computed again
+ * during next frequency path convolution
+ * @param kernel the new kernel (single channel)
+ */
+void CvFFTConvolution::setKernel(const Mat & kernel)
+{
+	CV_Assert(kernel.channels() == 1);
+
+	kernel.convertTo(this->kernel, workType);
+	kernelSpectrumValid = false;
+}
+
+/*
+ * Convolution path read access
+ * @return the current convolution path
+ */
+CvFFTConvolution::ConvolutionPath CvFFTConvolution::getPath() const
+{
+	return path;
+}
+
+/*
+ * Setting convolution path
+ * @param path the new convolution path
+ */
+void CvFFTConvolution::setPath(const ConvolutionPath path)
+{
+	if (path < NB_PATHS)
+	{
+		this->path = path;
+	}
+	else
+	{
+		cerr << "unknown convolution path " << path << endl;
+	}
+}
+
+/*
+ * Checks if current kernel is applied in the frequency domain
+ * according to current path (and calibrated crossover size in
+ * AUTO_PATH)
+ * @return true if frequency path is used
+ */
+bool CvFFTConvolution::isFrequencyPath() const
+{
+	switch (path)
+	{
+		case SPATIAL_PATH:
+			return false;
+		case FREQUENCY_PATH:
+			return true;
+		case AUTO_PATH:
+		default:
+		{
+			AutoLock lock(calibrationLock);
+			return sqrt((double) kernel.rows * (double) kernel.cols) >=
+				(double) crossoverSize;
+		}
+	}
+}
+
+/*
+ * Tiles DFT size read access
+ * @return the tiles DFT size of the last frequency path convolution
+ */
+const Size & CvFFTConvolution::getDftSize() const
+{
+	return dftSize;
+}
+
+/*
+ * Convolves (correlates as filter2D does) a frame with current kernel.
+ * Crossover size is calibrated first if needed in AUTO_PATH.
+ * @param src the source frame (any number of channels)
+ * @param dst the destination frame with the same size, depth and
+ * number of channels as the source frame
+ */
+void CvFFTConvolution::convolve(const Mat & src, Mat & dst)
+{
+	CV_Assert(!kernel.empty());
+
+	if (path == AUTO_PATH)
+	{
+		// calibration status is only read and written under lock
+		AutoLock lock(calibrationLock);
+		if (!calibrated)
+		{
+			measureCrossover(NULL, fftBackend);
+		}
+	}
+
+	if (!isFrequencyPath())
+	{
+		filter2D(src, dst, -1, kernel, Point(-1, -1), 0, borderType);
+		return;
+	}
+
+	setupTiles(src.size());
+
+	if (src.channels() == 1)
+	{
+		convolveChannel(src, dst);
+	}
+	else
+	{
+		vector<Mat> srcChannels;
+		vector<Mat> dstChannels(src.channels());
+		split(src, srcChannels);
+		for (int c = 0; c < src.channels(); c++)
+		{
+			convolveChannel(srcChannels[c], dstChannels[c]);
+		}
+		merge(dstChannels, dst);
+	}
+}
+
+/*
+ * Calibrated crossover size read access
+ * @return the kernel size above which frequency path is used in
+ * AUTO_PATH
+ */
+int CvFFTConvolution::getCrossoverSize()
+{
+	AutoLock lock(calibrationLock);
+	return crossoverSize;
+}
+
+/*
+ * Calibration status
+ * @return true if crossover size has been calibrated
+ */
+bool CvFFTConvolution::isCalibrated()
+{
+	AutoLock lock(calibrationLock);
+	return calibrated;
+}
+
+/*
+ * Calibrates crossover size by timing spatial and frequency paths
+ * with square box kernels of increasing sizes on a VGA frame.
+ * @param out stream to print timings to or NULL
+ * @param fftBackend FFT backend used in the frequency path
+ */
+void CvFFTConvolution::calibrate(ostream * out,
+								 const CvFFTBackend::BackendType fftBackend)
+{
+	AutoLock lock(calibrationLock);
+	measureCrossover(out, fftBackend);
+}
+
+/*
+ * Measures crossover size (performs #calibrate without locking
+ * calibrationLock which should already be locked by the caller)
+ * @param out stream to print timings to or NULL
+ * @param fftBackend FFT backend used in the frequency path
+ */
+void CvFFTConvolution::measureCrossover(ostream * out,
+										const CvFFTBackend::BackendType fftBackend)
+{
+	const int kernelSizes[] = {3, 5, 7, 9, 11, 15, 21, 31, 41, 51, 63};
+	const int nbKernelSizes = sizeof(kernelSizes) / sizeof(int);
+	const int iterations = 5;
+	double tickPeriod = 1000.0 / getTickFrequency(); // in ms
+
+	Mat frame(480, 640, CV_8UC1);
+	Mat filtered;
+	randu(frame, Scalar::all(0), Scalar::all(256));
+
+	if (out != NULL)
+	{
+		*out << "Convolution calibration: mean spatial and frequency times "
+			 << "(ms)" << endl;
+		*out << setw(8) << "kernel" << setw(10) << "spatial"
+			 << setw(12) << "frequency" << endl;
+	}
+
+	int crossover = INT_MAX;
+	for (int s = 0; s < nbKernelSizes; s++)
+	{
+		int k = kernelSizes[s];
+		Mat box = Mat::ones(k, k, CV_32FC1) / (double) (k * k);
+		double times[2];
+
+		for (int p = 0; p < 2; p++)
+		{
+			CvFFTConvolution engine(box, BORDER_REFLECT_101, fftBackend);
+			engine.setPath(p == 0 ? SPATIAL_PATH : FREQUENCY_PATH);
+
+			// warm up: plans and kernel spectrum
+			engine.convolve(frame, filtered);
+
+			int64 start = getTickCount();
+			for (int i = 0; i < iterations; i++)
+			{
+				engine.convolve(frame, filtered);
+			}
+			times[p] = (getTickCount() - start) * tickPeriod /
+				(double) iterations;
+		}
+
+		if (out != NULL)
+		{
+			*out << setw(8) << k
+				 << setw(10) << fixed << setprecision(3) << times[0]
+				 << setw(12) << fixed << setprecision(3) << times[1] << endl;
+		}
+
+		if (times[1] < times[0])
+		{
+			crossover = k;
+			break;
+		}
+	}
+
+	crossoverSize = crossover;
+	calibrated = true;
+
+	if (out != NULL)
+	{
+		if (crossoverSize < INT_MAX)
+		{
+			*out << "frequency path used for kernels from " << crossoverSize
+				 << "x" << crossoverSize << endl;
+		}
+		else
+		{
+			*out << "spatial path is always faster" << endl;
+		}
+	}
+}
+
+/*
+ * Checks frequency path accuracy against filter2D on a floating
+ * point VGA frame with random kernels of odd and even sizes for
+ * each border type supported by filter2D and prints max absolute
+ * errors.
+ * @param out the stream to print errors on
+ */
+void CvFFTConvolution::checkAccuracy(ostream & out)
+{
+	const int kernelSizes[] = {15, 16, 31, 32};
+	const int nbKernelSizes = sizeof(kernelSizes) / sizeof(int);
+	const int borderTypes[] = {BORDER_CONSTANT, BORDER_REPLICATE,
+							   BORDER_REFLECT, BORDER_REFLECT_101};
+	const char * borderNames[] = {"constant", "replicate", "reflect",
+								  "reflect 101"};
+	const int nbBorderTypes = sizeof(borderTypes) / sizeof(int);
+
+	Mat frame(480, 640, CV_32FC1);
+	Mat expected;
+	Mat filtered;
+	randu(frame, Scalar::all(0), Scalar::all(256));
+
+	out << "Frequency path max absolute error vs filter2D (values in "
+		<< "[0..256])" << endl;
+	out << setw(12) << "border";
+	for (int s = 0; s < nbKernelSizes; s++)
+	{
+		out << setw(7) << kernelSizes[s] << "x" << setw(2) << left
+			<< kernelSizes[s] << right;
+	}
+	out << endl;
+
+	for (int b = 0; b < nbBorderTypes; b++)
+	{
+		out << setw(12) << borderNames[b];
+		for (int s = 0; s < nbKernelSizes; s++)
+		{
+			int k = kernelSizes[s];
+			Mat kernel(k, k, CV_32FC1);
+			randu(kernel, Scalar::all(0), Scalar::all(1));
+			kernel /= sum(kernel)[0];
+
+			CvFFTConvolution engine(kernel, borderTypes[b]);
+			engine.setPath(FREQUENCY_PATH);
+			engine.convolve(frame, filtered);
+
+			filter2D(frame, expected, -1, kernel, Point(-1, -1), 0,
+					 borderTypes[b]);
+
+			out << setw(10) << scientific << setprecision(2)
+				<< norm(filtered, expected, NORM_INF);
+		}
+		out << endl;
+	}
+}
+
+/*
+ * Sets up tiles, stripes buffers and stripes FFT backends for a
+ * frame size and current kernel size (only performed when frame
+ * size or kernel size have changed)
+ * @param frameSize the frame size
+ */
+void CvFFTConvolution::setupTiles(const Size & frameSize)
+{
+	if ((frameSize == this->frameSize) && (kernel.size() == kernelSize))
+	{
+		return;
+	}
+
+	cleanupTiles();
+
+	this->frameSize = frameSize;
+	kernelSize = kernel.size();
+
+	/*
+	 * Tiles of optimal DFT size about 4 times the kernel size (or enough
+	 * to contain the whole padded frame): each tile produces
+	 * dftSize - kernelSize + 1 valid outputs
+	 */
+	Size previousDftSize(dftSize);
+	dftSize.width = getOptimalDFTSize(MIN(frameSize.width + kernelSize.width - 1,
+										  MAX(4 * kernelSize.width,
+											  minTileSize)));
+	dftSize.height = getOptimalDFTSize(MIN(frameSize.height + kernelSize.height - 1,
+										   MAX(4 * kernelSize.height,
+											   minTileSize)));
+	tileStep.width = dftSize.width - kernelSize.width + 1;
+	tileStep.height = dftSize.height - kernelSize.height + 1;
+	nbTiles.width = (frameSize.width + tileStep.width - 1) / tileStep.width;
+	nbTiles.height = (frameSize.height + tileStep.height - 1) /
+		tileStep.height;
+
+	if (dftSize != previousDftSize)
+	{
+		kernelSpectrumValid = false;
+	}
+
+	// One stripe of tiles per thread
+	nbStripes = MIN(MAX(getNumThreads(), 1), nbTiles.area());
+
+	for (int s = 0; s < nbStripes; s++)
+	{
+		CvFFTBackend * fft = CvFFTBackend::create(fftBackend);
+		fft->plan(dftSize, workType);
+		stripesFFT.push_back(fft);
+		stripesSpectrum.push_back(Mat(dftSize, workType));
+		stripesProduct.push_back(Mat(dftSize, workType));
+		stripesInverse.push_back(Mat(dftSize, workType));
+	}
+
+	result.create(frameSize, workType);
+}
+
+/*
+ * Deletes stripes FFT backends and releases stripes buffers
+ */
+void CvFFTConvolution::cleanupTiles()
+{
+	for (size_t s = 0; s < stripesFFT.size(); s++)
+	{
+		delete stripesFFT[s];
+		stripesInverse[s].release();
+		stripesProduct[s].release();
+		stripesSpectrum[s].release();
+	}
+
+	stripesInverse.clear();
+	stripesProduct.clear();
+	stripesSpectrum.clear();
+	stripesFFT.clear();
+	nbStripes = 0;
+}
+
+/*
+ * Computes kernel spectrum for current dftSize
+ */
+void CvFFTConvolution::computeKernelSpectrum()
+{
+	// kernel in the top left corner of a zero DFT sized image
+	Mat paddedKernel = Mat::zeros(dftSize, workType);
+	kernel.copyTo(paddedKernel(Rect(Point(0, 0), kernel.size())));
+
+	stripesFFT[0]->forward(paddedKernel, kernelSpectrum);
+
+	kernelSpectrumValid = true;
+}
+
+/*
+ * Parallel loop body processing tiles stripes with #processTile:
+ * stripe s processes tiles s, s + nbStripes, s + 2 * nbStripes, ...
+ * with its own buffers and FFT backend
+ */
+class CvFFTConvolution::TileProcessor : public ParallelLoopBody
+{
+	private:
+		/**
+		 * The convolution engine whose tiles are processed
+		 */
+		CvFFTConvolution * engine;
+
+	public:
+		/**
+		 * Tile processor constructor
+		 * @param engine the convolution engine whose tiles are processed
+		 */
+		TileProcessor(CvFFTConvolution * engine) :
+			engine(engine)
+		{
+		}
+
+		/**
+		 * Processes tiles of a range of stripes
+		 * @param range the range of stripes to process
+		 */
+		virtual void operator()(const Range & range) const
+		{
+			const int tiles = engine->nbTiles.area();
+			for (int s = range.start; s < range.end; s++)
+			{
+				for (int t = s; t < tiles; t += engine->nbStripes)
+				{
+					engine->processTile(t, s);
+				}
+			}
+		}
+};
+
+/*
+ * Convolves a single channel in the frequency domain
+ * @param src the source channel
+ * @param dst the destination channel (same depth as source)
+ */
+void CvFFTConvolution::convolveChannel(const Mat & src, Mat & dst)
+{
+	if (!kernelSpectrumValid)
+	{
+		computeKernelSpectrum();
+	}
+
+	/*
+	 * Pad source channel with kernel anchor borders and extend it to
+	 * cover whole tiles: tile (tx, ty) reads padded region starting at
+	 * (tx * tileStep.width, ty * tileStep.height) of dftSize
+	 */
+	Point anchor(kernelSize.width / 2, kernelSize.height / 2);
+	Size paddedSize(nbTiles.width * tileStep.width + kernelSize.width - 1,
+					nbTiles.height * tileStep.height + kernelSize.height - 1);
+
+	Mat source;
+	src.convertTo(source, workType);
+	copyMakeBorder(source,
+				   padded,
+				   anchor.y,
+				   paddedSize.height - frameSize.height - anchor.y,
+				   anchor.x,
+				   paddedSize.width - frameSize.width - anchor.x,
+				   borderType);
+
+	parallel_for_(Range(0, nbStripes),
+				  TileProcessor(this),
+				  (double) nbStripes);
+
+	result.convertTo(dst, src.depth());
+}
+
+/*
+ * Filters one tile of the padded channel into result: the circular
+ * correlation of the tile with the kernel (tile spectrum multiplied by
+ * conjugated kernel spectrum) is valid on its first tileStep outputs
+ * @param tile the tile index
+ * @param stripe the stripe index (whose buffers and backend are used)
+ */
+void CvFFTConvolution::processTile(const int tile, const int stripe)
+{
+	Point origin((tile % nbTiles.width) * tileStep.width,
+				 (tile / nbTiles.width) * tileStep.height);
+
+	CvFFTBackend * fft = stripesFFT[stripe];
+
+	fft->forward(padded(Rect(origin, dftSize)), stripesSpectrum[stripe]);
+
+	mulSpectrums(stripesSpectrum[stripe],
+				 kernelSpectrum,
+				 stripesProduct[stripe],
+				 0,
+				 true);
+
+	fft->inverse(stripesProduct[stripe], stripesInverse[stripe]);
+
+	// Valid outputs of this tile within frame
+	Rect output = Rect(origin, tileStep) & Rect(Point(0, 0), frameSize);
+
+	stripesInverse[stripe](Rect(Point(0, 0), output.size()))
+		.copyTo(result(output));
+}
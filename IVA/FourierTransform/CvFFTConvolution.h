@@ -0,0 +1,339 @@
+/*
+ * CvFFTConvolution.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#ifndef CVFFTCONVOLUTION_H_
+#define CVFFTCONVOLUTION_H_
+
+#include <vector>
+#include <iostream>
+using namespace std;
+
+#include <cv.h>
+using namespace cv;
+
+#include "CvFFTBackend.h"
+
+/**
+ * Large kernel convolution engine: filters full frames with arbitrary
+ * kernels (large gaussians, custom PSFs, ...) with the same results as
+ * filter2D (correlation with the kernel centered on each pixel).
+ * Small kernels are applied in the spatial domain (filter2D) and large
+ * kernels in the frequency domain with overlap-save: the padded frame is
+ * split into overlapping tiles of optimal DFT size, each tile spectrum is
+ * multiplied with the (cached) kernel spectrum and the valid part of each
+ * inverse tile is copied to the output. Tiles are processed in parallel.
+ * The kernel size above which the frequency path is faster is measured by
+ * #calibrate which is called by the first AUTO_PATH convolution (unless it
+ * has already been called).
+ */
+class CvFFTConvolution
+{
+	public:
+		/**
+		 * Convolution path
+		 */
+		typedef enum
+		{
+			/**
+			 * Spatial or frequency path chosen according to kernel size and
+			 * calibrated crossover size
+			 */
+			AUTO_PATH = 0,
+			/**
+			 * Spatial path (filter2D)
+			 */
+			SPATIAL_PATH,
+			/**
+			 * Frequency path (overlap-save)
+			 */
+			FREQUENCY_PATH,
+			/**
+			 * Number of convolution paths
+			 */
+			NB_PATHS
+		} ConvolutionPath;
+
+		/**
+		 * Crossover kernel size used when no calibration has been performed
+		 */
+		static const int defaultCrossoverSize;
+
+		/**
+		 * Minimum tile size (tiles are at least 4 times the kernel size)
+		 */
+		static const int minTileSize;
+
+	protected:
+		/**
+		 * Floating point type of the frequency path
+		 */
+		static const int workType;
+
+		/**
+		 * Calibrated kernel size (square root of kernel area) above which
+		 * the frequency path is faster than the spatial path
+		 */
+		static int crossoverSize;
+
+		/**
+		 * Indicates crossover size has been calibrated
+		 */
+		static bool calibrated;
+
+		/**
+		 * Lock protecting crossover size and calibration status which are
+		 * shared by all engines (and lazily calibrated by the first
+		 * AUTO_PATH convolution of any thread)
+		 */
+		static Mutex calibrationLock;
+
+		/**
+		 * Convolution kernel: workType
+		 */
+		Mat kernel;
+
+		/**
+		 * Border extrapolation type [default value is BORDER_REFLECT_101]
+		 */
+		int borderType;
+
+		/**
+		 * Convolution path [default value is AUTO_PATH]
+		 */
+		ConvolutionPath path;
+
+		/**
+		 * FFT backend used in the frequency path
+		 */
+		CvFFTBackend::BackendType fftBackend;
+
+		/**
+		 * Frame size tiles have been set up for
+		 */
+		Size frameSize;
+
+		/**
+		 * Kernel size tiles have been set up for
+		 */
+		Size kernelSize;
+
+		/**
+		 * Tiles DFT size
+		 */
+		Size dftSize;
+
+		/**
+		 * Valid output size of each tile:
+		 * dftSize - kernelSize + (1, 1)
+		 */
+		Size tileStep;
+
+		/**
+		 * Number of tiles in each direction
+		 */
+		Size nbTiles;
+
+		/**
+		 * Padded frame channel: workType
+		 */
+		Mat padded;
+
+		/**
+		 * Output frame channel: workType
+		 */
+		Mat result;
+
+		/**
+		 * Kernel packed (CCS) spectrum of dftSize: workType
+		 */
+		Mat kernelSpectrum;
+
+		/**
+		 * Indicates kernel spectrum is up to date with kernel and dftSize
+		 */
+		bool kernelSpectrumValid;
+
+		/**
+		 * Number of tiles stripes processed concurrently
+		 */
+		int nbStripes;
+
+		/**
+		 * FFT backends of each stripe (planned for dftSize)
+		 */
+		vector<CvFFTBackend *> stripesFFT;
+
+		/**
+		 * Tile spectrum of each stripe
+		 */
+		vector<Mat> stripesSpectrum;
+
+		/**
+		 * Filtered tile spectrum of each stripe
+		 */
+		vector<Mat> stripesProduct;
+
+		/**
+		 * Inverse filtered tile of each stripe
+		 */
+		vector<Mat> stripesInverse;
+
+	public:
+		/**
+		 * Convolution engine constructor
+		 * @param kernel the convolution kernel (single channel)
+		 * @param borderType border extrapolation type
+		 * @param fftBackend FFT backend used in the frequency path
+		 */
+		CvFFTConvolution(const Mat & kernel = Mat(),
+						 const int borderType = BORDER_REFLECT_101,
+						 const CvFFTBackend::BackendType fftBackend =
+							 (CvFFTBackend::isAvailable(
+								 CvFFTBackend::FFTW_BACKEND) ?
+							  CvFFTBackend::FFTW_BACKEND :
+							  CvFFTBackend::OPENCV_BACKEND));
+
+		/**
+		 * Convolution engine destructor
+		 */
+		virtual ~CvFFTConvolution();
+
+		/**
+		 * Kernel read access
+		 * @return the current kernel
+		 */
+		const Mat & getKernel() const;
+
+		/**
+		 * Setting a new kernel: kernel spectrum will be computed again
+		 * during next frequency path convolution
+		 * @param kernel the new kernel (single channel)
+		 */
+		void setKernel(const Mat & kernel);
+
+		/**
+		 * Convolution path read access
+		 * @return the current convolution path
+		 */
+		ConvolutionPath getPath() const;
+
+		/**
+		 * Setting convolution path
+		 * @param path the new convolution path
+		 */
+		void setPath(const ConvolutionPath path);
+
+		/**
+		 * Checks if current kernel is applied in the frequency domain
+		 * according to current path (and calibrated crossover size in
+		 * AUTO_PATH)
+		 * @return true if frequency path is used
+		 */
+		bool isFrequencyPath() const;
+
+		/**
+		 * Tiles DFT size read access
+		 * @return the tiles DFT size of the last frequency path convolution
+		 */
+		const Size & getDftSize() const;
+
+		/**
+		 * Convolves (correlates as filter2D does) a frame with current kernel.
+		 * Crossover size is calibrated first if needed in AUTO_PATH.
+		 * @param src the source frame (any number of channels)
+		 * @param dst the destination frame with the same size, depth and
+		 * number of channels as the source frame
+		 */
+		void convolve(const Mat & src, Mat & dst);
+
+		/**
+		 * Calibrated crossover size read access
+		 * @return the kernel size above which frequency path is used in
+		 * AUTO_PATH
+		 */
+		static int getCrossoverSize();
+
+		/**
+		 * Calibration status
+		 * @return true if crossover size has been calibrated
+		 */
+		static bool isCalibrated();
+
+		/**
+		 * Calibrates crossover size by timing spatial and frequency paths
+		 * with square box kernels of increasing sizes on a VGA frame.
+		 * @param out stream to print timings to or NULL
+		 * @param fftBackend FFT backend used in the frequency path
+		 * @note performed lazily (with the engine's FFT backend) by the
+		 * first AUTO_PATH convolution, so it only needs to be called
+		 * explicitly to print timings
+		 */
+		static void calibrate(ostream * out = NULL,
+							  const CvFFTBackend::BackendType fftBackend =
+								  (CvFFTBackend::isAvailable(
+									  CvFFTBackend::FFTW_BACKEND) ?
+								   CvFFTBackend::FFTW_BACKEND :
+								   CvFFTBackend::OPENCV_BACKEND));
+
+		/**
+		 * Checks frequency path accuracy against filter2D on a floating
+		 * point VGA frame with random kernels of odd and even sizes for
+		 * each border type supported by filter2D and prints max absolute
+		 * errors.
+		 * @param out the stream to print errors on
+		 */
+		static void checkAccuracy(ostream & out);
+
+	protected:
+		/**
+		 * Measures crossover size (performs #calibrate without locking
+		 * calibrationLock which should already be locked by the caller)
+		 * @param out stream to print timings to or NULL
+		 * @param fftBackend FFT backend used in the frequency path
+		 */
+		static void measureCrossover(ostream * out,
+									 const CvFFTBackend::BackendType fftBackend);
+
+		/**
+		 * Sets up tiles, stripes buffers and stripes FFT backends for a
+		 * frame size and current kernel size (only performed when frame
+		 * size or kernel size have changed)
+		 * @param frameSize the frame size
+		 */
+		void setupTiles(const Size & frameSize);
+
+		/**
+		 * Deletes stripes FFT backends and releases stripes buffers
+		 */
+		void cleanupTiles();
+
+		/**
+		 * Computes kernel spectrum for current dftSize
+		 */
+		void computeKernelSpectrum();
+
+		/**
+		 * Convolves a single channel in the frequency domain
+		 * @param src the source channel
+		 * @param dst the destination channel (same depth as source)
+		 */
+		void convolveChannel(const Mat & src, Mat & dst);
+
+		/**
+		 * Filters one tile of the padded channel into result
+		 * @param tile the tile index
+		 * @param stripe the stripe index (whose buffers and backend are used)
+		 */
+		void processTile(const int tile, const int stripe);
+
+		/**
+		 * Parallel loop body processing tiles stripes with #processTile
+		 */
+		class TileProcessor;
+};
+
+#endif /* CVFFTCONVOLUTION_H_ */
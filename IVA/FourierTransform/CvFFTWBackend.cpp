@@ -0,0 +1,397 @@
+/*
+ * CvFFTWBackend.cpp
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#include <cstring>	// for memcpy
+#include <cstdlib>	// for getenv
+
+#include "CvFFTWBackend.h"
+
+/*
+ * Double precision FFTW wisdom file name (relative to user's home
+ * directory)
+ */
+const char * CvFFTWBackend::wisdomFileName = ".fftw.wisdom";
+
+/*
+ * Single precision FFTW wisdom file name (relative to user's home
+ * directory)
+ */
+const char * CvFFTWBackend::wisdomFileNameF = ".fftwf.wisdom";
+
+/*
+ * FFTW planning flags
+ */
+const unsigned CvFFTWBackend::planFlags = FFTW_MEASURE;
+
+/*
+ * Indicates double precision wisdom has already been loaded
+ */
+bool CvFFTWBackend::wisdomLoaded = false;
+
+/*
+ * Indicates single precision wisdom has already been loaded
+ */
+bool CvFFTWBackend::wisdomLoadedF = false;
+
+/*
+ * FFTW backend constructor
+ */
+CvFFTWBackend::CvFFTWBackend() :
+	CvFFTBackend(),
+	realBuffer(NULL),
+	complexBuffer(NULL),
+	forwardPlan(NULL),
+	inversePlan(NULL),
+	forwardPlanF(NULL),
+	inversePlanF(NULL)
+{
+}
+
+/*
+ * FFTW backend destructor: destroys plans and buffers
+ */
+CvFFTWBackend::~CvFFTWBackend()
+{
+	destroyPlans();
+}
+
+/*
+ * Plans transforms of a new DFT size and type. Planning is only
+ * performed when size or type differs from current plan. Wisdom
+ * is loaded before first planning and saved after planning.
+ * @param size the DFT size
+ * @param type the DFT type: CV_32FC1 or CV_64FC1
+ */
+void CvFFTWBackend::plan(const Size & size, const int type)
+{
+	if ((realBuffer != NULL) && (size == this->size) && (type == this->type))
+	{
+		// already planned
+		return;
+	}
+
+	destroyPlans();
+	CvFFTBackend::plan(size, type);
+
+	const int rows = size.height;
+	const int cols = size.width;
+	size_t nbReals = (size_t) rows * cols;
+	size_t nbComplexes = (size_t) rows * (cols / 2 + 1);
+
+	if (type == CV_32FC1)
+	{
+		if (!wisdomLoadedF)
+		{
+			fftwf_import_wisdom_from_filename(
+				wisdomPath(wisdomFileNameF).c_str());
+			wisdomLoadedF = true;
+		}
+
+		realBuffer = fftwf_malloc(nbReals * sizeof(float));
+		complexBuffer = fftwf_malloc(nbComplexes * sizeof(fftwf_complex));
+		forwardPlanF = fftwf_plan_dft_r2c_2d(rows, cols,
+											 (float *) realBuffer,
+											 (fftwf_complex *) complexBuffer,
+											 planFlags);
+		inversePlanF = fftwf_plan_dft_c2r_2d(rows, cols,
+											 (fftwf_complex *) complexBuffer,
+											 (float *) realBuffer,
+											 planFlags);
+
+		fftwf_export_wisdom_to_filename(wisdomPath(wisdomFileNameF).c_str());
+	}
+	else
+	{
+		if (!wisdomLoaded)
+		{
+			fftw_import_wisdom_from_filename(
+				wisdomPath(wisdomFileName).c_str());
+			wisdomLoaded = true;
+		}
+
+		realBuffer = fftw_malloc(nbReals * sizeof(double));
+		complexBuffer = fftw_malloc(nbComplexes * sizeof(fftw_complex));
+		forwardPlan = fftw_plan_dft_r2c_2d(rows, cols,
+										   (double *) realBuffer,
+										   (fftw_complex *) complexBuffer,
+										   planFlags);
+		inversePlan = fftw_plan_dft_c2r_2d(rows, cols,
+										   (fftw_complex *) complexBuffer,
+										   (double *) realBuffer,
+										   planFlags);
+
+		fftw_export_wisdom_to_filename(wisdomPath(wisdomFileName).c_str());
+	}
+}
+
+/*
+ * Computes forward DFT of a real image into packed (CCS) spectrum
+ * @param src the real source image of planned size and type
+ * @param dst the packed spectrum
+ */
+void CvFFTWBackend::forward(const Mat & src, Mat & dst)
+{
+	CV_Assert(src.size() == size && src.type() == type);
+
+	dst.create(size, type);
+
+	if (type == CV_32FC1)
+	{
+		copyToBuffer<float>(src);
+		fftwf_execute(forwardPlanF);
+		packSpectrum<float>(dst);
+	}
+	else
+	{
+		copyToBuffer<double>(src);
+		fftw_execute(forwardPlan);
+		packSpectrum<double>(dst);
+	}
+}
+
+/*
+ * Computes scaled inverse DFT of a packed (CCS) spectrum into a
+ * real image
+ * @param src the packed spectrum of planned size and type
+ * @param dst the real image
+ */
+void CvFFTWBackend::inverse(const Mat & src, Mat & dst)
+{
+	CV_Assert(src.size() == size && src.type() == type);
+
+	dst.create(size, type);
+
+	double scale = 1.0 / ((double) size.width * (double) size.height);
+
+	// c2r plans overwrite their input which is unpacked every time anyway
+	if (type == CV_32FC1)
+	{
+		unpackSpectrum<float>(src);
+		fftwf_execute(inversePlanF);
+		copyFromBuffer<float>(dst, (float) scale);
+	}
+	else
+	{
+		unpackSpectrum<double>(src);
+		fftw_execute(inversePlan);
+		copyFromBuffer<double>(dst, scale);
+	}
+}
+
+/*
+ * Destroys current plans and buffers
+ */
+void CvFFTWBackend::destroyPlans()
+{
+	if (forwardPlan != NULL)
+	{
+		fftw_destroy_plan(forwardPlan);
+		forwardPlan = NULL;
+	}
+	if (inversePlan != NULL)
+	{
+		fftw_destroy_plan(inversePlan);
+		inversePlan = NULL;
+	}
+	if (forwardPlanF != NULL)
+	{
+		fftwf_destroy_plan(forwardPlanF);
+		forwardPlanF = NULL;
+	}
+	if (inversePlanF != NULL)
+	{
+		fftwf_destroy_plan(inversePlanF);
+		inversePlanF = NULL;
+	}
+
+	// buffers have been allocated according to current type
+	if (realBuffer != NULL)
+	{
+		if (type == CV_32FC1)
+		{
+			fftwf_free(realBuffer);
+		}
+		else
+		{
+			fftw_free(realBuffer);
+		}
+		realBuffer = NULL;
+	}
+	if (complexBuffer != NULL)
+	{
+		if (type == CV_32FC1)
+		{
+			fftwf_free(complexBuffer);
+		}
+		else
+		{
+			fftw_free(complexBuffer);
+		}
+		complexBuffer = NULL;
+	}
+}
+
+/*
+ * Builds the path of a wisdom file in user's home directory
+ * @param fileName the wisdom file name
+ * @return $HOME/fileName or fileName in current directory when HOME
+ * is not set
+ */
+string CvFFTWBackend::wisdomPath(const char * fileName)
+{
+	const char * home = getenv("HOME");
+
+	if ((home == NULL) || (home[0] == '\0'))
+	{
+		return string(fileName);
+	}
+
+	return string(home) + "/" + fileName;
+}
+
+/*
+ * Copies a real image into the real buffer
+ * @param src the real image
+ */
+template <typename T>
+void CvFFTWBackend::copyToBuffer(const Mat & src)
+{
+	T * buffer = (T *) realBuffer;
+	const size_t rowSize = src.cols * sizeof(T);
+
+	for (int i = 0; i < src.rows; i++)
+	{
+		memcpy(buffer + i * src.cols, src.ptr<T>(i), rowSize);
+	}
+}
+
+/*
+ * Copies the real buffer into a real image with a scale factor
+ * @param dst the real image
+ * @param scale the scale factor
+ */
+template <typename T>
+void CvFFTWBackend::copyFromBuffer(Mat & dst, const T scale)
+{
+	const T * buffer = (const T *) realBuffer;
+
+	for (int i = 0; i < dst.rows; i++)
+	{
+		const T * in = buffer + i * dst.cols;
+		T * out = dst.ptr<T>(i);
+		for (int j = 0; j < dst.cols; j++)
+		{
+			out[j] = in[j] * scale;
+		}
+	}
+}
+
+/*
+ * Converts the half complex buffer into a packed (CCS) spectrum
+ * 	- interior columns 2j-1 and 2j of each row u contain real and imaginary
+ * 	parts of X(u,j) for 0 < j < cols/2
+ * 	- first column (and last column when cols is even) contain X(u,0)
+ * 	(and X(u,cols/2)) for 0 <= u <= rows/2: X(0,.) real part in row 0,
+ * 	X(u,.) real and imaginary parts in rows 2u-1 and 2u and
+ * 	X(rows/2,.) real part in last row when rows is even
+ * @param packed the packed spectrum
+ */
+template <typename T>
+void CvFFTWBackend::packSpectrum(Mat & packed)
+{
+	const int rows = packed.rows;
+	const int cols = packed.cols;
+	const int halfCols = cols / 2 + 1;
+	// interleaved real and imaginary parts
+	const T * spectrum = (const T *) complexBuffer;
+
+	// Interior columns
+	for (int u = 0; u < rows; u++)
+	{
+		const T * in = spectrum + 2 * u * halfCols;
+		T * out = packed.ptr<T>(u);
+		for (int j = 1; 2 * j < cols; j++)
+		{
+			out[2 * j - 1] = in[2 * j];
+			out[2 * j] = in[2 * j + 1];
+		}
+	}
+
+	// First column and last column when cols is even
+	const int nbEdges = (cols % 2 == 0 ? 2 : 1);
+	for (int e = 0; e < nbEdges; e++)
+	{
+		const int c = (e == 0 ? 0 : cols / 2);
+		const int pc = (e == 0 ? 0 : cols - 1);
+
+		packed.at<T>(0, pc) = spectrum[2 * c];
+		for (int u = 1; 2 * u < rows; u++)
+		{
+			const T * value = spectrum + 2 * (u * halfCols + c);
+			packed.at<T>(2 * u - 1, pc) = value[0];
+			packed.at<T>(2 * u, pc) = value[1];
+		}
+		if (rows % 2 == 0)
+		{
+			packed.at<T>(rows - 1, pc) =
+				spectrum[2 * ((rows / 2) * halfCols + c)];
+		}
+	}
+}
+
+/*
+ * Converts a packed (CCS) spectrum into the half complex buffer: first
+ * (and last) columns values of rows above rows/2 are obtained by hermitian
+ * symmetry
+ * @param packed the packed spectrum
+ */
+template <typename T>
+void CvFFTWBackend::unpackSpectrum(const Mat & packed)
+{
+	const int rows = packed.rows;
+	const int cols = packed.cols;
+	const int halfCols = cols / 2 + 1;
+	// interleaved real and imaginary parts
+	T * spectrum = (T *) complexBuffer;
+
+	// Interior columns
+	for (int u = 0; u < rows; u++)
+	{
+		const T * in = packed.ptr<T>(u);
+		T * out = spectrum + 2 * u * halfCols;
+		for (int j = 1; 2 * j < cols; j++)
+		{
+			out[2 * j] = in[2 * j - 1];
+			out[2 * j + 1] = in[2 * j];
+		}
+	}
+
+	// First column and last column when cols is even
+	const int nbEdges = (cols % 2 == 0 ? 2 : 1);
+	for (int e = 0; e < nbEdges; e++)
+	{
+		const int c = (e == 0 ? 0 : cols / 2);
+		const int pc = (e == 0 ? 0 : cols - 1);
+
+		spectrum[2 * c] = packed.at<T>(0, pc);
+		spectrum[2 * c + 1] = (T) 0;
+		for (int u = 1; 2 * u < rows; u++)
+		{
+			T * value = spectrum + 2 * (u * halfCols + c);
+			T * mirror = spectrum + 2 * ((rows - u) * halfCols + c);
+			value[0] = mirror[0] = packed.at<T>(2 * u - 1, pc);
+			value[1] = packed.at<T>(2 * u, pc);
+			mirror[1] = -value[1];
+		}
+		if (rows % 2 == 0)
+		{
+			T * value = spectrum + 2 * ((rows / 2) * halfCols + c);
+			value[0] = packed.at<T>(rows - 1, pc);
+			value[1] = (T) 0;
+		}
+	}
+}
@@ -0,0 +1,169 @@
+/*
+ * CvFFTWBackend.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#ifndef CVFFTWBACKEND_H_
+#define CVFFTWBACKEND_H_
+
+#include <string>
+using namespace std;
+
+#include <fftw3.h>
+
+#include "CvFFTBackend.h"
+
+/**
+ * FFT backend using FFTW real to complex (and complex to real) plans.
+ * Plans are measured (FFTW_MEASURE) once per DFT size and type, and FFTW
+ * wisdom is loaded from and saved to disk so that measuring is only
+ * performed once for each size across program runs. Wisdom files are
+ * stored in the user's home directory ($HOME/.fftw.wisdom and
+ * $HOME/.fftwf.wisdom) or in the current directory when HOME is not set.
+ * FFTW half complex spectrums are converted to and from packed (CCS)
+ * spectrums so this backend is interchangeable with the OpenCV backend.
+ * @note Only available when built with HAVE_FFTW
+ */
+class CvFFTWBackend : public CvFFTBackend
+{
+	public:
+		/**
+		 * Double precision FFTW wisdom file name (relative to user's home
+		 * directory)
+		 */
+		static const char * wisdomFileName;
+
+		/**
+		 * Single precision FFTW wisdom file name (relative to user's home
+		 * directory)
+		 */
+		static const char * wisdomFileNameF;
+
+	protected:
+		/**
+		 * FFTW planning flags [default value is FFTW_MEASURE]
+		 */
+		static const unsigned planFlags;
+
+		/**
+		 * Indicates double precision wisdom has already been loaded
+		 */
+		static bool wisdomLoaded;
+
+		/**
+		 * Indicates single precision wisdom has already been loaded
+		 */
+		static bool wisdomLoadedF;
+
+		/**
+		 * Real buffer (rows * cols reals) aligned by FFTW
+		 */
+		void * realBuffer;
+
+		/**
+		 * Half complex buffer (rows * (cols/2 + 1) complexes) aligned by FFTW
+		 */
+		void * complexBuffer;
+
+		/**
+		 * Double precision forward plan (real to half complex)
+		 */
+		fftw_plan forwardPlan;
+
+		/**
+		 * Double precision inverse plan (half complex to real)
+		 */
+		fftw_plan inversePlan;
+
+		/**
+		 * Single precision forward plan (real to half complex)
+		 */
+		fftwf_plan forwardPlanF;
+
+		/**
+		 * Single precision inverse plan (half complex to real)
+		 */
+		fftwf_plan inversePlanF;
+
+	public:
+		/**
+		 * FFTW backend constructor
+		 */
+		CvFFTWBackend();
+
+		/**
+		 * FFTW backend destructor: destroys plans and buffers
+		 */
+		virtual ~CvFFTWBackend();
+
+		/**
+		 * Plans transforms of a new DFT size and type. Planning is only
+		 * performed when size or type differs from current plan. Wisdom
+		 * is loaded before first planning and saved after planning.
+		 * @param size the DFT size
+		 * @param type the DFT type: CV_32FC1 or CV_64FC1
+		 */
+		virtual void plan(const Size & size, const int type);
+
+		/**
+		 * Computes forward DFT of a real image into packed (CCS) spectrum
+		 * @param src the real source image of planned size and type
+		 * @param dst the packed spectrum
+		 */
+		virtual void forward(const Mat & src, Mat & dst);
+
+		/**
+		 * Computes scaled inverse DFT of a packed (CCS) spectrum into a
+		 * real image
+		 * @param src the packed spectrum of planned size and type
+		 * @param dst the real image
+		 */
+		virtual void inverse(const Mat & src, Mat & dst);
+
+	protected:
+		/**
+		 * Destroys current plans and buffers
+		 */
+		void destroyPlans();
+
+		/**
+		 * Builds the path of a wisdom file in user's home directory
+		 * @param fileName the wisdom file name
+		 * @return $HOME/fileName or fileName in current directory when HOME
+		 * is not set
+		 */
+		static string wisdomPath(const char * fileName);
+
+		/**
+		 * Copies a real image into the real buffer
+		 * @param src the real image
+		 */
+		template <typename T>
+		void copyToBuffer(const Mat & src);
+
+		/**
+		 * Copies the real buffer into a real image with a scale factor
+		 * @param dst the real image
+		 * @param scale the scale factor
+		 */
+		template <typename T>
+		void copyFromBuffer(Mat & dst, const T scale);
+
+		/**
+		 * Converts the half complex buffer into a packed (CCS) spectrum
+		 * @param packed the packed spectrum
+		 */
+		template <typename T>
+		void packSpectrum(Mat & packed);
+
+		/**
+		 * Converts a packed (CCS) spectrum into the half complex buffer
+		 * @param packed the packed spectrum
+		 */
+		template <typename T>
+		void unpackSpectrum(const Mat & packed);
+};
+
+#endif /* CVFFTWBACKEND_H_ */
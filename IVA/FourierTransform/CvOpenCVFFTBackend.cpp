@@ -0,0 +1,45 @@
+/*
+ * CvOpenCVFFTBackend.cpp
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#include "CvOpenCVFFTBackend.h"
+
+/*
+ * OpenCV FFT backend constructor
+ */
+CvOpenCVFFTBackend::CvOpenCVFFTBackend() :
+	CvFFTBackend()
+{
+}
+
+/*
+ * OpenCV FFT backend destructor
+ */
+CvOpenCVFFTBackend::~CvOpenCVFFTBackend()
+{
+}
+
+/*
+ * Computes forward DFT of a real image into packed (CCS) spectrum
+ * with cv::dft
+ * @param src the real source image of planned size and type
+ * @param dst the packed spectrum
+ */
+void CvOpenCVFFTBackend::forward(const Mat & src, Mat & dst)
+{
+	dft(src, dst);
+}
+
+/*
+ * Computes scaled inverse DFT of a packed (CCS) spectrum into a
+ * real image with cv::idft (DFT_REAL_OUTPUT + DFT_SCALE)
+ * @param src the packed spectrum of planned size and type
+ * @param dst the real image
+ */
+void CvOpenCVFFTBackend::inverse(const Mat & src, Mat & dst)
+{
+	idft(src, dst, DFT_REAL_OUTPUT + DFT_SCALE);
+}
@@ -0,0 +1,48 @@
+/*
+ * CvOpenCVFFTBackend.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#ifndef CVOPENCVFFTBACKEND_H_
+#define CVOPENCVFFTBACKEND_H_
+
+#include "CvFFTBackend.h"
+
+/**
+ * Default FFT backend using OpenCV cv::dft and cv::idft.
+ * @note OpenCV does not expose its DFT plans so planning only records
+ * DFT size and type
+ */
+class CvOpenCVFFTBackend : public CvFFTBackend
+{
+	public:
+		/**
+		 * OpenCV FFT backend constructor
+		 */
+		CvOpenCVFFTBackend();
+
+		/**
+		 * OpenCV FFT backend destructor
+		 */
+		virtual ~CvOpenCVFFTBackend();
+
+		/**
+		 * Computes forward DFT of a real image into packed (CCS) spectrum
+		 * with cv::dft
+		 * @param src the real source image of planned size and type
+		 * @param dst the packed spectrum
+		 */
+		virtual void forward(const Mat & src, Mat & dst);
+
+		/**
+		 * Computes scaled inverse DFT of a packed (CCS) spectrum into a
+		 * real image with cv::idft (DFT_REAL_OUTPUT + DFT_SCALE)
+		 * @param src the packed spectrum of planned size and type
+		 * @param dst the real image
+		 */
+		virtual void inverse(const Mat & src, Mat & dst);
+};
+
+#endif /* CVOPENCVFFTBACKEND_H_ */
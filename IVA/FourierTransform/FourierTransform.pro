@@ -22,6 +22,9 @@ MODULES = CvProcessor \
 	QcvProcessor \
 	CvDFT \
 	QcvDFT \
+	CvFFTBackend \
+	CvOpenCVFFTBackend \
+	CvFFTConvolution \
 	matWidgets/QcvMatWidget \
 	matWidgets/QcvMatWidgetLabel \
 	matWidgets/QcvMatWidgetImage \
@@ -31,6 +34,15 @@ MODULES = CvProcessor \
 	capture/CaptureFactory \
 	utils/MeanValue \
 	mainwindow
+
+# Optional FFTW backend
+packagesExist(fftw3 fftw3f) {
+	DEFINES += HAVE_FFTW
+	PKGCONFIG += fftw3 fftw3f
+	MODULES += CvFFTWBackend
+	message(FFTW found: FFTW backend enabled)
+}
+
 for(f, MODULES){
 	HEADERS += $${f}.h
 	SOURCES += $${f}.cpp
@@ -212,6 +212,181 @@ void QcvDFT::setFiltering(bool filtering)
 	emit sendMessage(message, defaultTimeOut);
 }
 
+/*
+ * Setting spectral pipeline precision with notification
+ * @param singlePrecision the new precision status: true for single
+ * precision (float) and false for double precision
+ */
+void QcvDFT::setSinglePrecision(const bool singlePrecision)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvDFT::setSinglePrecision(singlePrecision);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+
+	message.append(tr("spectral pipeline precision is "));
+
+	if (singlePrecision)
+	{
+		message.append(tr("single (float)"));
+	}
+	else
+	{
+		message.append(tr("double"));
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Setting channels parallel processing status with notification
+ * @param parallelChannels the new channels parallel processing
+ * status
+ */
+void QcvDFT::setParallelChannels(const bool parallelChannels)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvDFT::setParallelChannels(parallelChannels);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+
+	message.append(tr("parallel channels processing is "));
+
+	if (parallelChannels)
+	{
+		message.append(tr("on"));
+	}
+	else
+	{
+		message.append(tr("off"));
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Setting frame mode with notification: attributes are set up again
+ * and reallocated images are signaled
+ * @param frameMode the new frame mode
+ */
+void QcvDFT::setFrameMode(const FrameMode frameMode)
+{
+	Size previousDftSize(dftSize);
+	FrameMode previousFrameMode = this->frameMode;
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvDFT::setFrameMode(frameMode);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	emit squareImageChanged(&inFrameSquare);
+
+	emit spectrumImageChanged(&spectrumMagnitudeImage);
+
+	emit inverseImageChanged(&inverseImage);
+
+	/*
+	 * Changing frame mode re-setups processor from its source image, hence
+	 * attributes set up from UI need to be set again (only when mode has
+	 * really changed since UI setup also sets frame mode)
+	 */
+	if (previousFrameMode != this->frameMode)
+	{
+		emit imageChanged();
+	}
+
+	if ((previousDftSize.width != dftSize.width) ||
+		(previousDftSize.height != dftSize.height))
+	{
+		emit imageSizeChanged();
+		emit sendText(QString::number(optimalDFTSize));
+	}
+
+	message.clear();
+
+	message.append(tr("Frame mode set to "));
+
+	switch (this->frameMode)
+	{
+		case SQUARE_FRAME:
+			message.append(tr("center square"));
+			break;
+		case FULL_FRAME_ZERO:
+			message.append(tr("full frame with zero padding"));
+			break;
+		case FULL_FRAME_MIRROR:
+			message.append(tr("full frame with mirror padding"));
+			break;
+		default:
+			message.append(tr("unknown mode"));
+			break;
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Setting FFT backend with notification
+ * @param fftBackend the new FFT backend
+ */
+void QcvDFT::setFFTBackend(const CvFFTBackend::BackendType fftBackend)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvDFT::setFFTBackend(fftBackend);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+
+	if (this->fftBackend == fftBackend)
+	{
+		message.append(tr("FFT backend set to "));
+	}
+	else
+	{
+		message.append(tr("FFT backend unavailable, still using "));
+	}
+
+	message.append(tr(CvFFTBackend::BackendNames[this->fftBackend]));
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
 /*
  * Setting the log scale factor
  * @param logScaleFactor the new log scale factor
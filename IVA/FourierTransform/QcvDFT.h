@@ -73,6 +73,33 @@ class QcvDFT: public QcvProcessor, public CvDFT
 		 */
 		void setFiltering(bool filtering);
 
+		/**
+		 * Setting spectral pipeline precision with notification
+		 * @param singlePrecision the new precision status: true for single
+		 * precision (float) and false for double precision
+		 */
+		void setSinglePrecision(const bool singlePrecision);
+
+		/**
+		 * Setting channels parallel processing status with notification
+		 * @param parallelChannels the new channels parallel processing
+		 * status
+		 */
+		void setParallelChannels(const bool parallelChannels);
+
+		/**
+		 * Setting frame mode with notification: attributes are set up again
+		 * and reallocated images are signaled
+		 * @param frameMode the new frame mode
+		 */
+		void setFrameMode(const FrameMode frameMode);
+
+		/**
+		 * Setting FFT backend with notification
+		 * @param fftBackend the new FFT backend
+		 */
+		void setFFTBackend(const CvFFTBackend::BackendType fftBackend);
+
 		/**
 		 * Setting the log scale factor
 		 * @param logScaleFactor the new log scale factor
@@ -7,6 +7,8 @@ using namespace std;
 #include "QcvVideoCapture.h"
 #include "CaptureFactory.h"
 #include "QcvDFT.h"
+#include "CvFFTBackend.h"
+#include "CvFFTConvolution.h"
 #include "mainwindow.h"
 
 /**
@@ -27,6 +29,9 @@ void usage(char * name);
  * 	- mirror : mirrors image horizontally before display
  *	- size : [--size | -s] <width>x<height> resize capture to fit desired <width>
  *	and <height>
+ *	- benchmark : [--benchmark | -b] benchmarks available FFT backends,
+ *	convolution paths (and their accuracy) and DFT single precision then
+ *	exits
  */
 int main(int argc, char *argv[])
 {
@@ -42,6 +47,7 @@ int main(int argc, char *argv[])
 	QStringList argList = QCoreApplication::arguments();
 
 	int threadNumber = 3;
+	bool benchmark = false;
 	// parse arguments for --threads tag
 	for (QListIterator<QString> it(argList); it.hasNext(); )
 	{
@@ -91,6 +97,26 @@ int main(int argc, char *argv[])
 				verboseLevel = CvProcessor::VERBOSE_ACTIVITY;
 			}
 		}
+		else if (currentArg == "-b" || currentArg == "--benchmark")
+		{
+			benchmark = true;
+		}
+	}
+
+	// ------------------------------------------------------------------------
+	// Benchmark FFT backends, convolution paths (timings and accuracy) and
+	// DFT single precision then exit
+	// ------------------------------------------------------------------------
+	if (benchmark)
+	{
+		CvFFTBackend::benchmark(cout);
+		CvFFTConvolution::calibrate(&cout);
+		CvFFTConvolution::checkAccuracy(cout);
+
+		Mat image(480, 640, CV_8UC3);
+		randu(image, Scalar::all(0), Scalar::all(256));
+		CvDFT::benchmarkPrecision(&image, cout);
+		return 0;
 	}
 
 	// ------------------------------------------------------------------------
@@ -212,5 +238,6 @@ void usage(char * name)
 		 << "[-s | --size] <width>x<height> "
 		 << "[-m | --mirror]"
 		 << "[-t | --threads] <number of threads>"
+		 << "[-b | --benchmark]"
 		 << endl;
 }
@@ -165,6 +165,18 @@ MainWindow::MainWindow(QcvVideoCapture * capture,
 	// Setting up filtering checkbox
 	ui->checkBoxFiltering->setChecked(processor->isFiltering());
 
+	// Setting up precision checkbox
+	ui->checkBoxSinglePrecision->setChecked(processor->isSinglePrecision());
+
+	// Setting up parallel channels checkbox
+	ui->checkBoxParallelChannels->setChecked(processor->isParallelChannels());
+
+	// Setting up frame mode combobox
+	ui->comboBoxFrame->setCurrentIndex((int)processor->getFrameMode());
+
+	// Setting up FFT backend combobox
+	ui->comboBoxFFTBackend->setCurrentIndex((int)processor->getFFTBackend());
+
 	// Setting up filtering type
 	CvDFT::FilterType type = processor->getFilterType();
 	switch (type)
@@ -526,6 +538,15 @@ void MainWindow::setupProcessorFromUI()
 
 	processor->setFiltering(ui->checkBoxFiltering->isChecked());
 
+	processor->setSinglePrecision(ui->checkBoxSinglePrecision->isChecked());
+
+	processor->setParallelChannels(ui->checkBoxParallelChannels->isChecked());
+
+	processor->setFrameMode((CvDFT::FrameMode)ui->comboBoxFrame->currentIndex());
+
+	processor->setFFTBackend(
+		(CvFFTBackend::BackendType)ui->comboBoxFFTBackend->currentIndex());
+
 	processor->setLowPassFilterSize(CvDFT::BLUE, ui->spinBoxBlueLP->value());
 	processor->setLowPassFilterSize(CvDFT::GREEN, ui->spinBoxGreenLP->value());
 	processor->setLowPassFilterSize(CvDFT::RED, ui->spinBoxRedLP->value());
@@ -941,6 +962,47 @@ void MainWindow::on_checkBoxFiltering_clicked()
 	processor->setFiltering(ui->checkBoxFiltering->isChecked());
 }
 
+/*
+ * Sets spectral pipeline single precision on/off
+ */
+void MainWindow::on_checkBoxSinglePrecision_clicked()
+{
+	processor->setSinglePrecision(ui->checkBoxSinglePrecision->isChecked());
+}
+
+/*
+ * Sets concurrent channels processing on/off
+ */
+void MainWindow::on_checkBoxParallelChannels_clicked()
+{
+	processor->setParallelChannels(ui->checkBoxParallelChannels->isChecked());
+}
+
+/*
+ * Selects frame mode (center square or padded full frame)
+ * @param index the selected frame mode
+ */
+void MainWindow::on_comboBoxFrame_currentIndexChanged(int index)
+{
+	processor->setFrameMode((CvDFT::FrameMode)index);
+}
+
+/*
+ * Selects FFT backend (OpenCV or FFTW)
+ * @param index the selected FFT backend
+ */
+void MainWindow::on_comboBoxFFTBackend_currentIndexChanged(int index)
+{
+	processor->setFFTBackend((CvFFTBackend::BackendType)index);
+
+	// unavailable backends are ignored by processor
+	if (processor->getFFTBackend() != (CvFFTBackend::BackendType)index)
+	{
+		ui->comboBoxFFTBackend->setCurrentIndex(
+			(int)processor->getFFTBackend());
+	}
+}
+
 /*
  * Sets Filter mode to box
  */
@@ -294,6 +294,28 @@ class MainWindow : public QMainWindow
 		 */
 		void on_checkBoxFiltering_clicked();
 
+		/**
+		 * Sets spectral pipeline single precision on/off
+		 */
+		void on_checkBoxSinglePrecision_clicked();
+
+		/**
+		 * Sets concurrent channels processing on/off
+		 */
+		void on_checkBoxParallelChannels_clicked();
+
+		/**
+		 * Selects frame mode (center square or padded full frame)
+		 * @param index the selected frame mode
+		 */
+		void on_comboBoxFrame_currentIndexChanged(int index);
+
+		/**
+		 * Selects FFT backend (OpenCV or FFTW)
+		 * @param index the selected FFT backend
+		 */
+		void on_comboBoxFFTBackend_currentIndexChanged(int index);
+
 		/**
 		 * Sets Filter mode to box
 		 */
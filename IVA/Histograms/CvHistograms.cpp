@@ -5,31 +5,69 @@
  *      Author: David Roussel
  */
 #include <cmath>	// for powf function
+#include <cstring>	// for memset & memcpy
+#include <cstdint>	// for uint32_t
 #include <iostream> // for input / output streams
+#include <iomanip>	// for setw & setprecision
 #include <limits>   // for numeric limits (max value of type T)
+#include <map>		// for LUTs cache
 using namespace std;
 
+#include <opencv2/core/core.hpp>	// for parallel_for_
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include "CvHistograms.h"
 
 /*
- * Number of bins in the histogram.
- * All histogram populations ranges from 0 to bins-1
+ * Number of values of type T (256 for uchar, 65536 for 16 bits)
  */
 template <typename T, size_t channels>
-const size_t CvHistograms<T, channels>::bins = (size_t) powf(2, sizeof(T) * 8);
+const size_t CvHistograms<T, channels>::levels = (size_t) powf(2, sizeof(T) * 8);
+
+/*
+ * Default maximum number of bins (value is set in class declaration)
+ */
+template <typename T, size_t channels>
+const size_t CvHistograms<T, channels>::defaultBins;
+
+/*
+ * Maximum size of the LUT drawing frame (value is set in class declaration)
+ */
+template <typename T, size_t channels>
+const size_t CvHistograms<T, channels>::maxLutDrawSize;
+
+/*
+ * Maximum number of LUTs in the LUTs cache (value is set in class
+ * declaration)
+ */
+template <typename T, size_t channels>
+const size_t CvHistograms<T, channels>::maxCachedLUTs;
+
+/*
+ * Number of interleaved integer sub-histograms (banks) per channel
+ * used by the BANKED_KERNEL (value is set in class declaration)
+ */
+template <typename T, size_t channels>
+const size_t CvHistograms<T, channels>::nbBanks;
 
 /*
  * 3 coefficients for additionnal grayscale histogram from RGB image :
- * 	- \f$Coef_{red} = 0.30\f$
- * 	- \f$Coef_{green} = 0.59\f$
- * 	- \f$Coef_{blue} = 0.11\f$
+ * 	- \f$Coef_{red} = 0.299\f$
+ * 	- \f$Coef_{green} = 0.587\f$
+ * 	- \f$Coef_{blue} = 0.114\f$
+ * (the same as cvtColor(..., CV_BGR2GRAY))
  * @note Be aware that OpenCV Color images are ususally encoded in BGR
  * format instead of RGB.
  */
 template <typename T, size_t channels>
-const float CvHistograms<T, channels>::BGR2Gray[] = {0.11, 0.59, 0.30};
+const float CvHistograms<T, channels>::BGR2Gray[] = {0.114, 0.587, 0.299};
+
+/*
+ * Number of fractional bits of the fixed point luminance computation
+ * (value is set in class declaration)
+ */
+template <typename T, size_t channels>
+const int CvHistograms<T, channels>::grayShift;
 
 /*
  * Maximum percentage for LUTs that requires such a parameter
@@ -53,30 +91,58 @@ const float CvHistograms<T, channels>::minParam = 0.0;
  * @param drawWidth the drawing width of the histogram window
  * @param timeCumulation checks whether to compute time cumulative
  * histograms or not.
+ * @param nbBins the number of bins of each histogram: rounded down
+ * to a power of two and limited to the number of levels of T. 0
+ * uses all levels up to defaultBins.
  */
 template <typename T, size_t channels>
 CvHistograms<T, channels>::CvHistograms(Mat * image,
 										const bool computeGray,
 										const size_t drawHeight,
 										const size_t drawWidth,
-										const bool timeCumulation)
+										const bool timeCumulation,
+										const size_t nbBins)
 	: CvProcessor(image),
+	  bins(binsFor(nbBins)),
+	  binShift(shiftFor(bins)),
 	  computeGray(computeGray),
+	  grayTables(NULL),
 	  timeCumulative(timeCumulation),
-	  monoTransfertFunc(1, bins, CV_8UC1),
-	  colorTransferFunc(1, bins, CV_8UC(channels)),
+	  timeMode(TIME_UNBOUNDED),
+	  timeWindow(30),
+	  timeDecay(0.1),
+	  timeFrames(0),
+	  windowSums(NULL),
+	  kernel(BANKED_KERNEL),
+	  parallelThreads(1),
+	  transferBuffer(NULL),
+	  monoTransfertFunc(1, bins, CV_MAKETYPE(DataType<T>::depth, 1)),
+	  colorTransferFunc(1, bins, CV_MAKETYPE(DataType<T>::depth, channels)),
 	  lut(NULL),
 	  lutType(NONE),
 	  previousLutType(NBTRANS),
 	  lutParam(80.0),
 	  previousLutParam(80.0),
+	  lutTolerance(0.005),
+	  lutReference(NULL),
+	  localTilesX(8),
+	  localTilesY(8),
+	  localClipLimit(4.0),
+	  localTolerance(0.02),
+	  localRebuild(true),
+	  localCounts(NULL),
+	  localCachedCounts(NULL),
+	  localLUTs(NULL),
 	  showCumulative(false),
 	  histWidth(drawWidth),
 	  histHeight(drawHeight),
-	  lutWidth(bins),
-	  lutHeight(bins),
+	  lutWidth(bins < maxLutDrawSize ? bins : maxLutDrawSize),
+	  lutHeight(lutWidth),
 	  histDisplayFrame(drawHeight, drawWidth, CV_8UC(channels)),
-	  lutDisplayFrame(bins, bins, CV_8UC(channels)),
+	  renderer(RASTER_RENDERER),
+	  rasterTops(NULL),
+	  rasterValid(false),
+	  lutDisplayFrame(lutHeight, lutWidth, CV_8UC(channels)),
 	  outDisplayFrame(image->size(), image->type())
 
 {
@@ -105,17 +171,17 @@ void CvHistograms<T, channels>::setup(Mat * image, const bool completeSetup)
 	// Complete setup starting point (==> previous cleanup)
 	if (completeSetup)
 	{
-		monoTransfertFunc = Mat(1, bins, CV_8UC1);
-		colorTransferFunc = Mat(1, bins, CV_8UC(channels));
+		monoTransfertFunc = Mat(1, bins, CV_MAKETYPE(DataType<T>::depth, 1));
+		colorTransferFunc = Mat(1, bins, CV_MAKETYPE(DataType<T>::depth, channels));
 		lut = NULL;
 		lutType = NONE;
 		previousLutType = NBTRANS;
 		lutParam = 80.0;
 		showCumulative = false;
-		lutWidth = bins;
-		lutHeight = bins;
+		lutWidth = (bins < maxLutDrawSize ? bins : maxLutDrawSize);
+		lutHeight = lutWidth;
 		histDisplayFrame = Mat(histHeight, histWidth, CV_8UC(channels));
-		lutDisplayFrame = Mat(bins, bins, CV_8UC(channels));
+		lutDisplayFrame = Mat(lutHeight, lutWidth, CV_8UC(channels));
 		outDisplayFrame = Mat(image->size(), image->type());
 	}
 	else //
@@ -171,6 +237,48 @@ void CvHistograms<T, channels>::setup(Mat * image, const bool completeSetup)
 		{
 			showComponent[HIST_GRAY] = false; // don't show gray hist. yet
 		}
+
+		// creates fixed point luminance tables
+		if (nbHistograms > channels)
+		{
+			grayTables = new int[3 * bins];
+			for (size_t l = 0; l < 3; l++)
+			{
+				int coef = cvRound(BGR2Gray[l] * (1 << grayShift));
+				for (size_t v = 0; v < bins; v++)
+				{
+					grayTables[l * bins + v] = coef * (int) v;
+				}
+			}
+			// rounding offset
+			for (size_t v = 0; v < bins; v++)
+			{
+				grayTables[v] += 1 << (grayShift - 1);
+			}
+		}
+
+		// creates integer banks for each histogram
+		for (size_t i = 0; i < nbHistograms; i++)
+		{
+			histogramBanks.push_back(new unsigned int[nbBanks * bins]);
+		}
+
+		// creates histogram transfer buffer
+		transferBuffer = new float[bins];
+
+		// creates time window frames ring
+		resetTimeCumulation();
+
+		// creates local equalization tiles
+		resetLocalTiles();
+
+		// creates reference cumulative histograms of histograms LUTs
+		lutReference = new float[nbHistograms * bins];
+
+		// creates column buffers of the raster renderer
+		rasterTops = new int[nbHistograms * histWidth];
+		rasterShown.assign(nbHistograms, 0);
+		rasterValid = false;
 	}
 	else // sourceImage->data is NULL
 	{
@@ -204,7 +312,54 @@ void CvHistograms<T, channels>::cleanup()
 		lutComponents[i].release();
 	}
 
+	for (size_t c = 0; c < histogramBanks.size(); c++)
+	{
+		delete [] histogramBanks[c];
+	}
+	histogramBanks.clear();
+
+	delete [] transferBuffer;
+	transferBuffer = NULL;
+
+	delete [] grayTables;
+	grayTables = NULL;
+
+	for (size_t f = 0; f < windowFrames.size(); f++)
+	{
+		delete [] windowFrames[f];
+	}
+	windowFrames.clear();
+	delete [] windowSums;
+	windowSums = NULL;
+
+	for (size_t b = 0; b < partialBanks.size(); b++)
+	{
+		delete [] partialBanks[b];
+	}
+	partialBanks.clear();
+
+	delete [] lutReference;
+	lutReference = NULL;
+
+	delete [] rasterTops;
+	rasterTops = NULL;
+	rasterShown.clear();
+	lutCache.clear();
+
+	delete [] localCounts;
+	localCounts = NULL;
+	delete [] localCachedCounts;
+	localCachedCounts = NULL;
+	delete [] localLUTs;
+	localLUTs = NULL;
+	localTileUpdated.clear();
+	localColumns.clear();
+	localColumnWeights.clear();
+	localRows.clear();
+	localRowWeights.clear();
+
 	outDisplayFrame.release();
+	expandedLUT.release();
 	lutDisplayFrame.release();
 	lutComponents.clear();
 	histDisplayFrame.release();
@@ -225,11 +380,51 @@ void CvHistograms<T, channels>::cleanup()
  * @return the Number of bins in all histograms
  */
 template <typename T, size_t channels>
-size_t CvHistograms<T, channels>::getBins()
+size_t CvHistograms<T, channels>::getBins() const
 {
 	return bins;
 }
 
+/*
+ * Computes the number of bins used for a requested number of bins
+ * @param nbBins the requested number of bins (0 for default)
+ * @return the largest power of two below nbBins and levels
+ */
+template <typename T, size_t channels>
+size_t CvHistograms<T, channels>::binsFor(const size_t nbBins)
+{
+	size_t requested = (nbBins == 0 ? defaultBins : nbBins);
+	if (requested > levels)
+	{
+		requested = levels;
+	}
+
+	size_t result = 1;
+	while ((result << 1) <= requested)
+	{
+		result <<= 1;
+	}
+
+	return result;
+}
+
+/*
+ * Computes the range mapping shift of a number of bins
+ * @param nbBins a power of two number of bins below levels
+ * @return the shift mapping levels to nbBins bins
+ */
+template <typename T, size_t channels>
+int CvHistograms<T, channels>::shiftFor(const size_t nbBins)
+{
+	int shift = 0;
+	while ((nbBins << shift) < levels)
+	{
+		shift++;
+	}
+
+	return shift;
+}
+
 /*
  * Get the number of histograms computed
  * @return the current number of histograms computed by this class
@@ -384,9 +579,138 @@ bool CvHistograms<T, channels>::isTimeCumulative() const
 template <typename T, size_t channels>
 void CvHistograms<T, channels>::setTimeCumulative(const bool value)
 {
+	if (value != timeCumulative)
+	{
+		resetTimeCumulation();
+	}
+
 	timeCumulative = value;
 }
 
+/*
+ * Time cumulation mode read access
+ * @return the time cumulation mode used when time cumulative
+ * histograms are on
+ */
+template <typename T, size_t channels>
+typename CvHistograms<T, channels>::TimeCumulationMode
+CvHistograms<T, channels>::getTimeCumulationMode() const
+{
+	return timeMode;
+}
+
+/*
+ * Time cumulation mode write access
+ * @param mode the new time cumulation mode (TIME_UNBOUNDED is used
+ * if mode is invalid)
+ * @post time cumulation is restarted
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setTimeCumulationMode(const TimeCumulationMode mode)
+{
+	if (mode < NBTIMEMODES)
+	{
+		timeMode = mode;
+	}
+	else
+	{
+		timeMode = TIME_UNBOUNDED;
+	}
+
+	resetTimeCumulation();
+}
+
+/*
+ * Number of frames of the TIME_WINDOW mode read access
+ * @return the number of frames in the time window
+ */
+template <typename T, size_t channels>
+size_t CvHistograms<T, channels>::getTimeWindow() const
+{
+	return timeWindow;
+}
+
+/*
+ * Number of frames of the TIME_WINDOW mode write access
+ * @param frames the new number of frames in the time window (at
+ * least 1)
+ * @post time cumulation is restarted
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setTimeWindow(const size_t frames)
+{
+	timeWindow = (frames > 1 ? frames : 1);
+
+	resetTimeCumulation();
+}
+
+/*
+ * Decay factor of the TIME_DECAY mode read access
+ * @return the weight of the newest frame in decayed histograms
+ */
+template <typename T, size_t channels>
+float CvHistograms<T, channels>::getTimeDecay() const
+{
+	return timeDecay;
+}
+
+/*
+ * Decay factor of the TIME_DECAY mode write access
+ * @param decay the weight of the newest frame in decayed
+ * histograms (clamped to ]0..1])
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setTimeDecay(const float decay)
+{
+	if (decay > 1.0)
+	{
+		timeDecay = 1.0;
+	}
+	else if (decay <= 0.0)
+	{
+		timeDecay = numeric_limits<float>::epsilon();
+	}
+	else
+	{
+		timeDecay = decay;
+	}
+}
+
+/*
+ * Restarts time cumulation: clears the time window frames ring (and
+ * reallocates it for the current timeWindow) and frames count
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::resetTimeCumulation()
+{
+	if (windowFrames.size() != timeWindow)
+	{
+		for (size_t f = 0; f < windowFrames.size(); f++)
+		{
+			delete [] windowFrames[f];
+		}
+		windowFrames.clear();
+
+		for (size_t f = 0; f < timeWindow; f++)
+		{
+			windowFrames.push_back(new unsigned int[nbHistograms * bins]);
+		}
+	}
+
+	if (windowSums == NULL)
+	{
+		windowSums = new uint64_t[nbHistograms * bins];
+	}
+
+	// ring slots are overwritten before being read, so only sums are cleared
+	for (size_t k = 0; k < nbHistograms * bins; k++)
+	{
+		windowSums[k] = 0;
+	}
+
+	timeFrames = 0;
+}
+
 /*
  * Cumulative histogram status read access
  * @return the cumulative histogram status
@@ -407,6 +731,102 @@ void CvHistograms<T, channels>::setCumulative(const bool value)
 	showCumulative = value;
 }
 
+/*
+ * Gets the current histogram counting engine
+ * @return the current histogram counting engine
+ */
+template <typename T, size_t channels>
+typename CvHistograms<T, channels>::HistogramKernel
+CvHistograms<T, channels>::getHistogramKernel() const
+{
+	return kernel;
+}
+
+/*
+ * Sets the histogram counting engine
+ * @param kernel the new counting engine (BANKED_KERNEL is used
+ * if kernel is invalid)
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setHistogramKernel(const HistogramKernel kernel)
+{
+	if (kernel < NBKERNELS)
+	{
+		this->kernel = kernel;
+	}
+	else
+	{
+		this->kernel = BANKED_KERNEL;
+	}
+
+	// Previous timings are irrelevant with the new engine
+	meanUpdateHistogramTime1.reset();
+	meanUpdateHistogramTime2.reset();
+}
+
+/*
+ * Gets the current histogram rendering engine
+ * @return the current histogram rendering engine
+ */
+template <typename T, size_t channels>
+typename CvHistograms<T, channels>::HistogramRenderer
+CvHistograms<T, channels>::getHistogramRenderer() const
+{
+	return renderer;
+}
+
+/*
+ * Sets the histogram rendering engine
+ * @param renderer the new rendering engine (RASTER_RENDERER is used
+ * if renderer is invalid)
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setHistogramRenderer(const HistogramRenderer renderer)
+{
+	if (renderer < NBRENDERERS)
+	{
+		this->renderer = renderer;
+	}
+	else
+	{
+		this->renderer = RASTER_RENDERER;
+	}
+
+	rasterValid = false;
+
+	// Previous timings are irrelevant with the new engine
+	meanDrawHistogramTime.reset();
+}
+
+/*
+ * Gets the number of threads used to count pixels
+ * @return the number of threads used to count pixels (1 when
+ * counting is sequential)
+ */
+template <typename T, size_t channels>
+size_t CvHistograms<T, channels>::getParallel() const
+{
+	return parallelThreads;
+}
+
+/*
+ * Sets the number of threads used to count pixels.
+ * Source image is split in threads row bands, each counted in
+ * private banks, which are then merged in bands order.
+ * @param threads the number of threads to use (values below 1
+ * are clamped to 1, which means sequential counting)
+ * @note only the BANKED_KERNEL can count in parallel
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setParallel(const int threads)
+{
+	parallelThreads = (threads > 1 ? (size_t) threads : 1);
+
+	// Previous timings are irrelevant with the new number of threads
+	meanUpdateHistogramTime1.reset();
+	meanUpdateHistogramTime2.reset();
+}
+
 /*
  * Ith histogram component shown status read access
  * @param i the ith histogram component
@@ -451,21 +871,21 @@ void CvHistograms<T, channels>::update()
 	clock_t start;
 	processTime = 0;
 
-	// Compute histogram
-	start = clock();
+	// Compute histogram (wall clock time since it may be multi-threaded)
+	int64 tickStart = getTickCount();
 
 	updateHistogram();
 
-	updateHistogramTime1 = clock() - start;
+	updateHistogramTime1 = elapsedTicks(tickStart);
 	processTime += updateHistogramTime1;
 	meanUpdateHistogramTime1 += updateHistogramTime1;
 
-	// Compute requested LUT
-	start = clock();
+	// Compute requested LUT (wall clock time since it may be multi-threaded)
+	tickStart = getTickCount();
 
 	lut = computeLUT();
 
-	computeLUTTime = clock() - start;
+	computeLUTTime = elapsedTicks(tickStart);
 	processTime += computeLUTTime;
 	meanComputeLUTTime += computeLUTTime;
 
@@ -481,23 +901,33 @@ void CvHistograms<T, channels>::update()
 		meanDrawLUTTime += drawLUTTime;
 	}
 
-	// Try to apply LUT
-	start = clock();
+	// Try to apply LUT (wall clock time since it may be multi-threaded)
+	tickStart = getTickCount();
 
 	bool lutApplied = drawTransformedImage();
 
-	applyLUTTime = clock() - start;
+	applyLUTTime = elapsedTicks(tickStart);
 	processTime += applyLUTTime;
 	meanApplyLUTTime += applyLUTTime;
 
 	if (lutApplied)
 	{
-		// if LUT has been applied histogram should be updated
-		start = clock();
+		/*
+		 * if LUT has been applied histogram should be updated: point-wise
+		 * LUTs only move bins populations so output histograms are
+		 * obtained by transfering histograms through the LUT. Image is
+		 * scanned again only when transfer can't be exact.
+		 */
+		tickStart = getTickCount();
 
-		updateHistogram();
+		if (!transferHistogram() && !timeCumulative)
+		{
+			// (scanning again would count this frame twice in all time
+			// cumulative modes: once as source and once as output)
+			countHistograms(&outDisplayFrame);
+		}
 
-		updateHistogramTime2 = clock() - start;
+		updateHistogramTime2 = elapsedTicks(tickStart);
 		processTime += updateHistogramTime2;
 		meanUpdateHistogramTime2 += updateHistogramTime2;
 	}
@@ -522,60 +952,205 @@ void CvHistograms<T, channels>::update()
  */
 template <typename T, size_t channels>
 void CvHistograms<T, channels>::updateHistogram()
+{
+	countHistograms(sourceImage);
+}
+
+/*
+ * Counts an image pixels into histograms and computes cumulative
+ * histograms and max values.
+ * @param image the image to count (source image or transformed
+ * image)
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::countHistograms(const Mat * image)
 {
 	maxValue = 0.0;
 	cMaxValue = 0.0;
 
-	// reset histograms values if necessary
-	if (!timeCumulative)
+	/*
+	 * count image values into histograms
+	 * (time window & decay modes need per frame integer counts, which
+	 * are only provided by the BANKED_KERNEL)
+	 */
+	if ((kernel == ITERATOR_KERNEL) &&
+		(!timeCumulative || (timeMode == TIME_UNBOUNDED)))
 	{
-		// reset histograms values (including evt gray level histogram)
-		for (size_t i = 0; i < nbHistograms; i++)
-		{
-			float * h = histograms[i];
-			for (size_t j = 0; j < bins; j++)
-			{
-				h[j] = 0.0;
-			}
-		}
+		countIterator(image);
 	}
-
-	// creating iterators over image
-	MatConstIterator_<Vec<T, channels> > iterator =
-		sourceImage->begin<Vec<T, channels> >();
-	MatConstIterator_<Vec<T, channels> > end =
-		sourceImage->end<Vec<T, channels> >();
-
-	// updateHistogram histograms values
-	for (; iterator != end; ++iterator)
+	else
 	{
-		Vec<T, channels> pixel = *iterator;
+		countBanked(image);
+	}
 
-		for (size_t i = 0; i < channels; i++)
-		{
-			// updateHistogram corresponding histogram bin
-			float histValue = ++histograms[i][(size_t) pixel[i]];
+	completeHistograms();
+}
 
-			// updateHistogram max value if needed
-			if (histValue > maxValue)
-			{
-				maxValue = histValue;
-			}
-		}
+/*
+ * Update histograms values after current LUT has been applied
+ * without scanning the transformed image : since LUT is point-wise,
+ * each bin population of the source image is moved to the bin it is
+ * transformed to. The gray level histogram (if any) can't be
+ * transfered and is counted again by a luminance only pass over the
+ * transformed image.
+ * @return true if histograms have been transfered, false if transfer
+ * can't be exact (such as with time cumulative histograms or invalid
+ * LUT) and histograms should be updated by scanning the transformed
+ * image instead.
+ * @pre histograms contains the source image histograms
+ * @post histograms, cumulative histograms and max values correspond
+ * to the transformed image
+ */
+template <typename T, size_t channels>
+bool CvHistograms<T, channels>::transferHistogram()
+{
+	/*
+	 * Time cumulative histograms contains previous frames populations
+	 * which have not been transformed by the current LUT
+	 */
+	if (timeCumulative || (lut == NULL) || (lut->cols != (int) bins))
+	{
+		return false;
 	}
 
-	// eventually updates gray level histogram
-	if (computeGray && (channels == 3))
+	/*
+	 * Local equalization transforms the same level differently
+	 * depending on pixel location
+	 */
+	if (lutType == LOCAL_EQUALIZE)
 	{
-		for (size_t l = 0; l < channels; l++)
-		{
-			for (size_t i = 0; i < bins; i++)
+		return false;
+	}
+
+	/*
+	 * When a bin contains several levels, they are interpolated to several
+	 * output bins by the expanded LUT
+	 */
+	if (binShift > 0)
+	{
+		return false;
+	}
+
+	size_t lutChannels = (size_t) lut->channels();
+	if ((lutChannels != 1) && (lutChannels != channels))
+	{
+		return false;
+	}
+
+	const T * lutValues = lut->ptr<T>(0);
+
+	maxValue = 0.0;
+	cMaxValue = 0.0;
+
+	for (size_t c = 0; c < channels; c++)
+	{
+		float * h = histograms[c];
+		size_t lc = (lutChannels == 1 ? 0 : c);
+
+		for (size_t j = 0; j < bins; j++)
+		{
+			transferBuffer[j] = 0.0;
+		}
+
+		// moves population of bin j to bin lut(j)
+		for (size_t j = 0; j < bins; j++)
+		{
+			transferBuffer[(size_t) lutValues[j * lutChannels + lc]] += h[j];
+		}
+
+		for (size_t j = 0; j < bins; j++)
+		{
+			h[j] = transferBuffer[j];
+			if (h[j] > maxValue)
+			{
+				maxValue = h[j];
+			}
+		}
+	}
+
+	/*
+	 * Luminance of transformed pixels depends on all of their transformed
+	 * components, which can't be recovered from the luminance histogram:
+	 * only the luminance histogram is counted again from the transformed
+	 * image
+	 */
+	if (nbHistograms > channels)
+	{
+		countGray(&outDisplayFrame);
+	}
+
+	completeHistograms();
+
+	return true;
+}
+
+/*
+ * Counts only the luminance histogram of a BGR image (channels
+ * histograms are left unchanged)
+ * @param image the BGR image to count
+ * @pre gray level histogram is computed (nbHistograms > channels)
+ * @post gray level histogram contains the image luminance counts and
+ * maxValue is updated
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::countGray(const Mat * image)
+{
+	unsigned int * grayBanks = histogramBanks[channels];
+	memset(grayBanks, 0, nbBanks * bins * sizeof(unsigned int));
+
+	size_t nbRows = image->rows;
+	size_t nbCols = image->cols;
+	if (image->isContinuous())
+	{
+		// continuous image is processed as a single long row
+		nbCols *= nbRows;
+		nbRows = 1;
+	}
+
+	for (size_t y = 0; y < nbRows; y++)
+	{
+		const T * row = image->ptr<T>(y);
+		size_t x = 0;
+		for (; x + nbBanks <= nbCols; x += nbBanks, row += nbBanks * channels)
+		{
+			for (size_t k = 0; k < nbBanks; k++)
 			{
-				histograms[HIST_GRAY][i] += BGR2Gray[l] * histograms[l][i];
+				++grayBanks[k * bins + grayLevel(row + k * channels,
+												 grayTables)];
 			}
 		}
+
+		// remaining pixels goes into first bank
+		for (; x < nbCols; x++, row += channels)
+		{
+			++grayBanks[grayLevel(row, grayTables)];
+		}
+	}
+
+	float * h = histograms[channels];
+	for (size_t j = 0; j < bins; j++)
+	{
+		unsigned int count = 0;
+		for (size_t k = 0; k < nbBanks; k++)
+		{
+			count += grayBanks[k * bins + j];
+		}
+
+		h[j] = (float) count;
+		if (h[j] > maxValue)
+		{
+			maxValue = h[j];
+		}
 	}
+}
 
+/*
+ * Computes cumulative histograms and cMaxValue
+ * @pre regular histograms and maxValue are up to date
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::completeHistograms()
+{
 	// update cumulative histograms
 	for (size_t h = 0; h < nbHistograms; h++)
 	{
@@ -599,396 +1174,1317 @@ void CvHistograms<T, channels>::updateHistogram()
 }
 
 /*
- * Draws selected histogram(s) in drawing frame and returns the drawing
- * frame
- * @return the updated drawing frame.
- * @post depending on several attributes one or several histograms
- * have bee drawn in the drawing frame wich is returned
- * 	- if #showCumulative is true then cumulative histograms are drawn
- * 	otherwise regular histograms are drawn
- * 	- each histogram is drawn only if its showComponent[i] is true.
+ * Counts image pixels into histograms with the reference
+ * iterator based engine.
+ * @param image the image to count
+ * @post histograms are reset (unless time cumulative) and
+ * updated with the image values, maxValue is updated.
  */
 template <typename T, size_t channels>
-void CvHistograms<T, channels>::drawHistograms()
+void CvHistograms<T, channels>::countIterator(const Mat * image)
 {
-	float curveStep = (float) histWidth / (float) bins;
-	vector<float *> * valuesPtr;
-	float max;
-	if (showCumulative)
-	{
-		valuesPtr = &cumulHistograms;
-		max = cMaxValue;
-	}
-	else
+	// reset histograms values if necessary
+	if (!timeCumulative)
 	{
-		valuesPtr = &histograms;
-		max = maxValue;
+		// reset histograms values (including evt gray level histogram)
+		for (size_t i = 0; i < nbHistograms; i++)
+		{
+			float * h = histograms[i];
+			for (size_t j = 0; j < bins; j++)
+			{
+				h[j] = 0.0;
+			}
+		}
 	}
 
-	// Fill the drawing frame with black
-	rectangle(histDisplayFrame,
-			  Point(0, 0),
-			  Point(histWidth - 1, histHeight - 1),
-			  Scalar(0x00, 0x00, 0x00, 0x00),
-			  CV_FILLED);
+	bool countGray = nbHistograms > channels;
 
-	// Draw the bins (reversed)
-	for (size_t h = 0; h < nbHistograms; h++)
+	// creating iterators over image
+	MatConstIterator_<Vec<T, channels> > iterator =
+		image->begin<Vec<T, channels> >();
+	MatConstIterator_<Vec<T, channels> > end =
+		image->end<Vec<T, channels> >();
+
+	// updateHistogram histograms values
+	for (; iterator != end; ++iterator)
 	{
-		// fills this color histogram frame with black
-		rectangle(histComponents[h],
-				  Point(0, 0),
-				  Point(histWidth - 1, histHeight - 1),
-				  Scalar(0x00, 0x00, 0x00, 0x00),
-				  CV_FILLED);
+		Vec<T, channels> pixel = *iterator;
 
-		// if this color histogram should be drawn
-		if (showComponent[h])
+		for (size_t i = 0; i < channels; i++)
 		{
-			for (size_t i = 0; i < bins; i++)
+			// updateHistogram corresponding histogram bin
+			float histValue = ++histograms[i][(size_t) pixel[i] >> binShift];
+
+			// updateHistogram max value if needed
+			if (histValue > maxValue)
 			{
-				// draws each bin (reversed) in this color hist. frame
-				rectangle(
-					histComponents[h], // the image to draw in
-					Point(i * curveStep,
-						  histHeight - 1),	 // first corner of this bin
-					Point((i + 1) * curveStep, // second corner of this bin
-						  histHeight - 1 -
-							  cvRound(((*valuesPtr)[h][i] / max) * histHeight)),
-					displayColors[h], // current color
-					CV_FILLED,		  // filled rectangle
-					CV_AA);			  // antialiased line
+				maxValue = histValue;
+			}
+		}
+
+		// updates gray level histogram with this pixel luminance
+		if (countGray)
+		{
+			float histValue =
+				++histograms[HIST_GRAY][grayLevel(pixel.val, grayTables)];
+
+			if (histValue > maxValue)
+			{
+				maxValue = histValue;
 			}
-			// adds this color histogram frame to the drawing frame
-			add(histDisplayFrame, histComponents[h], histDisplayFrame);
 		}
 	}
 }
 
 /*
- * Draws selected transfert function in drawing frame and returns the
- * drawing frame
- * @param lut the LUT to draw : the LUT may contains 1 or several
- * channels
- * @return the updated drawing frame
+ * Parallel loop body counting row bands with #countBand
  */
 template <typename T, size_t channels>
-void CvHistograms<T, channels>::drawTransfertFunc(const Mat * lut)
+class CvHistograms<T, channels>::BandCounter : public ParallelLoopBody
 {
-	float curveStep = (float) lutWidth / (float) bins;
-
-	const Mat * currentLUT;
+	private:
+		/**
+		 * The histograms to count bands for
+		 */
+		CvHistograms<T, channels> * processor;
 
-	if (lut != NULL)
-	{
-		currentLUT = lut;
-	}
-	else // identity LUT should be computed
-	{
-		currentLUT = computeLinearGrayLUT();
-	}
+		/**
+		 * The image to count
+		 */
+		const Mat * image;
 
-	size_t lutChannels = (size_t) currentLUT->channels();
+		/**
+		 * The number of bands the image is split in
+		 */
+		const size_t nbBands;
+
+	public:
+		/**
+		 * Band counter constructor
+		 * @param processor the histograms to count bands for
+		 * @param image the image to count
+		 * @param nbBands the number of bands the image is split in
+		 */
+		BandCounter(CvHistograms<T, channels> * processor,
+					const Mat * image,
+					const size_t nbBands) :
+			processor(processor),
+			image(image),
+			nbBands(nbBands)
+		{}
+
+		/**
+		 * Counts bands in range
+		 * @param range the range of bands to count
+		 */
+		void operator()(const Range & range) const
+		{
+			for (int b = range.start; b < range.end; b++)
+			{
+				processor->countBand(image, (size_t) b, nbBands);
+			}
+		}
+};
 
-	// Fill the drawing frame with black
-	rectangle(lutDisplayFrame,
-			  Point(0, 0),
-			  Point(lutWidth - 1, lutHeight - 1),
-			  Scalar(0x00, 0x00, 0x00, 0x00),
-			  CV_FILLED);
+/*
+ * Counts image pixels into histograms with the row pointers
+ * and integer banks engine.
+ * @param image the image to count
+ * @post histograms are reset (unless time cumulative) and
+ * updated with the image values, maxValue is updated.
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::countBanked(const Mat * image)
+{
+	size_t nbRows = image->rows;
+	size_t nbBands = (parallelThreads < nbRows ? parallelThreads : nbRows);
 
-	// Draw the bins (reversed)
-	if (lutChannels == 1)
+	if (nbBands > 1)
 	{
-		// draws directly in histDisplayFrame with white color
-		for (size_t i = 0; i < bins; i++)
+		// private banks for bands 1..nbBands-1
+		while (partialBanks.size() < (nbBands - 1) * nbHistograms)
 		{
-			rectangle(
-				lutDisplayFrame,					 // the image to draw in
-				Point(i * curveStep, lutHeight - 1), // first corner of this bin
-				Point((i + 1) * curveStep, // second corner of this bin
-					  lutHeight - 1 -
-						  cvRound(((float) currentLUT->at<T>(0, i) / bins) *
-								  lutHeight)),
-				displayColors[3], // current color
-				CV_FILLED,		  // filled rectangle
-				CV_AA);			  // antialiased line
+			partialBanks.push_back(new unsigned int[nbBanks * bins]);
 		}
-	}
-	else // lutChannels == 3 or others
-	{
-		// draws in each colorLUTFrams and adds it to histDisplayFrame
-		for (size_t c = 0; c < lutChannels; c++)
+
+		parallel_for_(Range(0, (int) nbBands),
+					  BandCounter(this, image, nbBands),
+					  (double) nbBands);
+
+		// deterministic merge of bands banks (in bands order) into band 0
+		for (size_t b = 1; b < nbBands; b++)
 		{
-			if (showComponent[c])
+			for (size_t i = 0; i < nbHistograms; i++)
 			{
-				// Fill the color drawing frame with black
-				rectangle(lutComponents[c],
-						  Point(0, 0),
-						  Point(lutWidth - 1, lutHeight - 1),
-						  Scalar(0x00, 0x00, 0x00, 0x00),
-						  CV_FILLED);
-
-				for (size_t i = 0; i < bins; i++)
+				unsigned int * dst = histogramBanks[i];
+				const unsigned int * src =
+					partialBanks[(b - 1) * nbHistograms + i];
+				for (size_t j = 0; j < nbBanks * bins; j++)
 				{
-					rectangle(lutComponents[c], // the image to draw in
-						Point(i * curveStep,
-							  lutHeight - 1), // first corner of this bin
-						Point((i + 1) * curveStep, // second corner of this bin
-							  lutHeight - 1 -
-							  cvRound(((float)
-									   currentLUT->at<Vec<T, channels> >(0, i)[c] / bins) *
-									lutHeight)),
-						displayColors[c], // current color
-						CV_FILLED,		  // filled rectangle
-						CV_AA);			  // antialiased line
+					dst[j] += src[j];
 				}
-				add(lutDisplayFrame, lutComponents[c], lutDisplayFrame);
 			}
 		}
 	}
-}
+	else
+	{
+		countBand(image, 0, 1);
+	}
 
-/*
- * Indicates if LUT has been updated or if it has not changed
- * @return true if LUT has been updated
- */
-template <typename T, size_t channels>
-bool CvHistograms<T, channels>::isLUTUpdated() const
-{
-	return lutUpdated;
+	reduceBanks(&histogramBanks[0]);
 }
 
 /*
- * Gets the current LUT type
- * @return the current LUT type
+ * Counts a band of rows of an image into the integer banks
+ * of this band.
+ * @param image the image to count
+ * @param band the band index in [0..nbBands - 1]
+ * @param nbBands the number of bands the image is split in
+ * @post banks of this band are reset and contains band counts
  */
 template <typename T, size_t channels>
-typename CvHistograms<T, channels>::TransfertType
-CvHistograms<T, channels>::getLutType() const
+void CvHistograms<T, channels>::countBand(const Mat * image,
+										  const size_t band,
+										  const size_t nbBands)
 {
-	return lutType;
-}
+	unsigned int * const * banks = (band == 0 ?
+		&histogramBanks[0] : &partialBanks[(band - 1) * nbHistograms]);
+	const int * gray = (nbHistograms > channels ? grayTables : NULL);
 
-/*
- * Sets the current LUT type
- * @param lutType the new LUT type
- */
-template <typename T, size_t channels>
-void CvHistograms<T, channels>::setLutType(const TransfertType lutType)
-{
-	previousLutType = this->lutType;
+	// reset integer banks
+	for (size_t i = 0; i < nbHistograms; i++)
+	{
+		memset(banks[i], 0, nbBanks * bins * sizeof(unsigned int));
+	}
 
-	computeLUTTime = 0;
-	drawLUTTime = 0;
-	applyLUTTime = 0;
-	updateHistogramTime2 = 0;
+	size_t nbRows = image->rows;
+	size_t nbCols = image->cols;
+	size_t firstRow = (band * nbRows) / nbBands;
+	size_t lastRow = ((band + 1) * nbRows) / nbBands;
 
-	if (lutType < NBTRANS)
+	if (image->isContinuous())
 	{
-		this->lutType = lutType;
+		// rows of a continuous band are processed as a single long row
+		countRow(image->ptr<T>(firstRow),
+				 (lastRow - firstRow) * nbCols,
+				 gray,
+				 banks);
 	}
 	else
 	{
-		this->lutType = NONE;
+		for (size_t y = firstRow; y < lastRow; y++)
+		{
+			countRow(image->ptr<T>(y), nbCols, gray, banks);
+		}
 	}
 }
 
 /*
- * Gets the current parameter value for LUTs using a percentage parameter
- * @return the current LUT parameter
+ * Computes elapsed wall clock time since start (in clock ticks so
+ * it can be mixed with clock() measured times).
+ * @param start the starting time obtained with getTickCount()
+ * @return the elapsed time in clock ticks
  */
 template <typename T, size_t channels>
-float CvHistograms<T, channels>::getLUTParam() const
+clock_t CvHistograms<T, channels>::elapsedTicks(const int64 start)
 {
-	return lutParam;
+	return (clock_t) (((double) (getTickCount() - start) * CLOCKS_PER_SEC) /
+					  getTickFrequency());
 }
 
 /*
- * Sets the current LUT % parameter
- * @param lutParam the new LUT parameter
+ * Counts a row of pixels into integer banks
+ * @param row pointer to the first element of the row
+ * @param nbPixels number of pixels in the row
+ * @param grayTables the fixed point luminance tables used to count
+ * the gray level histogram in banks[channels], or NULL if there is
+ * no gray level histogram
+ * @param banks histograms banks to count in (nbBanks * bins counters
+ * for each histogram)
  */
 template <typename T, size_t channels>
-void CvHistograms<T, channels>::setLUTParam(const float currentParam)
+void CvHistograms<T, channels>::countRow(const T * row,
+										 const size_t nbPixels,
+										 const int * grayTables,
+										 unsigned int * const * banks) const
 {
-	previousLutParam = lutParam;
+	size_t x = 0;
+	const int shift = binShift;
 
-	if (currentParam > maxParam)
+	if ((sizeof(T) == 1) && (channels == 1))
 	{
-		this->lutParam = maxParam;
+		/*
+		 * 8 bits single channel: loads nbBanks (4) pixels at once in a
+		 * 32 bits word and unpack them with shifts & masks. Each byte goes
+		 * to a different bank, so byte ordering in the word does not matter.
+		 */
+		unsigned int * b0 = banks[0];
+		unsigned int * b1 = b0 + bins;
+		unsigned int * b2 = b1 + bins;
+		unsigned int * b3 = b2 + bins;
+		const uchar * bytes = reinterpret_cast<const uchar *>(row);
+		for (; x + 4 <= nbPixels; x += 4, bytes += 4)
+		{
+			uint32_t word;
+			memcpy(&word, bytes, sizeof(word));
+			++b0[(word & 0xFF) >> shift];
+			++b1[((word >> 8) & 0xFF) >> shift];
+			++b2[((word >> 16) & 0xFF) >> shift];
+			++b3[(word >> 24) >> shift];
+		}
+		row = reinterpret_cast<const T *>(bytes);
 	}
-	else if (currentParam < minParam)
+	else if (grayTables == NULL)
 	{
-		this->lutParam = minParam;
+		/*
+		 * Interleaved channels: pixel k of each group of nbBanks pixels
+		 * goes to bank k of each channel
+		 */
+		for (; x + nbBanks <= nbPixels; x += nbBanks, row += nbBanks * channels)
+		{
+			for (size_t k = 0; k < nbBanks; k++)
+			{
+				const T * pixel = row + k * channels;
+				for (size_t c = 0; c < channels; c++)
+				{
+					++banks[c][k * bins + ((size_t) pixel[c] >> shift)];
+				}
+			}
+		}
 	}
 	else
 	{
-		this->lutParam = currentParam;
+		/*
+		 * Interleaved BGR channels and luminance of the same pixel computed
+		 * from the components already loaded for channels histograms
+		 */
+		unsigned int * grayBanks = banks[channels];
+		for (; x + nbBanks <= nbPixels; x += nbBanks, row += nbBanks * channels)
+		{
+			for (size_t k = 0; k < nbBanks; k++)
+			{
+				const T * pixel = row + k * channels;
+				for (size_t c = 0; c < channels; c++)
+				{
+					++banks[c][k * bins + ((size_t) pixel[c] >> shift)];
+				}
+				++grayBanks[k * bins + grayLevel(pixel, grayTables)];
+			}
+		}
 	}
-}
 
-/*
- * Return processor processing time of step index [default implementation
- * returning only processTime, should be reimplemented in subclasses]
- * @param index index of the step which processing time is required,
- * 0 indicates all steps, and values above 0 indicates step #. If
- * required index is bigger than number of steps than all steps value
- * should be returned.
- * @return the processing time of step index.
- * @note should be reimplemented in subclasses in order to define
- * time/feature behaviour
- */
-template <typename T, size_t channels>
-double CvHistograms<T, channels>::getProcessTime(const size_t index) const
-{
-	switch (index)
+	// remaining pixels goes into first bank
+	for (; x < nbPixels; x++, row += channels)
 	{
-		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM):
-			return (double) updateHistogramTime1;
-		case (CvHistograms<T, channels>::COMPUTE_LUT):
-			return (double) computeLUTTime;
-		case (CvHistograms<T, channels>::DRAW_LUT):
-			return (double) drawLUTTime;
-		case (CvHistograms<T, channels>::APPLY_LUT):
-			return (double) applyLUTTime;
-		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM_AFTER_LUT):
-			return (double) updateHistogramTime2;
-		case (CvHistograms<T, channels>::DRAW_HISTOGRAM):
-			return (double) drawHistogramTime;
-		default:
-			return (double) processTime;
+		for (size_t c = 0; c < channels; c++)
+		{
+			++banks[c][(size_t) row[c] >> shift];
+		}
+		if (grayTables != NULL)
+		{
+			++banks[channels][grayLevel(row, grayTables)];
+		}
 	}
 }
 
 /*
- * Return processor mean processing time of step index [default
- * implementation returning only processTime, should be reimplemented
- * in subclasses]
- * @param index index of the step which processing time is required,
- * 0 indicates all steps, and values above 0 indicates step #. If
- * required index is bigger than number of steps than all steps value
- * should be returned.
- * @return the mean processing time of step index.
- * @note should be reimplemented in subclasses in order to define
- * time/feature behaviour
- * @param index
+ * Merges each histogram's integer banks into histograms and computes
+ * maxValue.
+ * @param banks histograms banks to merge (nbBanks * bins counters
+ * for each histogram)
+ * @post regular histograms contains banks sums, combined with
+ * previous frames according to #timeMode if time cumulative
  */
 template <typename T, size_t channels>
-double CvHistograms<T, channels>::getMeanProcessTime(const size_t index) const
+void CvHistograms<T, channels>::reduceBanks(unsigned int * const * banks)
 {
-	switch (index)
+	bool unbounded = timeCumulative && (timeMode == TIME_UNBOUNDED);
+	bool windowed = timeCumulative && (timeMode == TIME_WINDOW);
+	bool decayed = timeCumulative && (timeMode == TIME_DECAY) &&
+				   (timeFrames > 0);
+
+	/*
+	 * Ring slot receiving this frame counts, which holds the oldest frame
+	 * counts when the window is full
+	 */
+	unsigned int * slot = NULL;
+	bool windowFull = false;
+	float windowSize = 1.0;
+	if (windowed)
 	{
-		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM):
-			return (double) meanUpdateHistogramTime1.mean();
-		case (CvHistograms<T, channels>::COMPUTE_LUT):
-			return (double) meanComputeLUTTime.mean();
-		case (CvHistograms<T, channels>::DRAW_LUT):
-			return (double) meanDrawLUTTime.mean();
-		case (CvHistograms<T, channels>::APPLY_LUT):
-			return (double) meanApplyLUTTime.mean();
-		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM_AFTER_LUT):
-			return (double) meanUpdateHistogramTime2.mean();
-		case (CvHistograms<T, channels>::DRAW_HISTOGRAM):
-			return (double) meanDrawHistogramTime.mean();
-		default:
-			return (double) meanProcessTime.mean();
+		slot = windowFrames[timeFrames % timeWindow];
+		windowFull = timeFrames >= timeWindow;
+		windowSize = (float) (windowFull ? timeWindow : timeFrames + 1);
 	}
-}
 
-/*
- * Return processor processing time std of step index [default
- * implementation returning only processTime, should be reimplemented
- * in subclasses]
- * @param index index of the step which processing time is required,
- * 0 indicates all steps, and values above 0 indicates step #. If
- * required index is bigger than number of steps than all steps value
- * should be returned.
- * @return the mean processing time of step index.
- * @note should be reimplemented in subclasses in order to define
- * time/feature behaviour
- * @param index
- */
-template <typename T, size_t channels>
-double CvHistograms<T, channels>::getStdProcessTime(const size_t index) const
-{
-	switch (index)
+	for (size_t c = 0; c < nbHistograms; c++)
 	{
-		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM):
-			return (double) meanUpdateHistogramTime1.std();
-		case (CvHistograms<T, channels>::COMPUTE_LUT):
-			return (double) meanComputeLUTTime.std();
-		case (CvHistograms<T, channels>::DRAW_LUT):
-			return (double) meanDrawLUTTime.std();
-		case (CvHistograms<T, channels>::APPLY_LUT):
-			return (double) meanApplyLUTTime.std();
-		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM_AFTER_LUT):
-			return (double) meanUpdateHistogramTime2.std();
-		case (CvHistograms<T, channels>::DRAW_HISTOGRAM):
-			return (double) meanDrawHistogramTime.std();
-		default:
-			return (double) meanProcessTime.std();
+		const unsigned int * b = banks[c];
+		float * h = histograms[c];
+
+		for (size_t j = 0; j < bins; j++)
+		{
+			unsigned int count = 0;
+			for (size_t k = 0; k < nbBanks; k++)
+			{
+				count += b[k * bins + j];
+			}
+
+			float histValue;
+			if (windowed)
+			{
+				// adds newest frame and subtracts oldest frame
+				size_t k = c * bins + j;
+				if (windowFull)
+				{
+					windowSums[k] -= slot[k];
+				}
+				slot[k] = count;
+				windowSums[k] += count;
+				histValue = (float) windowSums[k] / windowSize;
+			}
+			else if (decayed)
+			{
+				histValue = ((1.0f - timeDecay) * h[j]) +
+							(timeDecay * (float) count);
+			}
+			else if (unbounded)
+			{
+				histValue = h[j] + (float) count;
+			}
+			else
+			{
+				histValue = (float) count;
+			}
+
+			h[j] = histValue;
+
+			if (histValue > maxValue)
+			{
+				maxValue = histValue;
+			}
+		}
+	}
+
+	if (timeCumulative)
+	{
+		timeFrames++;
 	}
 }
 
 /*
- * Reset mean and std process time in order to re-start computing
- * new mean and std process time values.
+ * Draws selected histogram(s) in drawing frame and returns the drawing
+ * frame
+ * @return the updated drawing frame.
+ * @post depending on several attributes one or several histograms
+ * have bee drawn in the drawing frame wich is returned
+ * 	- if #showCumulative is true then cumulative histograms are drawn
+ * 	otherwise regular histograms are drawn
+ * 	- each histogram is drawn only if its showComponent[i] is true.
  */
 template <typename T, size_t channels>
-void CvHistograms<T, channels>::resetMeanProcessTime()
+void CvHistograms<T, channels>::drawHistograms()
 {
-	CvProcessor::resetMeanProcessTime();
-	meanUpdateHistogramTime1.reset();
-	meanComputeLUTTime.reset();
-	meanDrawLUTTime.reset();
-	meanApplyLUTTime.reset();
-	meanUpdateHistogramTime2.reset();
-	meanDrawHistogramTime.reset();
+	if (renderer == PRIMITIVES_RENDERER)
+	{
+		drawPrimitiveHistograms();
+	}
+	else
+	{
+		drawRasterHistograms();
+	}
 }
 
 /*
- * Compute linear transfert function (LUT) : no change in image levels
- * @return the LUT containing the corresponding transfert function,
- * the returned matrix contains only one channel corresponding to
- * the graylevel LUT which should be applied to all color channels of
- * the image
- * @post the result is stored in monoTransfertFunc
- * @note It's useless to compute a color Linear LUT since all channels
- * would contain the exact same values.
+ * Draws histograms with the RASTER_RENDERER
+ * @see #drawHistograms
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeLinearGrayLUT()
+void CvHistograms<T, channels>::drawRasterHistograms()
 {
-	for (size_t i = 0; i < bins; i++)
+	/*
+	 * Display bins: when there are more bins than drawing columns,
+	 * consecutive bins are gathered in the same display bin
+	 */
+	size_t displayBins = (bins < histWidth ? bins : histWidth);
+	vector<float *> * valuesPtr;
+	float max;
+	if (showCumulative)
+	{
+		valuesPtr = &cumulHistograms;
+		max = cMaxValue;
+	}
+	else
 	{
-		monoTransfertFunc.at<T>(0, i) = i;
+		valuesPtr = &histograms;
+		max = maxValue;
 	}
+	float scale = (max > 0.0 ? (float) histHeight / max : 0.0f);
 
-	return &monoTransfertFunc;
-}
+	bool changed = !rasterValid;
+	vector<size_t> visible;
 
-/*
- * Compute linear transfert function (LUT) : no change in image levels
- * @return the LUT containing the corresponding transfert function,
- * the returned matrix contains 3 channels corresponding to
- * the color LUT which should be applied to all color channels of
- * the image
- * @post the result is stored in colorTransfertFunc
- * @note It's useless to compute a color Linear LUT since all channels
- * would contain the exact same values.
- */
-template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeLinearColorLUT()
-{
-	for (size_t c = 0; c < channels; c++)
+	// updates column buffers of visible components
+	for (size_t h = 0; h < nbHistograms; h++)
 	{
-		for (size_t i = 0; i < bins; i++)
+		bool show = showComponent[h];
+		if (show != (bool) rasterShown[h])
+		{
+			changed = true;
+			rasterShown[h] = show;
+		}
+
+		if (!show)
+		{
+			continue;
+		}
+		visible.push_back(h);
+
+		const float * values = (*valuesPtr)[h];
+		int * tops = rasterTops + h * histWidth;
+
+		for (size_t d = 0; d < displayBins; d++)
+		{
+			// highest population of the bins gathered in this display bin
+			size_t first = (d * bins) / displayBins;
+			size_t last = ((d + 1) * bins) / displayBins;
+			float value = values[first];
+			for (size_t i = first + 1; i < last; i++)
+			{
+				if (values[i] > value)
+				{
+					value = values[i];
+				}
+			}
+
+			int top = (int) histHeight - 1 - cvRound(value * scale);
+			if (top < 0)
+			{
+				top = 0;
+			}
+
+			// drawing columns of this display bin
+			size_t firstColumn = (d * histWidth) / displayBins;
+			size_t lastColumn = ((d + 1) * histWidth) / displayBins;
+			for (size_t x = firstColumn; x < lastColumn; x++)
+			{
+				if (tops[x] != top)
+				{
+					tops[x] = top;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	// drawing frame already contains these bars
+	if (!changed)
+	{
+		return;
+	}
+
+	// components colors (saturated sums of colors, as with add)
+	size_t nbVisible = visible.size();
+	vector<int> colors(nbVisible * channels);
+	vector<const int *> visibleTops(nbVisible);
+	for (size_t v = 0; v < nbVisible; v++)
+	{
+		for (size_t c = 0; c < channels; c++)
 		{
-			colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = i;
+			colors[v * channels + c] = (int) displayColors[visible[v]][c];
 		}
+		visibleTops[v] = rasterTops + visible[v] * histWidth;
 	}
 
-	return &colorTransferFunc;
+	// composites visible components in a single pass
+	for (size_t y = 0; y < histHeight; y++)
+	{
+		uchar * pixel = histDisplayFrame.ptr<uchar>(y);
+		int row = (int) y;
+
+		for (size_t x = 0; x < histWidth; x++, pixel += channels)
+		{
+			int sum[channels];
+			for (size_t c = 0; c < channels; c++)
+			{
+				sum[c] = 0;
+			}
+
+			for (size_t v = 0; v < nbVisible; v++)
+			{
+				if (row >= visibleTops[v][x])
+				{
+					const int * color = &colors[v * channels];
+					for (size_t c = 0; c < channels; c++)
+					{
+						sum[c] += color[c];
+					}
+				}
+			}
+
+			for (size_t c = 0; c < channels; c++)
+			{
+				pixel[c] = saturate_cast<uchar>(sum[c]);
+			}
+		}
+	}
+
+	rasterValid = true;
+}
+
+/*
+ * Draws histograms with the PRIMITIVES_RENDERER
+ * @see #drawHistograms
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::drawPrimitiveHistograms()
+{
+	// drawing frame no longer contains raster compositing
+	rasterValid = false;
+
+	/*
+	 * Display bins: when there are more bins than drawing columns,
+	 * consecutive bins are gathered in the same display bin
+	 */
+	size_t displayBins = (bins < histWidth ? bins : histWidth);
+	float curveStep = (float) histWidth / (float) displayBins;
+	vector<float *> * valuesPtr;
+	float max;
+	if (showCumulative)
+	{
+		valuesPtr = &cumulHistograms;
+		max = cMaxValue;
+	}
+	else
+	{
+		valuesPtr = &histograms;
+		max = maxValue;
+	}
+
+	// Fill the drawing frame with black
+	rectangle(histDisplayFrame,
+			  Point(0, 0),
+			  Point(histWidth - 1, histHeight - 1),
+			  Scalar(0x00, 0x00, 0x00, 0x00),
+			  CV_FILLED);
+
+	// Draw the bins (reversed)
+	for (size_t h = 0; h < nbHistograms; h++)
+	{
+		// fills this color histogram frame with black
+		rectangle(histComponents[h],
+				  Point(0, 0),
+				  Point(histWidth - 1, histHeight - 1),
+				  Scalar(0x00, 0x00, 0x00, 0x00),
+				  CV_FILLED);
+
+		// if this color histogram should be drawn
+		if (showComponent[h])
+		{
+			const float * values = (*valuesPtr)[h];
+			for (size_t d = 0; d < displayBins; d++)
+			{
+				// highest population of the bins gathered in this display bin
+				size_t first = (d * bins) / displayBins;
+				size_t last = ((d + 1) * bins) / displayBins;
+				float value = values[first];
+				for (size_t i = first + 1; i < last; i++)
+				{
+					if (values[i] > value)
+					{
+						value = values[i];
+					}
+				}
+
+				// draws each display bin (reversed) in this color hist. frame
+				rectangle(
+					histComponents[h], // the image to draw in
+					Point(d * curveStep,
+						  histHeight - 1),	 // first corner of this bin
+					Point((d + 1) * curveStep, // second corner of this bin
+						  histHeight - 1 -
+							  cvRound((value / max) * histHeight)),
+					displayColors[h], // current color
+					CV_FILLED,		  // filled rectangle
+					CV_AA);			  // antialiased line
+			}
+			// adds this color histogram frame to the drawing frame
+			add(histDisplayFrame, histComponents[h], histDisplayFrame);
+		}
+	}
+}
+
+/*
+ * Draws selected transfert function in drawing frame and returns the
+ * drawing frame
+ * @param lut the LUT to draw : the LUT may contains 1 or several
+ * channels
+ * @return the updated drawing frame
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::drawTransfertFunc(const Mat * lut)
+{
+	/*
+	 * LUT is sampled on each drawing column when there are more bins than
+	 * drawing columns
+	 */
+	size_t displayBins = (bins < lutWidth ? bins : lutWidth);
+	float curveStep = (float) lutWidth / (float) displayBins;
+	float range = (float) levels;
+
+	const Mat * currentLUT;
+
+	if (lut != NULL)
+	{
+		currentLUT = lut;
+	}
+	else // identity LUT should be computed
+	{
+		currentLUT = computeLinearGrayLUT();
+	}
+
+	size_t lutChannels = (size_t) currentLUT->channels();
+
+	// Fill the drawing frame with black
+	rectangle(lutDisplayFrame,
+			  Point(0, 0),
+			  Point(lutWidth - 1, lutHeight - 1),
+			  Scalar(0x00, 0x00, 0x00, 0x00),
+			  CV_FILLED);
+
+	// Draw the bins (reversed)
+	if (lutChannels == 1)
+	{
+		// draws directly in histDisplayFrame with white color
+		for (size_t d = 0; d < displayBins; d++)
+		{
+			size_t i = (d * bins) / displayBins;
+			rectangle(
+				lutDisplayFrame,					 // the image to draw in
+				Point(d * curveStep, lutHeight - 1), // first corner of this bin
+				Point((d + 1) * curveStep, // second corner of this bin
+					  lutHeight - 1 -
+						  cvRound(((float) currentLUT->at<T>(0, i) / range) *
+								  lutHeight)),
+				displayColors[3], // current color
+				CV_FILLED,		  // filled rectangle
+				CV_AA);			  // antialiased line
+		}
+	}
+	else // lutChannels == 3 or others
+	{
+		// draws in each colorLUTFrams and adds it to histDisplayFrame
+		for (size_t c = 0; c < lutChannels; c++)
+		{
+			if (showComponent[c])
+			{
+				// Fill the color drawing frame with black
+				rectangle(lutComponents[c],
+						  Point(0, 0),
+						  Point(lutWidth - 1, lutHeight - 1),
+						  Scalar(0x00, 0x00, 0x00, 0x00),
+						  CV_FILLED);
+
+				for (size_t d = 0; d < displayBins; d++)
+				{
+					size_t i = (d * bins) / displayBins;
+					rectangle(lutComponents[c], // the image to draw in
+						Point(d * curveStep,
+							  lutHeight - 1), // first corner of this bin
+						Point((d + 1) * curveStep, // second corner of this bin
+							  lutHeight - 1 -
+							  cvRound(((float)
+									   currentLUT->at<Vec<T, channels> >(0, i)[c] / range) *
+									lutHeight)),
+						displayColors[c], // current color
+						CV_FILLED,		  // filled rectangle
+						CV_AA);			  // antialiased line
+				}
+				add(lutDisplayFrame, lutComponents[c], lutDisplayFrame);
+			}
+		}
+	}
+}
+
+/*
+ * Indicates if LUT has been updated or if it has not changed
+ * @return true if LUT has been updated
+ */
+template <typename T, size_t channels>
+bool CvHistograms<T, channels>::isLUTUpdated() const
+{
+	return lutUpdated;
+}
+
+/*
+ * Gets the current LUT type
+ * @return the current LUT type
+ */
+template <typename T, size_t channels>
+typename CvHistograms<T, channels>::TransfertType
+CvHistograms<T, channels>::getLutType() const
+{
+	return lutType;
+}
+
+/*
+ * Sets the current LUT type
+ * @param lutType the new LUT type
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setLutType(const TransfertType lutType)
+{
+	computeLUTTime = 0;
+	drawLUTTime = 0;
+	applyLUTTime = 0;
+	updateHistogramTime2 = 0;
+
+	if (lutType < NBTRANS)
+	{
+		this->lutType = lutType;
+	}
+	else
+	{
+		this->lutType = NONE;
+	}
+}
+
+/*
+ * Gets the tolerance of histograms changes before histograms
+ * depending LUTs are recomputed
+ * @return the LUT tolerance
+ */
+template <typename T, size_t channels>
+float CvHistograms<T, channels>::getLUTTolerance() const
+{
+	return lutTolerance;
+}
+
+/*
+ * Sets the tolerance of histograms changes before histograms
+ * depending LUTs are recomputed
+ * @param tolerance the mean L1 distance between normalized
+ * cumulative histograms above which LUTs are recomputed (0 recomputes
+ * LUTs on every change)
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setLUTTolerance(const float tolerance)
+{
+	lutTolerance = (tolerance > 0.0 ? tolerance : 0.0);
+}
+
+/*
+ * Gets the number of tiles columns used by LOCAL_EQUALIZE
+ * @return the number of tiles columns
+ */
+template <typename T, size_t channels>
+size_t CvHistograms<T, channels>::getLocalTilesX() const
+{
+	return localTilesX;
+}
+
+/*
+ * Gets the number of tiles rows used by LOCAL_EQUALIZE
+ * @return the number of tiles rows
+ */
+template <typename T, size_t channels>
+size_t CvHistograms<T, channels>::getLocalTilesY() const
+{
+	return localTilesY;
+}
+
+/*
+ * Sets the tiles grid used by LOCAL_EQUALIZE
+ * @param tilesX the number of tiles columns (at least 1 and at
+ * most the image width)
+ * @param tilesY the number of tiles rows (at least 1 and at most
+ * the image height)
+ * @post all tiles LUTs will be recomputed
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setLocalTiles(const size_t tilesX,
+											  const size_t tilesY)
+{
+	localTilesX = (tilesX > 1 ? tilesX : 1);
+	localTilesY = (tilesY > 1 ? tilesY : 1);
+
+	resetLocalTiles();
+}
+
+/*
+ * Gets the LOCAL_EQUALIZE histograms clip limit
+ * @return the clip limit relative to the mean bin population
+ */
+template <typename T, size_t channels>
+float CvHistograms<T, channels>::getLocalClipLimit() const
+{
+	return localClipLimit;
+}
+
+/*
+ * Sets the LOCAL_EQUALIZE histograms clip limit
+ * @param limit the clip limit relative to the mean bin population
+ * (values below 1 are clamped to 1)
+ * @post all tiles LUTs will be recomputed
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setLocalClipLimit(const float limit)
+{
+	localClipLimit = (limit > 1.0 ? limit : 1.0);
+	localRebuild = true;
+}
+
+/*
+ * Gets the LOCAL_EQUALIZE tiles LUTs caching tolerance
+ * @return the fraction of a tile population which has to change
+ * before its LUT is recomputed
+ */
+template <typename T, size_t channels>
+float CvHistograms<T, channels>::getLocalTolerance() const
+{
+	return localTolerance;
+}
+
+/*
+ * Sets the LOCAL_EQUALIZE tiles LUTs caching tolerance
+ * @param tolerance the fraction of a tile population which has to
+ * change before its LUT is recomputed (0 recomputes tiles LUTs on
+ * every change)
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setLocalTolerance(const float tolerance)
+{
+	localTolerance = (tolerance > 0.0 ? tolerance : 0.0);
+}
+
+/*
+ * Gets the current parameter value for LUTs using a percentage parameter
+ * @return the current LUT parameter
+ */
+template <typename T, size_t channels>
+float CvHistograms<T, channels>::getLUTParam() const
+{
+	return lutParam;
+}
+
+/*
+ * Sets the current LUT % parameter
+ * @param lutParam the new LUT parameter
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::setLUTParam(const float currentParam)
+{
+	if (currentParam > maxParam)
+	{
+		this->lutParam = maxParam;
+	}
+	else if (currentParam < minParam)
+	{
+		this->lutParam = minParam;
+	}
+	else
+	{
+		this->lutParam = currentParam;
+	}
+}
+
+/*
+ * Return processor processing time of step index [default implementation
+ * returning only processTime, should be reimplemented in subclasses]
+ * @param index index of the step which processing time is required,
+ * 0 indicates all steps, and values above 0 indicates step #. If
+ * required index is bigger than number of steps than all steps value
+ * should be returned.
+ * @return the processing time of step index.
+ * @note should be reimplemented in subclasses in order to define
+ * time/feature behaviour
+ */
+template <typename T, size_t channels>
+double CvHistograms<T, channels>::getProcessTime(const size_t index) const
+{
+	switch (index)
+	{
+		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM):
+			return (double) updateHistogramTime1;
+		case (CvHistograms<T, channels>::COMPUTE_LUT):
+			return (double) computeLUTTime;
+		case (CvHistograms<T, channels>::DRAW_LUT):
+			return (double) drawLUTTime;
+		case (CvHistograms<T, channels>::APPLY_LUT):
+			return (double) applyLUTTime;
+		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM_AFTER_LUT):
+			return (double) updateHistogramTime2;
+		case (CvHistograms<T, channels>::DRAW_HISTOGRAM):
+			return (double) drawHistogramTime;
+		default:
+			return (double) processTime;
+	}
+}
+
+/*
+ * Return processor mean processing time of step index [default
+ * implementation returning only processTime, should be reimplemented
+ * in subclasses]
+ * @param index index of the step which processing time is required,
+ * 0 indicates all steps, and values above 0 indicates step #. If
+ * required index is bigger than number of steps than all steps value
+ * should be returned.
+ * @return the mean processing time of step index.
+ * @note should be reimplemented in subclasses in order to define
+ * time/feature behaviour
+ * @param index
+ */
+template <typename T, size_t channels>
+double CvHistograms<T, channels>::getMeanProcessTime(const size_t index) const
+{
+	switch (index)
+	{
+		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM):
+			return (double) meanUpdateHistogramTime1.mean();
+		case (CvHistograms<T, channels>::COMPUTE_LUT):
+			return (double) meanComputeLUTTime.mean();
+		case (CvHistograms<T, channels>::DRAW_LUT):
+			return (double) meanDrawLUTTime.mean();
+		case (CvHistograms<T, channels>::APPLY_LUT):
+			return (double) meanApplyLUTTime.mean();
+		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM_AFTER_LUT):
+			return (double) meanUpdateHistogramTime2.mean();
+		case (CvHistograms<T, channels>::DRAW_HISTOGRAM):
+			return (double) meanDrawHistogramTime.mean();
+		default:
+			return (double) meanProcessTime.mean();
+	}
+}
+
+/*
+ * Return processor processing time std of step index [default
+ * implementation returning only processTime, should be reimplemented
+ * in subclasses]
+ * @param index index of the step which processing time is required,
+ * 0 indicates all steps, and values above 0 indicates step #. If
+ * required index is bigger than number of steps than all steps value
+ * should be returned.
+ * @return the mean processing time of step index.
+ * @note should be reimplemented in subclasses in order to define
+ * time/feature behaviour
+ * @param index
+ */
+template <typename T, size_t channels>
+double CvHistograms<T, channels>::getStdProcessTime(const size_t index) const
+{
+	switch (index)
+	{
+		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM):
+			return (double) meanUpdateHistogramTime1.std();
+		case (CvHistograms<T, channels>::COMPUTE_LUT):
+			return (double) meanComputeLUTTime.std();
+		case (CvHistograms<T, channels>::DRAW_LUT):
+			return (double) meanDrawLUTTime.std();
+		case (CvHistograms<T, channels>::APPLY_LUT):
+			return (double) meanApplyLUTTime.std();
+		case (CvHistograms<T, channels>::UPDATE_HISTOGRAM_AFTER_LUT):
+			return (double) meanUpdateHistogramTime2.std();
+		case (CvHistograms<T, channels>::DRAW_HISTOGRAM):
+			return (double) meanDrawHistogramTime.std();
+		default:
+			return (double) meanProcessTime.std();
+	}
+}
+
+/*
+ * Reset mean and std process time in order to re-start computing
+ * new mean and std process time values.
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::resetMeanProcessTime()
+{
+	CvProcessor::resetMeanProcessTime();
+	meanUpdateHistogramTime1.reset();
+	meanComputeLUTTime.reset();
+	meanDrawLUTTime.reset();
+	meanApplyLUTTime.reset();
+	meanUpdateHistogramTime2.reset();
+	meanDrawHistogramTime.reset();
+}
+
+/*
+ * Benchmarks counting engines on an image: mean histogram update
+ * time of the ITERATOR_KERNEL and of the BANKED_KERNEL (sequential
+ * and parallel) and max bin difference with the ITERATOR_KERNEL
+ * histograms.
+ * @param image the image to count (of type T with channels channels)
+ * @param out the stream to print results on
+ * @param iterations the number of timed updates of each engine
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::benchmark(Mat * image,
+										  ostream & out,
+										  const int iterations)
+{
+	CV_Assert(image != NULL &&
+			  image->depth() == DataType<T>::depth &&
+			  image->channels() == (int) channels);
+
+	const int nbEngines = 3;
+	const HistogramKernel kernels[nbEngines] =
+	{
+		ITERATOR_KERNEL,
+		BANKED_KERNEL,
+		BANKED_KERNEL
+	};
+	const int threads[nbEngines] = {1, 1, getNumberOfCPUs()};
+	const char * names[nbEngines] = {"iterator", "banked", "parallel"};
+	double tickPeriod = 1000.0 / getTickFrequency(); // in ms
+
+	CvHistograms<T, channels> reference(image);
+	reference.setHistogramKernel(ITERATOR_KERNEL);
+	reference.updateHistogram();
+
+	CvHistograms<T, channels> histogram(image);
+
+	out << "Histograms counting benchmark on " << image->cols << "x"
+		<< image->rows << " " << channels << " channel(s) image with "
+		<< histogram.bins << " bins: mean update time (ms)" << endl;
+	out << setw(10) << "engine" << setw(9) << "threads" << setw(10) << "time"
+		<< setw(11) << "Mpixels/s" << setw(10) << "max diff" << endl;
+
+	for (int e = 0; e < nbEngines; e++)
+	{
+		histogram.setHistogramKernel(kernels[e]);
+		histogram.setParallel(threads[e]);
+
+		// warm up
+		histogram.updateHistogram();
+
+		int64 start = getTickCount();
+		for (int i = 0; i < iterations; i++)
+		{
+			histogram.updateHistogram();
+		}
+		double time = (getTickCount() - start) * tickPeriod /
+			(double) iterations;
+
+		float maxDiff = 0.0;
+		for (size_t i = 0; i < histogram.nbHistograms; i++)
+		{
+			for (size_t j = 0; j < histogram.bins; j++)
+			{
+				float diff = fabs(histogram.histograms[i][j] -
+								  reference.histograms[i][j]);
+				if (diff > maxDiff)
+				{
+					maxDiff = diff;
+				}
+			}
+		}
+
+		out << setw(10) << names[e] << setw(9) << histogram.getParallel()
+			<< setw(10) << fixed << setprecision(3) << time
+			<< setw(11) << fixed << setprecision(1)
+			<< (double) image->total() / (time * 1000.0)
+			<< setw(10) << fixed << setprecision(0) << maxDiff << endl;
+	}
+}
+
+/*
+ * Benchmarks luminance histogram counting on a BGR image: mean
+ * update time without and with luminance counted in the same pass,
+ * mean time of a color pass followed by cvtColor(..., CV_BGR2GRAY)
+ * and a gray pass, and max bin difference between the luminance
+ * histogram and the cvtColor gray image histogram.
+ * @param image the BGR image to count (of type T)
+ * @param out the stream to print results on
+ * @param iterations the number of timed updates of each method
+ * @pre channels == 3
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::benchmarkGray(Mat * image,
+											  ostream & out,
+											  const int iterations)
+{
+	CV_Assert(channels == 3 &&
+			  image != NULL &&
+			  image->depth() == DataType<T>::depth &&
+			  image->channels() == (int) channels);
+
+	double tickPeriod = 1000.0 / getTickFrequency(); // in ms
+
+	CvHistograms<T, channels> colorOnly(image, false);
+	CvHistograms<T, channels> withGray(image, true);
+
+	// warm up
+	colorOnly.updateHistogram();
+	withGray.updateHistogram();
+
+	int64 start = getTickCount();
+	for (int i = 0; i < iterations; i++)
+	{
+		colorOnly.updateHistogram();
+	}
+	double colorTime = (getTickCount() - start) * tickPeriod /
+		(double) iterations;
+
+	start = getTickCount();
+	for (int i = 0; i < iterations; i++)
+	{
+		withGray.updateHistogram();
+	}
+	double fusedTime = (getTickCount() - start) * tickPeriod /
+		(double) iterations;
+
+	// Luminance through cvtColor then counted in a separate pass
+	const size_t bins = withGray.bins;
+	const int binShift = withGray.binShift;
+	vector<float> grayHistogram(bins);
+	Mat gray;
+
+	start = getTickCount();
+	for (int i = 0; i < iterations; i++)
+	{
+		colorOnly.updateHistogram();
+		cvtColor(*image, gray, CV_BGR2GRAY);
+		grayHistogram.assign(bins, 0.0f);
+		for (int r = 0; r < gray.rows; r++)
+		{
+			const T * row = gray.ptr<T>(r);
+			for (int c = 0; c < gray.cols; c++)
+			{
+				grayHistogram[(size_t) row[c] >> binShift]++;
+			}
+		}
+	}
+	double separateTime = (getTickCount() - start) * tickPeriod /
+		(double) iterations;
+
+	float maxDiff = 0.0;
+	const float * luminance = withGray.histograms[channels];
+	for (size_t j = 0; j < bins; j++)
+	{
+		float diff = fabs(luminance[j] - grayHistogram[j]);
+		if (diff > maxDiff)
+		{
+			maxDiff = diff;
+		}
+	}
+
+	out << "Luminance histogram benchmark on " << image->cols << "x"
+		<< image->rows << " image: mean update time (ms)" << endl;
+	out << setw(34) << "color pass: " << fixed << setprecision(3)
+		<< colorTime << endl;
+	out << setw(34) << "color + luminance pass: " << fixed
+		<< setprecision(3) << fusedTime << endl;
+	out << setw(34) << "color pass + cvtColor + gray pass: " << fixed
+		<< setprecision(3) << separateTime << endl;
+	out << setw(34) << "max diff with cvtColor histogram: " << fixed
+		<< setprecision(0) << maxDiff << endl;
+}
+
+/*
+ * Benchmarks histograms rendering engines: mean drawing time of
+ * the PRIMITIVES_RENDERER and of the RASTER_RENDERER while
+ * histograms alternate between the ones of an image and the ones
+ * of a brightened copy of this image.
+ * @param image the image to count (of type T with channels channels)
+ * @param out the stream to print results on
+ * @param iterations the number of timed drawings of each engine
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::benchmarkDraw(Mat * image,
+											  ostream & out,
+											  const int iterations)
+{
+	CV_Assert(image != NULL &&
+			  image->depth() == DataType<T>::depth &&
+			  image->channels() == (int) channels);
+
+	const HistogramRenderer renderers[2] =
+	{
+		PRIMITIVES_RENDERER,
+		RASTER_RENDERER
+	};
+	const char * names[2] = {"primitives", "raster"};
+	double tickPeriod = 1000.0 / getTickFrequency(); // in ms
+
+	// frames alternately counted: histograms change on every drawing
+	Mat frames[2];
+	frames[0] = image->clone();
+	image->convertTo(frames[1], -1, 1.0, (double) (levels / 32));
+	Mat frame = image->clone();
+
+	CvHistograms<T, channels> histogram(&frame);
+
+	out << "Histograms drawing benchmark on " << histogram.histWidth << "x"
+		<< histogram.histHeight << " frame with " << histogram.bins
+		<< " bins: mean drawing time (ms)" << endl;
+	out << setw(12) << "renderer" << setw(10) << "time" << endl;
+
+	for (int r = 0; r < 2; r++)
+	{
+		histogram.setHistogramRenderer(renderers[r]);
+
+		// warm up
+		histogram.updateHistogram();
+		histogram.drawHistograms();
+
+		int64 ticks = 0;
+		for (int i = 0; i < iterations; i++)
+		{
+			frames[(i + 1) % 2].copyTo(frame);
+			histogram.updateHistogram();
+
+			int64 start = getTickCount();
+			histogram.drawHistograms();
+			ticks += getTickCount() - start;
+		}
+
+		out << setw(12) << names[r] << setw(10) << fixed << setprecision(3)
+			<< ticks * tickPeriod / (double) iterations << endl;
+	}
+}
+
+/*
+ * Compute linear transfert function (LUT) : no change in image levels
+ * @return the LUT containing the corresponding transfert function,
+ * the returned matrix contains only one channel corresponding to
+ * the graylevel LUT which should be applied to all color channels of
+ * the image
+ * @post the result is stored in monoTransfertFunc
+ * @note It's useless to compute a color Linear LUT since all channels
+ * would contain the exact same values.
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeLinearGrayLUT()
+{
+	for (size_t i = 0; i < bins; i++)
+	{
+		monoTransfertFunc.at<T>(0, i) = (T) (i << binShift);
+	}
+
+	return &monoTransfertFunc;
+}
+
+/*
+ * Compute linear transfert function (LUT) : no change in image levels
+ * @return the LUT containing the corresponding transfert function,
+ * the returned matrix contains 3 channels corresponding to
+ * the color LUT which should be applied to all color channels of
+ * the image
+ * @post the result is stored in colorTransfertFunc
+ * @note It's useless to compute a color Linear LUT since all channels
+ * would contain the exact same values.
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeLinearColorLUT()
+{
+	for (size_t c = 0; c < channels; c++)
+	{
+		for (size_t i = 0; i < bins; i++)
+		{
+			colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = (T) (i << binShift);
+		}
+	}
+
+	return &colorTransferFunc;
 }
 
 /*
@@ -1001,516 +2497,1103 @@ Mat * CvHistograms<T, channels>::computeLinearColorLUT()
  * the graylevel LUT which should be applied to all color channels of
  * the image
  * @post the result is stored in monoTransfertFunc
- * 			^
- * maxVal	|           ________
- * 			|          /
- * 			|         /
- * 			|        /         dy/dx = (maxVal-minVal) / (maxThresIndex - minthresIndex - 1)
- * 			|       /
- * 			|      /
- * minVal	|_____/     maxThresIndex
- * 			+----+------+------------->
- * 	 minThresIndex
+ * 			^
+ * maxVal	|           ________
+ * 			|          /
+ * 			|         /
+ * 			|        /         dy/dx = (maxVal-minVal) / (maxThresIndex - minthresIndex - 1)
+ * 			|       /
+ * 			|      /
+ * minVal	|_____/     maxThresIndex
+ * 			+----+------+------------->
+ * 	 minThresIndex
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeGrayOptimalLUT(const unsigned int percentDynamic)
+{
+	if (computeGray && nbHistograms == 4)
+	{
+		float threshold = (100 - percentDynamic) / 200.0;
+		float imageSize = sourceImage->rows * sourceImage->cols;
+		float minThres = imageSize * threshold;
+		float maxThres = imageSize - minThres;
+
+		size_t minThresIndex = 0;
+		size_t maxThresIndex = bins;
+
+		T minVal = 0;
+		T maxVal = numeric_limits<T>::max(); // 255 for uchar
+        size_t i;
+		// finds minThresIndex in cumulHistograms[HIST_GRAY][i=0..bins]
+		// TODO à compléter ...
+        for(i=0; i<bins; i++){
+            if(cumulHistograms[HIST_GRAY][i]>minThres){
+                minThresIndex = i;
+                break;
+            }
+        }
+
+		// finds maxThresIndex in cumulHistograms[HIST_GRAY][i=0..bins]
+		// TODO à compléter ...
+        for(i=0; i<bins; i++){
+            if(cumulHistograms[HIST_GRAY][i]>maxThres){
+                maxThresIndex = i;
+                break;
+            }
+        }
+
+		// fill monoTransfertFunc before minThresIndex with minVal
+		// TODO à compléter ...
+        for(size_t j=0; j<minThresIndex; j++){
+            monoTransfertFunc.at<T>(0,j) = minVal;
+        }
+
+		// fill monoTransfertFunc between minThresIndex and maxThesIndex with Dy/Dx Values
+		float slope = (float)(maxVal - minVal) /
+					  (float)(maxThresIndex-1-minThresIndex);
+
+		// TODO à compléter ...
+        for(size_t s=minThresIndex; s<maxThresIndex; s++){
+            monoTransfertFunc.at<T>(0,s) = (s-minThresIndex)*slope;
+        }
+
+		// fill monoTransfertFunc after maxThresIndex with maxVal
+		// TODO à compléter ...
+        for(size_t k=maxThresIndex; k<bins; k++){
+            monoTransfertFunc.at<T>(0,k) = maxVal;
+        }
+
+	}
+	else
+	{
+		cerr << "CvHistograms<T,channels>::computeGrayOptimalLUT : "
+			 << "There is no gray histogram !" << endl;
+	}
+
+	return &monoTransfertFunc;
+}
+
+/*
+ * Compute the optimal dynamic LUTs (one for each channel) for preserving
+ * "percentDynamic" percent of the whole image color ranges.
+ * @param percentDynamic the colors level percentage to spread on the
+ * whole (100%) colors level range in the image
+ * @return the LUT containing the corresponding transfert functions,
+ * the returned matrix contains as much channels as the image and
+ * corresponding to the color level LUT which should be applied to
+ * each color channels of the image
+ * @post the result is stored in colorTransfertFunc
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeColorOptimalLUT(const unsigned int percentDynamic)
+{
+	float threshold = (1 - (percentDynamic / 100.0)) / 2.0;
+	float imageSize = sourceImage->rows * sourceImage->cols;
+	float minThres = imageSize * threshold;
+	float maxThres = imageSize - minThres;
+
+	size_t minThresIndex[channels];
+	size_t maxThresIndex[channels];
+	T minVal = 0;
+	T maxVal = numeric_limits<T>::max(); // 255 for uchar;
+	float slope[channels];
+
+	for (size_t c = 0; c < channels; c++)
+	{
+		minThresIndex[c] = 0;
+		maxThresIndex[c] = bins;
+
+        size_t i;
+		// finds minThresIndex in cumulHistograms[c][...] for this channel
+		// TODO à compléter ...
+        for(i=0; i<bins; i++){
+            if(cumulHistograms[c][i]>minThres){
+                minThresIndex[c] = i;
+                break;
+            }
+        }
+
+		// finds maxThresIndex in cumulHistograms[c][...] for this channel
+		// TODO à compléter ...
+        for(i=0; i<bins; i++){
+            if(cumulHistograms[c][i]>maxThres){
+                maxThresIndex[c] = i;
+                break;
+            }
+        }
+
+		// fill colorTransferFunc before minThresIndex with minVal
+		// TODO à compléter ...
+
+            for (size_t i = 0; i < minThresIndex[c]; i++)
+            {
+                colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = minVal;
+            }
+
+
+
+		// ramp slope for this channel = Dy/Dx
+		slope[c] = (float)(maxVal - minVal) /
+				   (float)(maxThresIndex[c]-1-minThresIndex[c]);
+
+		// fill colorTransferFunc between minThresIndex and maxThesIndex with regular ramp
+		// TODO à compléter ...
+
+            for (size_t i = minThresIndex[c]; i < maxThresIndex[c]; i++)
+            {
+                colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = (i-minThresIndex[c])*slope[c];
+            }
+
+
+		// fill colorTransferFunc after maxThresIndex with maxVal
+		// TODO à compléter ...
+
+            for (size_t i = maxThresIndex[c]; i < bins; i++)
+            {
+                colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = maxVal;
+            }
+
+	}
+
+	return &colorTransferFunc;
+}
+
+/*
+ * Computes the transfert function corresponding to gray level
+ * equalization
+ * @return the matrix containing the gray level equalization LUT to
+ * apply on the image
+ * @post the result is stored in monoTransfertFunc
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeGrayEqualizeLUT()
+{
+	T maxVal = numeric_limits<T>::max();
+	if (computeGray && nbHistograms == 4)
+	{
+		/*
+		 * Equalisation consists in applying the corresponding cumulative
+		 * histogram (cumulHistograms[HIST_GRAY][i=0..bins] normalized to
+		 * maxVal)
+		 * as a mono transfert function
+		 */
+		// TODO à compléter ...
+        for(i=0; i<bins; i++){
+            normalize(cumulHistograms[HIST_GRAY][i],cumulHistograms[HIST_GREY][i], 0, maxVal, CV_BGR2GREY);
+        }
+
+	}
+	else
+	{
+		cerr << "CvHistograms<T,channels>::computeGrayEqualizeLUT : "
+			 << "There is no gray level histogram" << endl;
+	}
+
+	return &monoTransfertFunc;
+}
+
+/*
+ * Computes the transfert functions corresponding to each channel
+ * level equalization
+ * @return the matrix contaning each channel level equalization LUT to
+ * apply on the image
+ * @post the result is stored in colorTransferFunc
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeColorEqualizeLUT()
+{
+	// 255 for uchar;
+	T maxVal = numeric_limits<T>::max();
+	/*
+	 * Color equalisation consists in applying the corresponding cumulative
+	 * histogram (cumulHistograms[c=0..channels][i=0..bins] normalized to
+	 * maxVal)
+	 * as a color transfert function
+	 */
+	for (size_t c = 0; c < channels; c++)
+	{
+		// TODO à compléter ...
+	}
+
+	return &colorTransferFunc;
+}
+
+/*
+ * Compute the LUT corresponding to thresholded image with tPercent
+ * of the pixel population on each side of the threshold according
+ * to the cumulative gray level histogram
+ * @param tPercent percent of the population on each side of the
+ * threshold
+ * @return the LUT containing the corresponding transfert function,
+ * the returned matrix contains only one channel corresponding to
+ * the graylevel LUT which should be applied to all color channels of
+ * the image
+ * @post the result is stored in monoTransfertFunc
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeGrayOptimalLUT(const unsigned int percentDynamic)
+Mat * CvHistograms<T, channels>::computeGrayThresholdLUT(const float tPercent)
 {
+	T minVal = 0;
+	T maxVal = numeric_limits<T>::max(); // 255 for uchar;
+
 	if (computeGray && nbHistograms == 4)
 	{
-		float threshold = (100 - percentDynamic) / 200.0;
-		float imageSize = sourceImage->rows * sourceImage->cols;
-		float minThres = imageSize * threshold;
-		float maxThres = imageSize - minThres;
+		if (tPercent > 0.0 && tPercent < 100.0)
+		{
+			// determine threshold population count
+			float thresLevel = (float) cMaxValue * (tPercent / 100);
 
-		size_t minThresIndex = 0;
-		size_t maxThresIndex = bins;
+			// initialize thresIndex at any possible value;
+			size_t thresIndex = bins / 2;
 
-		T minVal = 0;
-		T maxVal = numeric_limits<T>::max(); // 255 for uchar
-        size_t i;
-		// finds minThresIndex in cumulHistograms[HIST_GRAY][i=0..bins]
-		// TODO à compléter ...
-        for(i=0; i<bins; i++){
-            if(cumulHistograms[HIST_GRAY][i]>minThres){
-                minThresIndex = i;
-                break;
+			// search for thresLevel in cumulHistograms[HIST_GRAY][i=0..bins]
+			// TODO à compléter ...
+            for(size_t i=0; i<=bins; i++){
+                if(cumulHistograms[HIST_GRAY][i]>thresLevel){
+                    thresIndex = i;
+                    break;
+                }
             }
-        }
 
-		// finds maxThresIndex in cumulHistograms[HIST_GRAY][i=0..bins]
-		// TODO à compléter ...
-        for(i=0; i<bins; i++){
-            if(cumulHistograms[HIST_GRAY][i]>maxThres){
-                maxThresIndex = i;
-                break;
-            }
-        }
+			// apply minVal in monoTransfertFunc to population below threshold index
+			// TODO à compléter ...
+            for(size_t j=0; j<thresIndex; j++){
+                monoTransfertFunc.at<T>(0,j) = minVal;
+            }
+
+			// apply maxVal in monoTransfertFunc to population above threshold index
+			// TODO à compléter ...
+            for(size_t k=thresIndex; k<=bins; k++){
+                monoTransfertFunc.at<T>(0,k) = maxVal;
+            }
+
+		}
+		else
+		{
+			cerr << "CvHistograms<T,channels>::computeGrayThresholdLUT : "
+				 << "percentage should be between 0 and 100 : " << tPercent
+				 << endl;
+		}
+	}
+	else
+	{
+		cerr << "CvHistograms<T,channels>::computeGrayThresholdLUT : "
+			 << "There is no gray level histogram" << endl;
+	}
+
+	return &monoTransfertFunc;
+}
+
+/*
+ * Compute the LUT corresponding to thresholded image with tPercent
+ * of the pixel components population on each side of the
+ * thresholds according to the cumulative color histograms
+ * @param tPercent percent of the population on each side of the
+ * thresholds
+ * @return the matrix contaning each channel level equalization LUT to
+ * apply on the image
+ * @post the result is stored in colorTransferFunc
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeColorThresholdLUT(const float tPercent)
+{
+	T minVal = 0;
+	T maxVal = numeric_limits<T>::max(); // 255 for uchar;
+	size_t mThresIndex[channels];
+
+	if (tPercent > 0.0 && tPercent < 100.0)
+	{
+
+		// determine threshold population count
+		float thresLevel = (float) cMaxValue * (tPercent / 100);
+
+        for (size_t c = 0; c < channels; c++)
+		{
+			// initialize thresIndex at any possible value;
+			size_t thresIndex = bins / 2;
+
+			// search for thresLevel in cumulHistograms[c][i=0..bins]
+			// TODO à compléter ...
+            for(size_t i=0; i<=bins; i++){
+                if(cumulHistograms[c][i]>thresLevel){
+                    thresIndex = i;
+                    break;
+                }
+            }
+
+			mThresIndex[c] = thresIndex;
+
+			// apply minVal in colorTransferFunc to population below threshold index
+			// TODO à compléter ...
+
+                for (size_t i = 0; i < mThresIndex[c]; i++)
+                {
+                    colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = minVal;
+                }
+
+
+			// apply maxVal in colorTransferFunc to population above threshold index
+			// TODO à compléter ...
+
+                for (size_t i = mThresIndex[c]; i < bins; i++)
+                {
+                    colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = maxVal;
+                }
+
+		}
+	}
+	else
+	{
+		cerr << "CvHistograms<T,channels>::computeGrayThresholdLUT : "
+			 << "percentage should be between 0 and 100 : " << tPercent << endl;
+	}
+
+	return &colorTransferFunc;
+}
+
+/*
+ * Compute gamma LUT.
+ * \f$y(k) = x(k)^{\gamma}\f$
+ * @param tPercent
+ * @return the matrix containing the gamma LUT
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeGammaLUT(const float tPercent)
+{
+	/*
+	 * Gamma varies approximately from
+	 * 0.25 when tPercent==0% to 4 when tPercent ==100%
+	 */
+	double gamma = 0.4101 * exp(2.3186 * ((double) tPercent / 100.0)) - 0.2506;
+
+	// Apply (x^gamma)*bins where x=i/bins in monoTransfertFunc
+	// TODO à compléter ...
+
+	return &monoTransfertFunc;
+}
+
+/*
+ * Compute the LUT corresponding to negative image
+ * @return the matrix containing the negative LUT (mono)
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeNegativeLUT()
+{
+	// Apply (bins - 1 -i) in  monoTransfertFunc
+	// TODO à compléter ...
+    T maxVal = numeric_limits<T>::max(); // 255 for uchar
+    for(size_t i=0; i<bins; i++){
+        monoTransfertFunc.at<T>(0, i) = maxVal - (T) (i << binShift);
+    }
+	return &monoTransfertFunc;
+}
+
+/*
+ * Compute and returns the current transfert function to be applied
+ * on the image, eventually with the current LUT parameter
+ * @return the mono or color LUT matrix to apply on the image depending
+ * on the lutType
+ * @see TransfertType
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeLUT()
+{
+	Mat * lut = NULL;
+
+	lutUpdated = true;
+
+	/*
+	 * LUTs depending on histograms are kept as long as histograms used to
+	 * compute them did not change beyond lutTolerance
+	 */
+	bool histogramLUT = (lutType == THRESHOLD_GRAY) ||
+						(lutType == THRESHOLD_COLOR) ||
+						(lutType == DYNAMIC_GRAY) ||
+						(lutType == DYNAMIC_COLOR) ||
+						(lutType == EQUALIZE_GRAY) ||
+						(lutType == EQUALIZE_COLOR);
+
+	if (histogramLUT && (this->lut != NULL) &&
+		(previousLutType == lutType) && (previousLutParam == lutParam) &&
+		!histogramsChanged())
+	{
+		lutUpdated = false;
+		return this->lut;
+	}
+
+	switch (lutType)
+	{
+		case NONE:
+			/*
+			 * Identity LUT does not depend on histogram
+			 */
+			lut = computeCachedLUT();
+			break;
+		case THRESHOLD_GRAY:
+			/*
+			 * LUT to split pixels below param % to black and pixels over
+			 * param % to white based on graylevel cumulative histogram
+			 */
+			lut = computeGrayThresholdLUT(lutParam);
+			break;
+		case THRESHOLD_COLOR:
+			/*
+			 * LUT to split param% of the pixel components to black and
+			 * 100-param% to full B, G or R based on cumulative histograms
+			 * components
+			 */
+			lut = computeColorThresholdLUT(lutParam);
+			break;
+		case DYNAMIC_GRAY:
+			/*
+			 * LUT to spread param% of the pixel levels over 100% of the dynamic
+			 * based on cumulative gray level histogram
+			 */
+			lut = computeGrayOptimalLUT(lutParam);
+			break;
+		case DYNAMIC_COLOR:
+			/*
+			 * LUT to spread param% of the pixel components levels over 100% of
+			 * the dynamic based on cumulative color histograms
+			 */
+			lut = computeColorOptimalLUT(lutParam);
+			break;
+		case EQUALIZE_GRAY:
+			/*
+			 * Gray level histogram equalization LUT
+			 */
+			lut = computeGrayEqualizeLUT();
+			break;
+		case EQUALIZE_COLOR:
+			/*
+			 * Color components histograms equalization LUTs
+			 */
+			lut = computeColorEqualizeLUT();
+			break;
+		case GAMMA:
+			/*
+			 * Gamma LUT does not depend on histogram but only on lutParam
+			 */
+			lut = computeCachedLUT();
+			break;
+		case NEGATIVE:
+			/*
+			 * Negative LUT does not depend on histogram
+			 */
+			lut = computeCachedLUT();
+			break;
+		case LOCAL_EQUALIZE:
+			/*
+			 * Tiles equalization LUTs (only tiles whose histogram changed
+			 * are recomputed)
+			 */
+			lut = computeLocalEqualizeLUT();
+			break;
+		default:
+			cerr << "CvHistograms<T,channels>::applyLUT : unknown LUT" << endl;
+			break;
+	}
+
+	if (histogramLUT)
+	{
+		keepLUTReference();
+	}
 
-		// fill monoTransfertFunc before minThresIndex with minVal
-		// TODO à compléter ...
-        for(size_t j=0; j<minThresIndex; j++){
-            monoTransfertFunc.at<T>(0,j) = minVal;
-        }
+	if ((previousLutType != lutType) || (previousLutParam != lutParam))
+	{
+		resetMeanProcessTime();
+	}
 
-		// fill monoTransfertFunc between minThresIndex and maxThesIndex with Dy/Dx Values
-		float slope = (float)(maxVal - minVal) /
-					  (float)(maxThresIndex-1-minThresIndex);
+	previousLutType = lutType;
+	previousLutParam = lutParam;
 
-		// TODO à compléter ...
-        for(size_t s=minThresIndex; s<maxThresIndex; s++){
-            monoTransfertFunc.at<T>(0,s) = (s-minThresIndex)*slope;
-        }
+	return lut;
+}
 
-		// fill monoTransfertFunc after maxThresIndex with maxVal
-		// TODO à compléter ...
-        for(size_t k=maxThresIndex; k<bins; k++){
-            monoTransfertFunc.at<T>(0,k) = maxVal;
-        }
+/*
+ * Returns the LUT of a type depending only on lutParam (NONE, GAMMA or
+ * NEGATIVE) from the LUTs cache, or computes it and adds it to the cache
+ * @return the mono LUT matrix to apply on the image
+ * @post lutUpdated is false if LUT is the same as the previous one
+ * @post the result is stored in monoTransfertFunc
+ */
+template <typename T, size_t channels>
+Mat * CvHistograms<T, channels>::computeCachedLUT()
+{
+	// only gamma LUT depends on lutParam
+	float param = (lutType == GAMMA ? lutParam : 0.0f);
+
+	// monoTransfertFunc already contains this LUT
+	if ((previousLutType == lutType) &&
+		((lutType != GAMMA) || (previousLutParam == lutParam)))
+	{
+		lutUpdated = false;
+		return &monoTransfertFunc;
+	}
 
+	pair<int, float> key((int) lutType, param);
+	typename map<pair<int, float>, Mat>::const_iterator it =
+		lutCache.find(key);
+
+	if (it != lutCache.end())
+	{
+		it->second.copyTo(monoTransfertFunc);
 	}
 	else
 	{
-		cerr << "CvHistograms<T,channels>::computeGrayOptimalLUT : "
-			 << "There is no gray histogram !" << endl;
+		switch (lutType)
+		{
+			case GAMMA:
+				computeGammaLUT(lutParam);
+				break;
+			case NEGATIVE:
+				computeNegativeLUT();
+				break;
+			default:
+				computeLinearGrayLUT();
+				break;
+		}
+
+		if (lutCache.size() >= maxCachedLUTs)
+		{
+			lutCache.clear();
+		}
+		lutCache[key] = monoTransfertFunc.clone();
 	}
 
 	return &monoTransfertFunc;
 }
 
 /*
- * Compute the optimal dynamic LUTs (one for each channel) for preserving
- * "percentDynamic" percent of the whole image color ranges.
- * @param percentDynamic the colors level percentage to spread on the
- * whole (100%) colors level range in the image
- * @return the LUT containing the corresponding transfert functions,
- * the returned matrix contains as much channels as the image and
- * corresponding to the color level LUT which should be applied to
- * each color channels of the image
- * @post the result is stored in colorTransfertFunc
+ * Checks if cumulative histograms changed since current LUT has been
+ * computed
+ * @return true if the mean L1 distance between normalized cumulative
+ * histograms and the reference cumulative histograms exceeds
+ * lutTolerance
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeColorOptimalLUT(const unsigned int percentDynamic)
+bool CvHistograms<T, channels>::histogramsChanged() const
 {
-	float threshold = (1 - (percentDynamic / 100.0)) / 2.0;
-	float imageSize = sourceImage->rows * sourceImage->cols;
-	float minThres = imageSize * threshold;
-	float maxThres = imageSize - minThres;
-
-	size_t minThresIndex[channels];
-	size_t maxThresIndex[channels];
-	T minVal = 0;
-	T maxVal = numeric_limits<T>::max(); // 255 for uchar;
-	float slope[channels];
-
-	for (size_t c = 0; c < channels; c++)
+	if (cMaxValue <= 0.0)
 	{
-		minThresIndex[c] = 0;
-		maxThresIndex[c] = bins;
-
-        size_t i;
-		// finds minThresIndex in cumulHistograms[c][...] for this channel
-		// TODO à compléter ...
-        for(i=0; i<bins; i++){
-            if(cumulHistograms[c][i]>minThres){
-                minThresIndex[c] = i;
-                break;
-            }
-        }
-
-		// finds maxThresIndex in cumulHistograms[c][...] for this channel
-		// TODO à compléter ...
-        for(i=0; i<bins; i++){
-            if(cumulHistograms[c][i]>maxThres){
-                maxThresIndex[c] = i;
-                break;
-            }
-        }
-
-		// fill colorTransferFunc before minThresIndex with minVal
-		// TODO à compléter ...
-
-            for (size_t i = 0; i < minThresIndex[c]; i++)
-            {
-                colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = minVal;
-            }
-
-
-
-		// ramp slope for this channel = Dy/Dx
-		slope[c] = (float)(maxVal - minVal) /
-				   (float)(maxThresIndex[c]-1-minThresIndex[c]);
-
-		// fill colorTransferFunc between minThresIndex and maxThesIndex with regular ramp
-		// TODO à compléter ...
-
-            for (size_t i = minThresIndex[c]; i < maxThresIndex[c]; i++)
-            {
-                colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = (i-minThresIndex[c])*slope[c];
-            }
+		return true;
+	}
 
+	float distance = 0.0;
+	for (size_t h = 0; h < nbHistograms; h++)
+	{
+		const float * cumul = cumulHistograms[h];
+		const float * reference = lutReference + h * bins;
+		for (size_t b = 0; b < bins; b++)
+		{
+			distance += fabs(cumul[b] - reference[b]);
+		}
+	}
 
-		// fill colorTransferFunc after maxThresIndex with maxVal
-		// TODO à compléter ...
+	distance /= cMaxValue * (float) (bins * nbHistograms);
 
-            for (size_t i = maxThresIndex[c]; i < bins; i++)
-            {
-                colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = maxVal;
-            }
+	return distance > lutTolerance;
+}
 
+/*
+ * Stores current cumulative histograms as reference for
+ * #histogramsChanged
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::keepLUTReference()
+{
+	for (size_t h = 0; h < nbHistograms; h++)
+	{
+		memcpy(lutReference + h * bins, cumulHistograms[h],
+			   bins * sizeof(float));
 	}
-
-	return &colorTransferFunc;
 }
 
 /*
- * Computes the transfert function corresponding to gray level
- * equalization
- * @return the matrix containing the gray level equalization LUT to
- * apply on the image
- * @post the result is stored in monoTransfertFunc
+ * Computes the LOCAL_EQUALIZE tiles histograms and clipped
+ * equalization LUTs (in parallel over tiles). Tiles LUTs are
+ * recomputed only when their histogram changed beyond
+ * localTolerance.
+ * @return the matrix containing the mean of the tiles LUTs (used to
+ * draw the transfert function), tiles LUTs themselves are applied
+ * by #applyLocalLUTs
+ * @post lutUpdated is true if any tile LUT has been recomputed
+ * @post the mean LUT is stored in colorTransferFunc
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeGrayEqualizeLUT()
+Mat * CvHistograms<T, channels>::computeLocalEqualizeLUT()
 {
-	T maxVal = numeric_limits<T>::max();
-	if (computeGray && nbHistograms == 4)
+	if (previousLutType != lutType)
 	{
-		/*
-		 * Equalisation consists in applying the corresponding cumulative
-		 * histogram (cumulHistograms[HIST_GRAY][i=0..bins] normalized to
-		 * maxVal)
-		 * as a mono transfert function
-		 */
-		// TODO à compléter ...
-        for(i=0; i<bins; i++){
-            normalize(cumulHistograms[HIST_GRAY][i],cumulHistograms[HIST_GREY][i], 0, maxVal, CV_BGR2GREY);
-        }
+		localRebuild = true;
+	}
+
+	size_t nbTiles = localTilesX * localTilesY;
 
+	if (parallelThreads > 1)
+	{
+		parallel_for_(Range(0, (int) nbTiles),
+					  TileEqualizer(this),
+					  (double) parallelThreads);
 	}
 	else
 	{
-		cerr << "CvHistograms<T,channels>::computeGrayEqualizeLUT : "
-			 << "There is no gray level histogram" << endl;
+		for (size_t t = 0; t < nbTiles; t++)
+		{
+			equalizeTile(t);
+		}
 	}
 
-	return &monoTransfertFunc;
-}
+	localRebuild = false;
 
-/*
- * Computes the transfert functions corresponding to each channel
- * level equalization
- * @return the matrix contaning each channel level equalization LUT to
- * apply on the image
- * @post the result is stored in colorTransferFunc
- */
-template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeColorEqualizeLUT()
-{
-	// 255 for uchar;
-	T maxVal = numeric_limits<T>::max();
-	/*
-	 * Color equalisation consists in applying the corresponding cumulative
-	 * histogram (cumulHistograms[c=0..channels][i=0..bins] normalized to
-	 * maxVal)
-	 * as a color transfert function
-	 */
-	for (size_t c = 0; c < channels; c++)
+	lutUpdated = false;
+	for (size_t t = 0; t < nbTiles; t++)
 	{
-		// TODO à compléter ...
+		if (localTileUpdated[t])
+		{
+			lutUpdated = true;
+			break;
+		}
+	}
+
+	// mean of tiles LUTs to draw the transfert function
+	if (lutUpdated)
+	{
+		T * meanLUT = colorTransferFunc.ptr<T>(0);
+		for (size_t c = 0; c < channels; c++)
+		{
+			for (size_t b = 0; b < bins; b++)
+			{
+				float sum = 0.0;
+				for (size_t t = 0; t < nbTiles; t++)
+				{
+					sum += localLUTs[((t * channels) + c) * bins + b];
+				}
+				meanLUT[b * channels + c] = saturate_cast<T>(sum / nbTiles);
+			}
+		}
 	}
 
 	return &colorTransferFunc;
 }
 
 /*
- * Compute the LUT corresponding to thresholded image with tPercent
- * of the pixel population on each side of the threshold according
- * to the cumulative gray level histogram
- * @param tPercent percent of the population on each side of the
- * threshold
- * @return the LUT containing the corresponding transfert function,
- * the returned matrix contains only one channel corresponding to
- * the graylevel LUT which should be applied to all color channels of
- * the image
- * @post the result is stored in monoTransfertFunc
+ * Reallocates tiles histograms and LUTs and computes the tiles
+ * blending coefficients of each image row and column for the
+ * current tiles grid
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeGrayThresholdLUT(const float tPercent)
+void CvHistograms<T, channels>::resetLocalTiles()
 {
-	T minVal = 0;
-	T maxVal = numeric_limits<T>::max(); // 255 for uchar;
+	size_t nbCols = sourceImage->cols;
+	size_t nbRows = sourceImage->rows;
 
-	if (computeGray && nbHistograms == 4)
+	// tiles can't be smaller than a pixel
+	if (localTilesX > nbCols)
 	{
-		if (tPercent > 0.0 && tPercent < 100.0)
-		{
-			// determine threshold population count
-			float thresLevel = (float) cMaxValue * (tPercent / 100);
-
-			// initialize thresIndex at any possible value;
-			size_t thresIndex = bins / 2;
-
-			// search for thresLevel in cumulHistograms[HIST_GRAY][i=0..bins]
-			// TODO à compléter ...
-            for(size_t i=0; i<=bins; i++){
-                if(cumulHistograms[HIST_GRAY][i]>thresLevel){
-                    thresIndex = i;
-                    break;
-                }
-            }
+		localTilesX = nbCols;
+	}
+	if (localTilesY > nbRows)
+	{
+		localTilesY = nbRows;
+	}
 
-			// apply minVal in monoTransfertFunc to population below threshold index
-			// TODO à compléter ...
-            for(size_t j=0; j<thresIndex; j++){
-                monoTransfertFunc.at<T>(0,j) = minVal;
-            }
+	size_t nbTiles = localTilesX * localTilesY;
+	size_t tilesSize = nbTiles * channels * bins;
 
-			// apply maxVal in monoTransfertFunc to population above threshold index
-			// TODO à compléter ...
-            for(size_t k=thresIndex; k<=bins; k++){
-                monoTransfertFunc.at<T>(0,k) = maxVal;
-            }
+	delete [] localCounts;
+	delete [] localCachedCounts;
+	delete [] localLUTs;
+	localCounts = new unsigned int[tilesSize];
+	localCachedCounts = new unsigned int[tilesSize];
+	localLUTs = new float[tilesSize];
+	localTileUpdated.assign(nbTiles, 0);
 
+	/*
+	 * Pixels are blended between the two nearest tiles centers of their
+	 * row and column (only the nearest tile is used at image borders)
+	 */
+	float tileWidth = (float) nbCols / (float) localTilesX;
+	localColumns.resize(nbCols);
+	localColumnWeights.resize(nbCols);
+	for (size_t x = 0; x < nbCols; x++)
+	{
+		float position = (((float) x + 0.5f) / tileWidth) - 0.5f;
+		int left = cvFloor(position);
+		float weight = position - (float) left;
+		if (left < 0)
+		{
+			left = 0;
+			weight = 0.0;
 		}
-		else
+		else if (left >= (int) localTilesX - 1)
 		{
-			cerr << "CvHistograms<T,channels>::computeGrayThresholdLUT : "
-				 << "percentage should be between 0 and 100 : " << tPercent
-				 << endl;
+			left = (int) localTilesX - 1;
+			weight = 0.0;
 		}
+		localColumns[x] = (size_t) left;
+		localColumnWeights[x] = weight;
 	}
-	else
+
+	float tileHeight = (float) nbRows / (float) localTilesY;
+	localRows.resize(nbRows);
+	localRowWeights.resize(nbRows);
+	for (size_t y = 0; y < nbRows; y++)
 	{
-		cerr << "CvHistograms<T,channels>::computeGrayThresholdLUT : "
-			 << "There is no gray level histogram" << endl;
+		float position = (((float) y + 0.5f) / tileHeight) - 0.5f;
+		int top = cvFloor(position);
+		float weight = position - (float) top;
+		if (top < 0)
+		{
+			top = 0;
+			weight = 0.0;
+		}
+		else if (top >= (int) localTilesY - 1)
+		{
+			top = (int) localTilesY - 1;
+			weight = 0.0;
+		}
+		localRows[y] = (size_t) top;
+		localRowWeights[y] = weight;
 	}
 
-	return &monoTransfertFunc;
+	localRebuild = true;
 }
 
 /*
- * Compute the LUT corresponding to thresholded image with tPercent
- * of the pixel components population on each side of the
- * thresholds according to the cumulative color histograms
- * @param tPercent percent of the population on each side of the
- * thresholds
- * @return the matrix contaning each channel level equalization LUT to
- * apply on the image
- * @post the result is stored in colorTransferFunc
+ * Counts a tile histograms and recomputes its LUTs if needed
+ * @param tile the tile index (in rows order)
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeColorThresholdLUT(const float tPercent)
+void CvHistograms<T, channels>::equalizeTile(const size_t tile)
 {
-	T minVal = 0;
-	T maxVal = numeric_limits<T>::max(); // 255 for uchar;
-	size_t mThresIndex[channels];
-
-	if (tPercent > 0.0 && tPercent < 100.0)
+	size_t tileX = tile % localTilesX;
+	size_t tileY = tile / localTilesX;
+	size_t firstCol = (tileX * sourceImage->cols) / localTilesX;
+	size_t lastCol = ((tileX + 1) * sourceImage->cols) / localTilesX;
+	size_t firstRow = (tileY * sourceImage->rows) / localTilesY;
+	size_t lastRow = ((tileY + 1) * sourceImage->rows) / localTilesY;
+	size_t tileSize = channels * bins;
+
+	unsigned int * counts = localCounts + tile * tileSize;
+	unsigned int * cached = localCachedCounts + tile * tileSize;
+	float * tileLUTs = localLUTs + tile * tileSize;
+
+	// counts tile histograms
+	memset(counts, 0, tileSize * sizeof(unsigned int));
+	for (size_t y = firstRow; y < lastRow; y++)
 	{
-
-		// determine threshold population count
-		float thresLevel = (float) cMaxValue * (tPercent / 100);
-
-        for (size_t c = 0; c < channels; c++)
+		const T * pixel = sourceImage->ptr<T>(y) + firstCol * channels;
+		for (size_t x = firstCol; x < lastCol; x++, pixel += channels)
 		{
-			// initialize thresIndex at any possible value;
-			size_t thresIndex = bins / 2;
+			for (size_t c = 0; c < channels; c++)
+			{
+				++counts[c * bins + ((size_t) pixel[c] >> binShift)];
+			}
+		}
+	}
 
-			// search for thresLevel in cumulHistograms[c][i=0..bins]
-			// TODO à compléter ...
-            for(size_t i=0; i<=bins; i++){
-                if(cumulHistograms[c][i]>thresLevel){
-                    thresIndex = i;
-                    break;
-                }
-            }
+	float nbPixels = (float) ((lastCol - firstCol) * (lastRow - firstRow));
 
-			mThresIndex[c] = thresIndex;
+	// keeps previous LUTs if histograms did not change enough
+	if (!localRebuild)
+	{
+		uint64_t distance = 0;
+		for (size_t k = 0; k < tileSize; k++)
+		{
+			distance += (counts[k] > cached[k] ?
+						 counts[k] - cached[k] : cached[k] - counts[k]);
+		}
 
-			// apply minVal in colorTransferFunc to population below threshold index
-			// TODO à compléter ...
+		if ((float) distance <= localTolerance * nbPixels * channels)
+		{
+			localTileUpdated[tile] = 0;
+			return;
+		}
+	}
 
-                for (size_t i = 0; i < mThresIndex[c]; i++)
-                {
-                    colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = minVal;
-                }
+	memcpy(cached, counts, tileSize * sizeof(unsigned int));
 
+	/*
+	 * Clipped equalization: populations above clip limit are evenly
+	 * redistributed to all bins before cumulating
+	 */
+	float clip = localClipLimit * nbPixels / (float) bins;
+	if (clip < 1.0)
+	{
+		clip = 1.0;
+	}
+	float maxVal = (float) numeric_limits<T>::max();
 
-			// apply maxVal in colorTransferFunc to population above threshold index
-			// TODO à compléter ...
+	for (size_t c = 0; c < channels; c++)
+	{
+		const unsigned int * h = counts + c * bins;
+		float * tileLUT = tileLUTs + c * bins;
 
-                for (size_t i = mThresIndex[c]; i < bins; i++)
-                {
-                    colorTransferFunc.at<Vec<T, channels> >(0, i)[c] = maxVal;
-                }
+		float excess = 0.0;
+		for (size_t b = 0; b < bins; b++)
+		{
+			if ((float) h[b] > clip)
+			{
+				excess += (float) h[b] - clip;
+			}
+		}
+		float redistributed = excess / (float) bins;
 
+		float cumul = 0.0;
+		for (size_t b = 0; b < bins; b++)
+		{
+			float clipped = ((float) h[b] > clip ? clip : (float) h[b]);
+			cumul += clipped + redistributed;
+			tileLUT[b] = (cumul * maxVal) / nbPixels;
 		}
 	}
-	else
-	{
-		cerr << "CvHistograms<T,channels>::computeGrayThresholdLUT : "
-			 << "percentage should be between 0 and 100 : " << tPercent << endl;
-	}
 
-	return &colorTransferFunc;
+	localTileUpdated[tile] = 1;
 }
 
 /*
- * Compute gamma LUT.
- * \f$y(k) = x(k)^{\gamma}\f$
- * @param tPercent
- * @return the matrix containing the gamma LUT
+ * Parallel loop body computing tiles LUTs with #equalizeTile
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeGammaLUT(const float tPercent)
+class CvHistograms<T, channels>::TileEqualizer : public ParallelLoopBody
 {
-	/*
-	 * Gamma varies approximately from
-	 * 0.25 when tPercent==0% to 4 when tPercent ==100%
-	 */
-	double gamma = 0.4101 * exp(2.3186 * ((double) tPercent / 100.0)) - 0.2506;
+	private:
+		/**
+		 * The histograms to equalize tiles for
+		 */
+		CvHistograms<T, channels> * processor;
 
-	// Apply (x^gamma)*bins where x=i/bins in monoTransfertFunc
-	// TODO à compléter ...
+	public:
+		/**
+		 * Tile equalizer constructor
+		 * @param processor the histograms to equalize tiles for
+		 */
+		TileEqualizer(CvHistograms<T, channels> * processor) :
+			processor(processor)
+		{}
 
-	return &monoTransfertFunc;
-}
+		/**
+		 * Equalizes tiles in range
+		 * @param range the range of tiles to equalize
+		 */
+		void operator()(const Range & range) const
+		{
+			for (int t = range.start; t < range.end; t++)
+			{
+				processor->equalizeTile((size_t) t);
+			}
+		}
+};
 
 /*
- * Compute the LUT corresponding to negative image
- * @return the matrix containing the negative LUT (mono)
+ * Parallel loop body applying tiles LUTs with #applyLocalBand
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeNegativeLUT()
+class CvHistograms<T, channels>::LocalApplier : public ParallelLoopBody
 {
-	// Apply (bins - 1 -i) in  monoTransfertFunc
-	// TODO à compléter ...
-    for(size_t i=0; i<bins; i++){
-        monoTransfertFunc.at<T>(0, i) = bins-i-1;
-    }
-	return &monoTransfertFunc;
-}
+	private:
+		/**
+		 * The histograms to apply tiles LUTs for
+		 */
+		CvHistograms<T, channels> * processor;
+
+		/**
+		 * The number of bands the image is split in
+		 */
+		const size_t nbBands;
+
+	public:
+		/**
+		 * Local applier constructor
+		 * @param processor the histograms to apply tiles LUTs for
+		 * @param nbBands the number of bands the image is split in
+		 */
+		LocalApplier(CvHistograms<T, channels> * processor,
+					 const size_t nbBands) :
+			processor(processor),
+			nbBands(nbBands)
+		{}
+
+		/**
+		 * Applies tiles LUTs to bands in range
+		 * @param range the range of bands to transform
+		 */
+		void operator()(const Range & range) const
+		{
+			for (int b = range.start; b < range.end; b++)
+			{
+				processor->applyLocalBand((size_t) b, nbBands);
+			}
+		}
+};
 
 /*
- * Compute and returns the current transfert function to be applied
- * on the image, eventually with the current LUT parameter
- * @return the mono or color LUT matrix to apply on the image depending
- * on the lutType
- * @see TransfertType
+ * Apply tiles LUTs to the source image to produce the outFrame in a
+ * single pass (in parallel over row bands)
  */
 template <typename T, size_t channels>
-Mat * CvHistograms<T, channels>::computeLUT()
+void CvHistograms<T, channels>::applyLocalLUTs()
 {
-	Mat * lut = NULL;
+	outDisplayFrame.create(sourceImage->size(), sourceImage->type());
 
-	lutUpdated = true;
+	size_t nbRows = sourceImage->rows;
+	size_t nbBands = (parallelThreads < nbRows ? parallelThreads : nbRows);
 
-	switch (lutType)
+	if (nbBands > 1)
 	{
-		case NONE:
-			/*
-			 * Identity LUT
-			 * Linear LUT does not depend on histogram so if previous
-			 * LUT was already Linear then don't compute it again, just
-			 * return the last LUT
-			 */
-			if (previousLutType != lutType)
+		parallel_for_(Range(0, (int) nbBands),
+					  LocalApplier(this, nbBands),
+					  (double) nbBands);
+	}
+	else
+	{
+		applyLocalBand(0, 1);
+	}
+}
+
+/*
+ * Applies tiles LUTs to a band of rows: each pixel component is
+ * transformed by the four nearest tiles LUTs blended bilinearly
+ * @param band the band index in [0..nbBands - 1]
+ * @param nbBands the number of bands the image is split in
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::applyLocalBand(const size_t band,
+											   const size_t nbBands)
+{
+	size_t nbRows = sourceImage->rows;
+	size_t nbCols = sourceImage->cols;
+	size_t firstRow = (band * nbRows) / nbBands;
+	size_t lastRow = ((band + 1) * nbRows) / nbBands;
+	size_t tileSize = channels * bins;
+	size_t tilesRowSize = localTilesX * tileSize;
+
+	for (size_t y = firstRow; y < lastRow; y++)
+	{
+		size_t top = localRows[y];
+		size_t bottom = (top + 1 < localTilesY ? top + 1 : top);
+		float wy = localRowWeights[y];
+		const float * topLUTs = localLUTs + top * tilesRowSize;
+		const float * bottomLUTs = localLUTs + bottom * tilesRowSize;
+
+		const T * src = sourceImage->ptr<T>(y);
+		T * dst = outDisplayFrame.ptr<T>(y);
+
+		for (size_t x = 0; x < nbCols; x++, src += channels, dst += channels)
+		{
+			size_t left = localColumns[x];
+			size_t right = (left + 1 < localTilesX ? left + 1 : left);
+			float wx = localColumnWeights[x];
+			const float * topLeft = topLUTs + left * tileSize;
+			const float * topRight = topLUTs + right * tileSize;
+			const float * bottomLeft = bottomLUTs + left * tileSize;
+			const float * bottomRight = bottomLUTs + right * tileSize;
+
+			for (size_t c = 0; c < channels; c++)
 			{
-				lut = computeLinearGrayLUT();
+				size_t k = c * bins + ((size_t) src[c] >> binShift);
+				float upper = topLeft[k] + wx * (topRight[k] - topLeft[k]);
+				float lower = bottomLeft[k] +
+							  wx * (bottomRight[k] - bottomLeft[k]);
+				dst[c] = saturate_cast<T>(upper + wy * (lower - upper));
 			}
-			else
+		}
+	}
+}
+
+/*
+ * Interpolates the full range transfert function from a bins LUT.
+ * Values of bin j are linearly interpolated between lut(j) and
+ * lut(j + 1) (extrapolated for the last bin) so that linear LUTs
+ * such as identity or negative are exactly expanded.
+ * @param lut the bins LUT to expand
+ * @post expandedLUT contains levels entries with as many channels
+ * as lut
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::expandLUT(const Mat * lut)
+{
+	size_t lutChannels = (size_t) lut->channels();
+	expandedLUT.create(1, (int) levels, lut->type());
+
+	const T * binValues = lut->ptr<T>(0);
+	T * levelValues = expandedLUT.ptr<T>(0);
+	int step = 1 << binShift;
+
+	for (size_t j = 0; j < bins; j++)
+	{
+		for (size_t c = 0; c < lutChannels; c++)
+		{
+			int low = (int) binValues[j * lutChannels + c];
+			int high;
+			if (j + 1 < bins)
 			{
-				lut = &monoTransfertFunc;
-				lutUpdated = false;
+				high = (int) binValues[(j + 1) * lutChannels + c];
 			}
-			break;
-		case THRESHOLD_GRAY:
-			/*
-			 * LUT to split pixels below param % to black and pixels over
-			 * param % to white based on graylevel cumulative histogram
-			 */
-			lut = computeGrayThresholdLUT(lutParam);
-			break;
-		case THRESHOLD_COLOR:
-			/*
-			 * LUT to split param% of the pixel components to black and
-			 * 100-param% to full B, G or R based on cumulative histograms
-			 * components
-			 */
-			lut = computeColorThresholdLUT(lutParam);
-			break;
-		case DYNAMIC_GRAY:
-			/*
-			 * LUT to spread param% of the pixel levels over 100% of the dynamic
-			 * based on cumulative gray level histogram
-			 */
-			lut = computeGrayOptimalLUT(lutParam);
-			break;
-		case DYNAMIC_COLOR:
-			/*
-			 * LUT to spread param% of the pixel components levels over 100% of
-			 * the dynamic based on cumulative color histograms
-			 */
-			lut = computeColorOptimalLUT(lutParam);
-			break;
-		case EQUALIZE_GRAY:
-			/*
-			 * Gray level histogram equalization LUT
-			 */
-			lut = computeGrayEqualizeLUT();
-			break;
-		case EQUALIZE_COLOR:
-			/*
-			 * Color components histograms equalization LUTs
-			 */
-			lut = computeColorEqualizeLUT();
-			break;
-		case GAMMA:
-			/*
-			 * Gamma LUT does not depend on histogram so if previous
-			 * LUT was already Gamma then don't compute it again, just
-			 * return the last LUT
-			 */
-			if ((previousLutType != lutType) || (previousLutParam != lutParam))
+			else if (j > 0)
 			{
-				lut = computeGammaLUT(lutParam);
+				high = 2 * low - (int) binValues[(j - 1) * lutChannels + c];
 			}
 			else
 			{
-				lut = &monoTransfertFunc;
-				lutUpdated = false;
-			}
-			break;
-		case NEGATIVE:
-			/*
-			 * Negative LUT does not depend on histogram so if previous
-			 * LUT was already Negative then don't compute it again, just
-			 * return the last LUT
-			 */
-			if (previousLutType != lutType)
-			{
-				lut = computeNegativeLUT();
+				high = low;
 			}
-			else
+
+			T * out = levelValues + ((j << binShift) * lutChannels) + c;
+			for (int k = 0; k < step; k++, out += lutChannels)
 			{
-				lut = &monoTransfertFunc;
-				lutUpdated = false;
+				*out = saturate_cast<T>(low +
+					(int) (((int64) (high - low) * k) / step));
 			}
-			break;
-		default:
-			cerr << "CvHistograms<T,channels>::applyLUT : unknown LUT" << endl;
-			break;
+		}
 	}
+}
 
-	if ((previousLutType != lutType) || (previousLutParam != lutParam))
+/*
+ * Apply expandedLUT to the source image to produce the outFrame
+ * (for images which can't be transformed by OpenCV LUT function)
+ * @pre expandedLUT is up to date with the current LUT
+ */
+template <typename T, size_t channels>
+void CvHistograms<T, channels>::applyExpandedLUT()
+{
+	outDisplayFrame.create(sourceImage->size(), sourceImage->type());
+
+	size_t lutChannels = (size_t) expandedLUT.channels();
+	const T * table = expandedLUT.ptr<T>(0);
+	size_t nbRows = sourceImage->rows;
+	size_t rowLength = sourceImage->cols * channels;
+
+	if (sourceImage->isContinuous() && outDisplayFrame.isContinuous())
 	{
-		resetMeanProcessTime();
+		rowLength *= nbRows;
+		nbRows = 1;
 	}
 
-	previousLutType = lutType;
-	previousLutParam = lutParam;
+	for (size_t y = 0; y < nbRows; y++)
+	{
+		const T * src = sourceImage->ptr<T>(y);
+		T * dst = outDisplayFrame.ptr<T>(y);
 
-	return lut;
+		if (lutChannels == 1)
+		{
+			for (size_t x = 0; x < rowLength; x++)
+			{
+				dst[x] = table[src[x]];
+			}
+		}
+		else
+		{
+			for (size_t x = 0; x < rowLength; x += channels)
+			{
+				for (size_t c = 0; c < channels; c++)
+				{
+					dst[x + c] = table[(size_t) src[x + c] * channels + c];
+				}
+			}
+		}
+	}
 }
 
 /*
@@ -1518,13 +3601,41 @@ Mat * CvHistograms<T, channels>::computeLUT()
  * outFrame
  * @return true if LUT has been applied, false if lut is NULL or
  * lutType is NONE
+ * @note LUT is applied through expandedLUT when bins don't map
+ * levels one to one or when T is not 8 bits
  */
 template <typename T, size_t channels>
 bool CvHistograms<T, channels>::drawTransformedImage()
 {
-	if ((lut != NULL) && (lutType != NONE))
+	if ((lut != NULL) && (lutType == LOCAL_EQUALIZE))
+	{
+		applyLocalLUTs();
+		return true;
+	}
+	else if ((lut != NULL) && (lutType != NONE))
 	{
-		LUT(*sourceImage, *lut, outDisplayFrame);
+		if ((sizeof(T) == 1) && (binShift == 0))
+		{
+			LUT(*sourceImage, *lut, outDisplayFrame);
+		}
+		else
+		{
+			// full range LUT is interpolated only when bins LUT changes
+			if (lutUpdated || expandedLUT.empty() ||
+				(expandedLUT.type() != lut->type()))
+			{
+				expandLUT(lut);
+			}
+
+			if (sizeof(T) == 1)
+			{
+				LUT(*sourceImage, expandedLUT, outDisplayFrame);
+			}
+			else
+			{
+				applyExpandedLUT();
+			}
+		}
 		return true;
 	}
 	else
@@ -1570,3 +3681,7 @@ template ostream & operator<<(ostream &, const CvHistograms<uchar, 1> &);
 // for BGR or YUV images
 template class CvHistograms<uchar, 3>;
 template ostream & operator<<(ostream &, const CvHistograms<uchar, 3> &);
+
+// for 16 bits gray level images (such as thermal cameras)
+template class CvHistograms<ushort, 1>;
+template ostream & operator<<(ostream &, const CvHistograms<ushort, 1> &);
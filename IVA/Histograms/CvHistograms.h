@@ -9,6 +9,9 @@
 #define CVHISTOGRAMS_H_
 
 #include <vector>
+#include <map>
+#include <utility>	// for pair
+#include <cstdint>	// for uint64_t
 using namespace std;
 
 #include "CvProcessor.h"
@@ -27,12 +30,13 @@ ostream & operator << (ostream & out, const CvHistograms<T, channels> & h);
  * If image has only one channel, no other histogram are computed.
  * But if image has several channels, each layer has an histogram and an
  * additional histogram corresponding to gray level equivalent image is
- * computed by linear combination of the previously computed histograms.
- * Eventually, linear combination coefficients are used :
- * 	- for RGB images linear combination coefficients are
- * 		- C_red = 0.30
- * 		- C_green = 0.59
- * 		- C_blue = 0.11
+ * computed from the luminance of each pixel (in the same pass as the
+ * other histograms).
+ * Eventually, luminance coefficients are used :
+ * 	- for RGB images luminance coefficients are
+ * 		- C_red = 0.299
+ * 		- C_green = 0.587
+ * 		- C_blue = 0.114
  *	- for YUV images linear combination coefficients are not necessary since
  *	the V component is already a grayscale component
  */
@@ -116,6 +120,14 @@ class CvHistograms : virtual public CvProcessor
 			 * @see CvHistograms<T,channels>::computeNegativeLUT
 			 */
 			NEGATIVE,
+			/**
+			 * Local (tiled) levels equalization with clipped histograms
+			 * (CLAHE): each tile has its own equalization LUTs and pixels
+			 * are transformed by bilinear blending of the LUTs of the four
+			 * nearest tiles.
+			 * @see CvHistograms<T,channels>::computeLocalEqualizeLUT
+			 */
+			LOCAL_EQUALIZE,
 			/**
 			 * Defines the number of available transfert functions.
 			 * Used to toggle between LUTs to apply by using
@@ -140,25 +152,145 @@ class CvHistograms : virtual public CvProcessor
 			NB_PROC_INDEX               //!< Number of processing time indices
 		} ProcessTimeIndex;
 
+		/**
+		 * Counting engines used to update histograms values
+		 * @see #updateHistogram
+		 */
+		typedef enum
+		{
+			/**
+			 * Reference engine: walks the image with a MatConstIterator_ and
+			 * increments float bins (and checks max value) on each pixel
+			 */
+			ITERATOR_KERNEL = 0,
+			/**
+			 * Row pointers engine: counts into several interleaved integer
+			 * sub-histograms per channel, then merges them, computes max
+			 * and cumulative histograms in a reduction pass
+			 */
+			BANKED_KERNEL,
+			/**
+			 * Number of available counting engines
+			 */
+			NBKERNELS
+		} HistogramKernel;
+
+		/**
+		 * Rendering engines used to draw histograms
+		 * @see #drawHistograms
+		 */
+		typedef enum
+		{
+			/**
+			 * Reference engine: clears each component frame, draws each
+			 * bin with OpenCV rectangle primitive and adds components
+			 * frames to the drawing frame
+			 */
+			PRIMITIVES_RENDERER = 0,
+			/**
+			 * Column buffers engine: computes the top of each component bar
+			 * in each drawing column, and composites visible components in
+			 * a single pass over the drawing frame only when a column
+			 * buffer or a component visibility changed
+			 */
+			RASTER_RENDERER,
+			/**
+			 * Number of available rendering engines
+			 */
+			NBRENDERERS
+		} HistogramRenderer;
+
+		/**
+		 * Ways of cumulating histograms over time when time cumulative
+		 * histograms are on
+		 * @see #setTimeCumulative
+		 */
+		typedef enum
+		{
+			/**
+			 * Each new frame is added to the histograms forever
+			 */
+			TIME_UNBOUNDED = 0,
+			/**
+			 * Histograms are the mean histograms of the last timeWindow
+			 * frames: newest frame counts are added and oldest frame
+			 * counts are subtracted
+			 */
+			TIME_WINDOW,
+			/**
+			 * Histograms are exponentially decayed with timeDecay
+			 * \f$h_t = (1 - \alpha) h_{t-1} + \alpha\,counts_t\f$
+			 */
+			TIME_DECAY,
+			/**
+			 * Number of time cumulation modes
+			 */
+			NBTIMEMODES
+		} TimeCumulationMode;
+
 	protected:
 		// --------------------------------------------------------------------
 		// Histograms attributes
 		// --------------------------------------------------------------------
 		/**
 		 * 3 coefficients for additionnal grayscale histogram from RGB image :
-		 * 	- \f$Coef_{red} = 0.30\f$
-		 * 	- \f$Coef_{green} = 0.59\f$
-		 * 	- \f$Coef_{blue} = 0.11\f$
+		 * 	- \f$Coef_{red} = 0.299\f$
+		 * 	- \f$Coef_{green} = 0.587\f$
+		 * 	- \f$Coef_{blue} = 0.114\f$
+		 * (the same as cvtColor(..., CV_BGR2GRAY))
 		 * @note Be aware that OpenCV Color images are ususally encoded in BGR
 		 * format instead of RGB.
 		 */
 		static const float BGR2Gray[];
 
 		/**
-		 * Number of bins in the histogram.
+		 * Number of fractional bits of the fixed point luminance computation
+		 * @see #grayTables
+		 */
+		static const int grayShift = 14;
+
+		/**
+		 * Number of values of type T (256 for uchar, 65536 for 16 bits)
+		 */
+		static const size_t levels;
+
+		/**
+		 * Default maximum number of bins: images with more levels than
+		 * defaultBins (such as 16 bits images) are counted in defaultBins
+		 * bins unless another number of bins is requested.
+		 */
+		static const size_t defaultBins = 1024;
+
+		/**
+		 * Maximum size of the LUT drawing frame
+		 */
+		static const size_t maxLutDrawSize = 256;
+
+		/**
+		 * Maximum number of LUTs in the LUTs cache
+		 */
+		static const size_t maxCachedLUTs = 16;
+
+		/**
+		 * Number of bins in the histogram (a power of two below levels).
 		 * All histogram populations ranges from 0 to bins-1
 		 */
-		static const size_t bins;
+		const size_t bins;
+
+		/**
+		 * Range mapping of values to bins : value v is counted in bin
+		 * \f$v >> binShift\f$ (0 when each level has its own bin)
+		 */
+		const int binShift;
+
+		/**
+		 * Number of interleaved integer sub-histograms (banks) per channel
+		 * used by the BANKED_KERNEL.
+		 * Consecutive pixels are counted in different banks so that two
+		 * identical consecutive values don't increment the same memory
+		 * location (which would stall on store to load forwarding).
+		 */
+		static const size_t nbBanks = 4;
 
 		/**
 		 * Checks whether to compute additionnal gray level histogram
@@ -183,6 +315,19 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		vector<float *> histograms;
 
+		/**
+		 * Fixed point luminance tables: 3 tables of bins values containing
+		 * \f$round(BGR2Gray[l] \times v \times 2^{grayShift})\f$ for each
+		 * channel l and bin v (the rounding offset is added to the first
+		 * table) so that the luminance bin of a BGR pixel is
+		 * \f$(tab_B[b] + tab_G[g] + tab_R[r]) >> grayShift\f$ where b, g
+		 * and r are the bins of its components.
+		 * @note NULL if no gray level histogram is computed
+		 * @note luminance is exact when binShift is 0, otherwise it is
+		 * computed from the components bins.
+		 */
+		int * grayTables;
+
 		/**
 		 * Maximum value found in all histograms
 		 */
@@ -209,6 +354,74 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		bool timeCumulative;
 
+		/**
+		 * Time cumulation mode (used only when timeCumulative is true)
+		 */
+		TimeCumulationMode timeMode;
+
+		/**
+		 * Number of frames in the TIME_WINDOW mode
+		 */
+		size_t timeWindow;
+
+		/**
+		 * Decay factor of the TIME_DECAY mode in ]0..1]: weight of the
+		 * newest frame in the histograms
+		 */
+		float timeDecay;
+
+		/**
+		 * Number of frames cumulated since time cumulation started
+		 */
+		size_t timeFrames;
+
+		/**
+		 * Ring of per frame integer histograms of the TIME_WINDOW mode:
+		 * timeWindow arrays of nbHistograms * bins counters.
+		 * Frame #n counts are stored in windowFrames[n % timeWindow]
+		 */
+		vector<unsigned int *> windowFrames;
+
+		/**
+		 * Integer sums of the frames in windowFrames (nbHistograms * bins
+		 * counters)
+		 */
+		uint64_t * windowSums;
+
+		/**
+		 * Counting engine used to update histograms values
+		 */
+		HistogramKernel kernel;
+
+		/**
+		 * Integer sub-histograms used by the BANKED_KERNEL: one array of
+		 * nbBanks * bins counters per histogram (image channels and evt
+		 * gray level). Bank k of histogram c starts at
+		 * histogramBanks[c][k * bins].
+		 */
+		vector<unsigned int *> histogramBanks;
+
+		/**
+		 * Number of row bands (and threads) used to count pixels with the
+		 * BANKED_KERNEL. 1 means sequential counting.
+		 */
+		size_t parallelThreads;
+
+		/**
+		 * Private integer banks of bands 1 to parallelThreads - 1 (band 0
+		 * uses histogramBanks): nbHistograms arrays of nbBanks * bins
+		 * counters per band. Bank arrays of band b (b > 0) starts at
+		 * partialBanks[(b - 1) * nbHistograms].
+		 */
+		vector<unsigned int *> partialBanks;
+
+		/**
+		 * Temporary histogram (bins values) used to transfer histograms
+		 * through the current LUT
+		 * @see #transferHistogram
+		 */
+		float * transferBuffer;
+
 		// --------------------------------------------------------------------
 		// LUT attributes
 		// --------------------------------------------------------------------
@@ -222,6 +435,15 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		Mat colorTransferFunc;
 
+		/**
+		 * Full range transfert function (levels entries) interpolated from
+		 * the current bins LUT when bins don't map levels one to one or
+		 * when T is not 8 bits (OpenCV LUT function only handles 8 bits
+		 * images).
+		 * @see #expandLUT
+		 */
+		Mat expandedLUT;
+
 		/**
 		 * Current LUT to apply.
 		 * Alternatively receives monoTransfertFunc or colorTransferFunc address
@@ -235,8 +457,9 @@ class CvHistograms : virtual public CvProcessor
 		TransfertType lutType;
 
 		/**
-		 * Previous LUT type. Used to avoid recomputing LUTs that does not
-		 * depend on image histogram such as NONE, GAMMA and NEGATIVE
+		 * Previous LUT type (type of the last computed LUT). Used to avoid
+		 * recomputing LUTs that does not depend on image histogram such as
+		 * NONE, GAMMA and NEGATIVE
 		 */
 		TransfertType previousLutType;
 
@@ -246,8 +469,8 @@ class CvHistograms : virtual public CvProcessor
 		float lutParam;
 
 		/**
-		 * previous percentage for LUTs that requires such a parameter.
-		 * Needed to know if LUT not depending on image histogram should be
+		 * previous percentage for LUTs that requires such a parameter
+		 * (parameter of the last computed LUT). Needed to know if LUT not depending on image histogram should be
 		 * refreshed when param changes, such as Gamma
 		 */
 		float previousLutParam;
@@ -267,6 +490,97 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		bool lutUpdated;
 
+		/**
+		 * Cache of LUTs depending only on lutParam (NONE, GAMMA and
+		 * NEGATIVE) indexed by (lutType, lutParam)
+		 */
+		map<pair<int, float>, Mat> lutCache;
+
+		/**
+		 * Histograms changes tolerance of LUTs depending on histograms :
+		 * these LUTs are recomputed only when the mean L1 distance between
+		 * current normalized cumulative histograms and the ones used to
+		 * compute the current LUT exceeds lutTolerance
+		 */
+		float lutTolerance;
+
+		/**
+		 * Cumulative histograms used to compute current LUT (nbHistograms *
+		 * bins values)
+		 */
+		float * lutReference;
+
+		/**
+		 * Number of tiles columns of the LOCAL_EQUALIZE transfert function
+		 */
+		size_t localTilesX;
+
+		/**
+		 * Number of tiles rows of the LOCAL_EQUALIZE transfert function
+		 */
+		size_t localTilesY;
+
+		/**
+		 * Clip limit of the LOCAL_EQUALIZE tiles histograms, relative to
+		 * the mean bin population of a tile (1 means no equalization).
+		 * Populations above the limit are evenly redistributed to all bins.
+		 */
+		float localClipLimit;
+
+		/**
+		 * Tiles LUTs caching tolerance: a tile LUT is recomputed only when
+		 * the L1 distance between its histogram and the histogram used to
+		 * compute its LUT exceeds localTolerance times the tile population.
+		 */
+		float localTolerance;
+
+		/**
+		 * Forces all tiles LUTs to be recomputed (when parameters change)
+		 */
+		bool localRebuild;
+
+		/**
+		 * Tiles histograms: channels * bins counters for each tile (in
+		 * rows order)
+		 */
+		unsigned int * localCounts;
+
+		/**
+		 * Tiles histograms used to compute current tiles LUTs
+		 */
+		unsigned int * localCachedCounts;
+
+		/**
+		 * Tiles LUTs: channels * bins output values for each tile
+		 */
+		float * localLUTs;
+
+		/**
+		 * Indicates which tiles LUTs have been recomputed during last update
+		 * (char rather than bool since tiles are processed concurrently)
+		 */
+		vector<char> localTileUpdated;
+
+		/**
+		 * Left tile column blended for each image column
+		 */
+		vector<size_t> localColumns;
+
+		/**
+		 * Right tile weight in the blending for each image column
+		 */
+		vector<float> localColumnWeights;
+
+		/**
+		 * Top tile row blended for each image row
+		 */
+		vector<size_t> localRows;
+
+		/**
+		 * Bottom tile weight in the blending for each image row
+		 */
+		vector<float> localRowWeights;
+
 		// --------------------------------------------------------------------
 		// Drawing attributes
 		// --------------------------------------------------------------------
@@ -316,6 +630,30 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		Mat histDisplayFrame;
 
+		/**
+		 * Rendering engine used to draw histograms
+		 */
+		HistogramRenderer renderer;
+
+		/**
+		 * Column buffers of the RASTER_RENDERER: top row of the bar of
+		 * each drawing column (histWidth values) for each component
+		 */
+		int * rasterTops;
+
+		/**
+		 * Components visibility when histDisplayFrame was last composited
+		 * by the RASTER_RENDERER
+		 */
+		vector<char> rasterShown;
+
+		/**
+		 * Indicates if histDisplayFrame contains the last RASTER_RENDERER
+		 * compositing (false when frame has been reallocated or drawn by
+		 * another renderer)
+		 */
+		bool rasterValid;
+
 		/**
 		 * The color Matrices to draw each LUT
 		 */
@@ -407,12 +745,16 @@ class CvHistograms : virtual public CvProcessor
 		 * @param drawWidth the drawing width of the histogram window
 		 * @param timeCumulation checks whether to compute time cumulative
 		 * histograms or not.
+		 * @param nbBins the number of bins of each histogram: rounded down
+		 * to a power of two and limited to the number of levels of T. 0
+		 * uses all levels up to defaultBins.
 		 */
 		CvHistograms(Mat * image,
 					 const bool computeGray = true,
 					 const size_t drawHeight = 256,
 					 const size_t drawWidth = 512,
-					 const bool timeCumulation = false);
+					 const bool timeCumulation = false,
+					 const size_t nbBins = 0);
 
 		/**
 		 * Histogram destructor.
@@ -430,6 +772,23 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		virtual void updateHistogram();
 
+		/**
+		 * Update histograms values after current LUT has been applied
+		 * without scanning the transformed image : since LUT is point-wise,
+		 * each bin population of the source image is moved to the bin it is
+		 * transformed to. The gray level histogram (if any) can't be
+		 * transfered and is counted again by a luminance only pass over the
+		 * transformed image.
+		 * @return true if histograms have been transfered, false if transfer
+		 * can't be exact (such as with time cumulative histograms or invalid
+		 * LUT) and histograms should be updated by scanning the transformed
+		 * image instead.
+		 * @pre histograms contains the source image histograms
+		 * @post histograms, cumulative histograms and max values correspond
+		 * to the transformed image
+		 */
+		virtual bool transferHistogram();
+
 		/**
 		 * Value reading access operator
 		 * @param i the ith histogram to access. if i is invalid, 0 is returned
@@ -470,7 +829,7 @@ class CvHistograms : virtual public CvProcessor
 		 * Number of bins in all histograms
 		 * @return the Number of bins in all histograms
 		 */
-		static size_t getBins();
+		size_t getBins() const;
 
 		/**
 		 * Get the number of histograms computed
@@ -511,6 +870,48 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		virtual void setTimeCumulative(const bool value);
 
+		/**
+		 * Time cumulation mode read access
+		 * @return the time cumulation mode used when time cumulative
+		 * histograms are on
+		 */
+		TimeCumulationMode getTimeCumulationMode() const;
+
+		/**
+		 * Time cumulation mode write access
+		 * @param mode the new time cumulation mode (TIME_UNBOUNDED is used
+		 * if mode is invalid)
+		 * @post time cumulation is restarted
+		 */
+		virtual void setTimeCumulationMode(const TimeCumulationMode mode);
+
+		/**
+		 * Number of frames of the TIME_WINDOW mode read access
+		 * @return the number of frames in the time window
+		 */
+		size_t getTimeWindow() const;
+
+		/**
+		 * Number of frames of the TIME_WINDOW mode write access
+		 * @param frames the new number of frames in the time window (at
+		 * least 1)
+		 * @post time cumulation is restarted
+		 */
+		virtual void setTimeWindow(const size_t frames);
+
+		/**
+		 * Decay factor of the TIME_DECAY mode read access
+		 * @return the weight of the newest frame in decayed histograms
+		 */
+		float getTimeDecay() const;
+
+		/**
+		 * Decay factor of the TIME_DECAY mode write access
+		 * @param decay the weight of the newest frame in decayed
+		 * histograms (clamped to ]0..1])
+		 */
+		virtual void setTimeDecay(const float decay);
+
 		/**
 		 * Cumulative histogram status read access
 		 * @return the cumulative histogram status
@@ -523,6 +924,49 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		virtual void setCumulative(const bool value);
 
+		/**
+		 * Gets the current histogram counting engine
+		 * @return the current histogram counting engine
+		 */
+		HistogramKernel getHistogramKernel() const;
+
+		/**
+		 * Sets the histogram counting engine
+		 * @param kernel the new counting engine (BANKED_KERNEL is used
+		 * if kernel is invalid)
+		 */
+		virtual void setHistogramKernel(const HistogramKernel kernel);
+
+		/**
+		 * Gets the current histogram rendering engine
+		 * @return the current histogram rendering engine
+		 */
+		HistogramRenderer getHistogramRenderer() const;
+
+		/**
+		 * Sets the histogram rendering engine
+		 * @param renderer the new rendering engine (RASTER_RENDERER is used
+		 * if renderer is invalid)
+		 */
+		virtual void setHistogramRenderer(const HistogramRenderer renderer);
+
+		/**
+		 * Gets the number of threads used to count pixels
+		 * @return the number of threads used to count pixels (1 when
+		 * counting is sequential)
+		 */
+		size_t getParallel() const;
+
+		/**
+		 * Sets the number of threads used to count pixels.
+		 * Source image is split in threads row bands, each counted in
+		 * private banks, which are then merged in bands order.
+		 * @param threads the number of threads to use (values below 1
+		 * are clamped to 1, which means sequential counting)
+		 * @note only the BANKED_KERNEL can count in parallel
+		 */
+		virtual void setParallel(const int threads);
+
 		/**
 		 * Ith histogram component shown status read access
 		 * @param i the ith histogram component
@@ -556,6 +1000,73 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		virtual void setLutType(const TransfertType lutType);
 
+		/**
+		 * Gets the tolerance of histograms changes before histograms
+		 * depending LUTs are recomputed
+		 * @return the LUT tolerance
+		 */
+		float getLUTTolerance() const;
+
+		/**
+		 * Sets the tolerance of histograms changes before histograms
+		 * depending LUTs are recomputed
+		 * @param tolerance the mean L1 distance between normalized
+		 * cumulative histograms above which LUTs are recomputed (0
+		 * recomputes LUTs on every change)
+		 */
+		virtual void setLUTTolerance(const float tolerance);
+
+		/**
+		 * Gets the number of tiles columns used by LOCAL_EQUALIZE
+		 * @return the number of tiles columns
+		 */
+		size_t getLocalTilesX() const;
+
+		/**
+		 * Gets the number of tiles rows used by LOCAL_EQUALIZE
+		 * @return the number of tiles rows
+		 */
+		size_t getLocalTilesY() const;
+
+		/**
+		 * Sets the tiles grid used by LOCAL_EQUALIZE
+		 * @param tilesX the number of tiles columns (at least 1 and at
+		 * most the image width)
+		 * @param tilesY the number of tiles rows (at least 1 and at most
+		 * the image height)
+		 * @post all tiles LUTs will be recomputed
+		 */
+		virtual void setLocalTiles(const size_t tilesX, const size_t tilesY);
+
+		/**
+		 * Gets the LOCAL_EQUALIZE histograms clip limit
+		 * @return the clip limit relative to the mean bin population
+		 */
+		float getLocalClipLimit() const;
+
+		/**
+		 * Sets the LOCAL_EQUALIZE histograms clip limit
+		 * @param limit the clip limit relative to the mean bin population
+		 * (values below 1 are clamped to 1)
+		 * @post all tiles LUTs will be recomputed
+		 */
+		virtual void setLocalClipLimit(const float limit);
+
+		/**
+		 * Gets the LOCAL_EQUALIZE tiles LUTs caching tolerance
+		 * @return the fraction of a tile population which has to change
+		 * before its LUT is recomputed
+		 */
+		float getLocalTolerance() const;
+
+		/**
+		 * Sets the LOCAL_EQUALIZE tiles LUTs caching tolerance
+		 * @param tolerance the fraction of a tile population which has to
+		 * change before its LUT is recomputed (0 recomputes tiles LUTs on
+		 * every change)
+		 */
+		virtual void setLocalTolerance(const float tolerance);
+
 		/**
 		 * Gets the current parameter value for LUTs using a percentage parameter
 		 * @return the current LUT parameter
@@ -617,6 +1128,47 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		virtual void resetMeanProcessTime();
 
+		/**
+		 * Benchmarks counting engines on an image: mean histogram update
+		 * time of the ITERATOR_KERNEL and of the BANKED_KERNEL (sequential
+		 * and parallel) and max bin difference with the ITERATOR_KERNEL
+		 * histograms.
+		 * @param image the image to count (of type T with channels channels)
+		 * @param out the stream to print results on
+		 * @param iterations the number of timed updates of each engine
+		 */
+		static void benchmark(Mat * image,
+							  ostream & out,
+							  const int iterations = 100);
+
+		/**
+		 * Benchmarks luminance histogram counting on a BGR image: mean
+		 * update time without and with luminance counted in the same pass,
+		 * mean time of a color pass followed by cvtColor(..., CV_BGR2GRAY)
+		 * and a gray pass, and max bin difference between the luminance
+		 * histogram and the cvtColor gray image histogram.
+		 * @param image the BGR image to count (of type T)
+		 * @param out the stream to print results on
+		 * @param iterations the number of timed updates of each method
+		 * @pre channels == 3
+		 */
+		static void benchmarkGray(Mat * image,
+								  ostream & out,
+								  const int iterations = 100);
+
+		/**
+		 * Benchmarks histograms rendering engines: mean drawing time of
+		 * the PRIMITIVES_RENDERER and of the RASTER_RENDERER while
+		 * histograms alternate between the ones of an image and the ones
+		 * of a brightened copy of this image.
+		 * @param image the image to count (of type T with channels channels)
+		 * @param out the stream to print results on
+		 * @param iterations the number of timed drawings of each engine
+		 */
+		static void benchmarkDraw(Mat * image,
+								  ostream & out,
+								  const int iterations = 100);
+
 		/**
 		 * output operator for Histograms
 		 * @param out the output stream
@@ -644,6 +1196,135 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		virtual void cleanup();
 
+		/**
+		 * Counts an image pixels into histograms and computes cumulative
+		 * histograms and max values.
+		 * @param image the image to count (source image or transformed
+		 * image)
+		 */
+		void countHistograms(const Mat * image);
+
+		/**
+		 * Computes cumulative histograms and cMaxValue
+		 * @pre regular histograms and maxValue are up to date
+		 */
+		void completeHistograms();
+
+		/**
+		 * Restarts time cumulation: clears the time window frames ring (and
+		 * reallocates it for the current timeWindow) and frames count
+		 */
+		void resetTimeCumulation();
+
+		/**
+		 * Counts image pixels into histograms with the reference
+		 * iterator based engine.
+		 * @param image the image to count
+		 * @post histograms are reset (unless time cumulative) and
+		 * updated with the image values, maxValue is updated.
+		 */
+		void countIterator(const Mat * image);
+
+		/**
+		 * Counts image pixels into histograms with the row pointers
+		 * and integer banks engine.
+		 * @param image the image to count
+		 * @post histograms are reset (unless time cumulative) and
+		 * updated with the image values, maxValue is updated.
+		 */
+		void countBanked(const Mat * image);
+
+		/**
+		 * Counts only the luminance histogram of a BGR image (channels
+		 * histograms are left unchanged)
+		 * @param image the BGR image to count
+		 * @pre gray level histogram is computed (nbHistograms > channels)
+		 * @post gray level histogram contains the image luminance counts and
+		 * maxValue is updated
+		 */
+		void countGray(const Mat * image);
+
+		/**
+		 * Counts a band of rows of an image into the integer banks
+		 * of this band.
+		 * @param image the image to count
+		 * @param band the band index in [0..nbBands - 1]
+		 * @param nbBands the number of bands the image is split in
+		 * @post banks of this band are reset and contains band counts
+		 */
+		void countBand(const Mat * image,
+					   const size_t band,
+					   const size_t nbBands);
+
+		/**
+		 * Parallel loop body counting row bands with #countBand
+		 */
+		class BandCounter;
+
+		/**
+		 * Computes elapsed wall clock time since start (in clock ticks so
+		 * it can be mixed with clock() measured times).
+		 * @param start the starting time obtained with getTickCount()
+		 * @return the elapsed time in clock ticks
+		 * @note clock() measures CPU time of all threads and can not
+		 * report multi-threaded speedups
+		 */
+		static clock_t elapsedTicks(const int64 start);
+
+		/**
+		 * Computes the number of bins used for a requested number of bins
+		 * @param nbBins the requested number of bins (0 for default)
+		 * @return the largest power of two below nbBins and levels
+		 */
+		static size_t binsFor(const size_t nbBins);
+
+		/**
+		 * Computes the range mapping shift of a number of bins
+		 * @param nbBins a power of two number of bins below levels
+		 * @return the shift mapping levels to nbBins bins
+		 */
+		static int shiftFor(const size_t nbBins);
+
+		/**
+		 * Luminance of a BGR pixel
+		 * @param pixel pointer to the pixel first (blue) component
+		 * @param grayTables the fixed point luminance tables
+		 * @return the gray level bin of this pixel in [0..bins - 1]
+		 * @see #grayTables
+		 */
+		size_t grayLevel(const T * pixel, const int * grayTables) const
+		{
+			return (size_t) ((grayTables[(size_t) pixel[0] >> binShift] +
+							  grayTables[bins + ((size_t) pixel[1] >> binShift)] +
+							  grayTables[2 * bins + ((size_t) pixel[2] >> binShift)])
+							 >> grayShift);
+		}
+
+		/**
+		 * Counts a row of pixels into integer banks
+		 * @param row pointer to the first element of the row
+		 * @param nbPixels number of pixels in the row
+		 * @param grayTables the fixed point luminance tables used to count
+		 * the gray level histogram in banks[channels], or NULL if there is
+		 * no gray level histogram
+		 * @param banks histograms banks to count in (nbBanks * bins counters
+		 * for each histogram)
+		 */
+		void countRow(const T * row,
+					  const size_t nbPixels,
+					  const int * grayTables,
+					  unsigned int * const * banks) const;
+
+		/**
+		 * Merges each histogram's integer banks into histograms and computes
+		 * maxValue.
+		 * @param banks histograms banks to merge (nbBanks * bins counters
+		 * for each histogram)
+		 * @post regular histograms contains banks sums, combined with
+		 * previous frames according to #timeMode if time cumulative
+		 */
+		void reduceBanks(unsigned int * const * banks);
+
 		/**
 		 * Draws selected histogram(s) in drawing frame and returns the drawing
 		 * frame
@@ -656,6 +1337,18 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		virtual void drawHistograms();
 
+		/**
+		 * Draws histograms with the PRIMITIVES_RENDERER
+		 * @see #drawHistograms
+		 */
+		void drawPrimitiveHistograms();
+
+		/**
+		 * Draws histograms with the RASTER_RENDERER
+		 * @see #drawHistograms
+		 */
+		void drawRasterHistograms();
+
 		/**
 		 * Draws selected transfert function in drawing frame and returns the
 		 * drawing frame
@@ -773,6 +1466,81 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		Mat * computeNegativeLUT();
 
+		/**
+		 * Returns the LUT of a type depending only on lutParam (NONE, GAMMA
+		 * or NEGATIVE) from the LUTs cache, or computes it and adds it to
+		 * the cache
+		 * @return the mono LUT matrix to apply on the image
+		 * @post lutUpdated is false if LUT is the same as the previous one
+		 * @post the result is stored in monoTransfertFunc
+		 */
+		Mat * computeCachedLUT();
+
+		/**
+		 * Checks if cumulative histograms changed since current LUT has
+		 * been computed
+		 * @return true if the mean L1 distance between normalized
+		 * cumulative histograms and the reference cumulative histograms
+		 * exceeds lutTolerance
+		 */
+		bool histogramsChanged() const;
+
+		/**
+		 * Stores current cumulative histograms as reference for
+		 * #histogramsChanged
+		 */
+		void keepLUTReference();
+
+		/**
+		 * Computes the LOCAL_EQUALIZE tiles histograms and clipped
+		 * equalization LUTs (in parallel over tiles). Tiles LUTs are
+		 * recomputed only when their histogram changed beyond
+		 * localTolerance.
+		 * @return the matrix containing the mean of the tiles LUTs (used to
+		 * draw the transfert function), tiles LUTs themselves are applied
+		 * by #applyLocalLUTs
+		 * @post lutUpdated is true if any tile LUT has been recomputed
+		 * @post the mean LUT is stored in colorTransferFunc
+		 */
+		Mat * computeLocalEqualizeLUT();
+
+		/**
+		 * Reallocates tiles histograms and LUTs and computes the tiles
+		 * blending coefficients of each image row and column for the
+		 * current tiles grid
+		 */
+		void resetLocalTiles();
+
+		/**
+		 * Counts a tile histograms and recomputes its LUTs if needed
+		 * @param tile the tile index (in rows order)
+		 */
+		void equalizeTile(const size_t tile);
+
+		/**
+		 * Parallel loop body computing tiles LUTs with #equalizeTile
+		 */
+		class TileEqualizer;
+
+		/**
+		 * Apply tiles LUTs to the source image to produce the outFrame in a
+		 * single pass (in parallel over row bands)
+		 */
+		void applyLocalLUTs();
+
+		/**
+		 * Applies tiles LUTs to a band of rows: each pixel component is
+		 * transformed by the four nearest tiles LUTs blended bilinearly
+		 * @param band the band index in [0..nbBands - 1]
+		 * @param nbBands the number of bands the image is split in
+		 */
+		void applyLocalBand(const size_t band, const size_t nbBands);
+
+		/**
+		 * Parallel loop body applying tiles LUTs with #applyLocalBand
+		 */
+		class LocalApplier;
+
 		/**
 		 * Compute and returns the current transfert function to be applied
 		 * on the image, eventually with the current LUT parameter
@@ -782,11 +1550,31 @@ class CvHistograms : virtual public CvProcessor
 		 */
 		Mat * computeLUT();
 
+		/**
+		 * Interpolates the full range transfert function from a bins LUT.
+		 * Values of bin j are linearly interpolated between lut(j) and
+		 * lut(j + 1) (extrapolated for the last bin) so that linear LUTs
+		 * such as identity or negative are exactly expanded.
+		 * @param lut the bins LUT to expand
+		 * @post expandedLUT contains levels entries with as many channels
+		 * as lut
+		 */
+		void expandLUT(const Mat * lut);
+
+		/**
+		 * Apply expandedLUT to the source image to produce the outFrame
+		 * (for images which can't be transformed by OpenCV LUT function)
+		 * @pre expandedLUT is up to date with the current LUT
+		 */
+		void applyExpandedLUT();
+
 		/**
 		 * Apply current LUT (if != NULL) to the source image to produce the
 		 * outFrame
 		 * @return true if LUT has been applied, false if lut is NULL or
 		 * lutType is NONE
+		 * @note LUT is applied through expandedLUT when bins don't map
+		 * levels one to one or when T is not 8 bits
 		 */
 		virtual bool drawTransformedImage();
 };
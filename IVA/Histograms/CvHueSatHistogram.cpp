@@ -0,0 +1,547 @@
+/*
+ * CvHueSatHistogram.cpp
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#include <ctime>		// for clock
+#include <cstring>		// for memset
+#include <iostream>		// for cerr
+#include <vector>		// for kernel weights
+using namespace std;
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>	// for meanShift
+
+#include <assert.h>
+
+#include "CvHueSatHistogram.h"
+
+/*
+ * Hue / Saturation histogram constructor
+ * @param image the source image
+ * @param hueBins the number of hue bins of the model histogram
+ * @param satBins the number of saturation bins of the model histogram
+ */
+CvHueSatHistogram::CvHueSatHistogram(Mat * image,
+									 const int hueBins,
+									 const int satBins) :
+	CvProcessor(image),
+	hueBins(hueBins < 1 ? 1 : (hueBins > hueLevels ? hueLevels : hueBins)),
+	satBins(satBins < 1 ? 1 : (satBins > satLevels ? satLevels : satBins)),
+	hueIndex(new int[hueLevels]),
+	satIndex(new int[satLevels]),
+	model(new uint64[this->hueBins * this->satBins]),
+	modeled(false),
+	modelRequested(false),
+	modelRegion(0, 0, 0, 0),
+	minSaturation(30),
+	backProjectionLUT(hueLevels, satLevels, CV_8UC1, Scalar(0)),
+	lastRegion(0, 0, 0, 0),
+	meanShift(false),
+	searchWindow(0, 0, 0, 0),
+	searchMargin(0.5f),
+	meanShiftCriteria(TermCriteria::EPS | TermCriteria::COUNT, 10, 1),
+	showWindow(true),
+	backProjectionTime(0),
+	meanBackProjectionTime(clock_t(0)),
+	meanShiftTime(0),
+	meanMeanShiftTime(clock_t(0))
+{
+	// bins of each hue and saturation value
+	for (int h = 0; h < hueLevels; h++)
+	{
+		hueIndex[h] = (h * this->hueBins) / hueLevels;
+	}
+	for (int s = 0; s < satLevels; s++)
+	{
+		satIndex[s] = (s * this->satBins) / satLevels;
+	}
+
+	memset(model, 0, this->hueBins * this->satBins * sizeof(uint64));
+
+	setup(image, false);
+
+	// Adds named image to additional images map
+	addImage("backprojection", &backProjection);
+}
+
+/*
+ * Hue / Saturation histogram destructor
+ */
+CvHueSatHistogram::~CvHueSatHistogram()
+{
+	cleanup();
+
+	delete [] hueIndex;
+	delete [] satIndex;
+	delete [] model;
+}
+
+/*
+ * Setup attributes when source image is changed
+ * @param image source Image
+ * @param completeSetup is true when used to change source image,
+ * and false when used in constructor
+ */
+void CvHueSatHistogram::setup(Mat * image, const bool completeSetup)
+{
+	assert (image != NULL);
+
+	CvProcessor::setup(image, completeSetup);
+
+	if (completeSetup) // complete setup
+	{
+		modeled = false;
+		modelRequested = false;
+		modelRegion = Rect(0, 0, 0, 0);
+		searchWindow = Rect(0, 0, 0, 0);
+		backProjectionLUT = Scalar(0);
+	}
+
+	// in any cases
+	if (type != CV_8UC3)
+	{
+		cerr << "CvHueSatHistogram::setup : source image is not a 8 bits "
+			 << "BGR image, nothing will be back-projected" << endl;
+	}
+
+	hsvImage.create(size, CV_8UC3);
+	backProjection.create(size, CV_8UC1);
+	backProjection = Scalar(0);
+	lastRegion = Rect(0, 0, 0, 0);
+}
+
+/*
+ * Cleanup attributes before changing source image or cleaning class
+ * before destruction
+ */
+void CvHueSatHistogram::cleanup()
+{
+	hsvImage.release();
+	backProjection.release();
+
+	// super cleanup
+	CvProcessor::cleanup();
+}
+
+/*
+ * Update:
+ * 	- computes the model from the selected region if requested
+ * 	- back-projects the image (or the search window area) against
+ * 	the model
+ * 	- moves the search window by mean-shift if required and draws it
+ * 	in the back-projection image if required
+ */
+void CvHueSatHistogram::update()
+{
+	clock_t start = clock();
+	backProjectionTime = 0;
+	meanShiftTime = 0;
+
+	if (type == CV_8UC3)
+	{
+		if (modelRequested)
+		{
+			modelRequested = false;
+			modeled = computeModel();
+			searchWindow = modeled ? modelRegion & Rect(Point(0, 0), size) :
+									 Rect(0, 0, 0, 0);
+		}
+
+		// clears back-projected region of previous update only
+		if (lastRegion.area() > 0)
+		{
+			backProjection(lastRegion) = Scalar(0);
+			lastRegion = Rect(0, 0, 0, 0);
+		}
+
+		if (modeled)
+		{
+			bool tracking = meanShift && (searchWindow.area() > 0);
+			Rect region(Point(0, 0), size);
+
+			if (tracking)
+			{
+				// only search window and its margins are back-projected
+				int mx = cvRound(searchWindow.width * searchMargin);
+				int my = cvRound(searchWindow.height * searchMargin);
+				region = Rect(searchWindow.x - mx,
+							  searchWindow.y - my,
+							  searchWindow.width + 2 * mx,
+							  searchWindow.height + 2 * my) & region;
+			}
+
+			backProject(region);
+			lastRegion = region;
+
+			backProjectionTime = clock() - start;
+
+			if (tracking)
+			{
+				clock_t shiftStart = clock();
+
+				// mean-shift within the back-projected region
+				Rect window = searchWindow - region.tl();
+				cv::meanShift(backProjection(region), window,
+							  meanShiftCriteria);
+				searchWindow = window + region.tl();
+
+				meanShiftTime = clock() - shiftStart;
+
+				/*
+				 * Window is drawn within the back-projected region so it
+				 * is cleared with it during next update
+				 */
+				if (showWindow)
+				{
+					Mat regionBackProjection = backProjection(region);
+					rectangle(regionBackProjection, window, Scalar(255), 2,
+							  CV_AA);
+				}
+			}
+		}
+	}
+
+	meanBackProjectionTime += backProjectionTime;
+	meanMeanShiftTime += meanShiftTime;
+
+	processTime = clock() - start;
+	meanProcessTime += processTime;
+}
+
+/*
+ * Computes the model histogram from the model region of the source
+ * image and the back-projection LUT
+ * @return true if model region contains some saturated pixels
+ */
+bool CvHueSatHistogram::computeModel()
+{
+	memset(model, 0, hueBins * satBins * sizeof(uint64));
+
+	Rect region = modelRegion & Rect(Point(0, 0), size);
+	if (region.area() == 0)
+	{
+		return false;
+	}
+
+	Mat hsvRegion = hsvImage(region);
+	cvtColor((*sourceImage)(region), hsvRegion, CV_BGR2HSV);
+
+	/*
+	 * Separable integer tent kernel: weight of (x, y) is
+	 * colWeight[x] * rowWeight[y] with weights rising from 1 on the region
+	 * borders to half the region size in its center
+	 */
+	vector<uint64> colWeights(region.width);
+	for (int x = 0; x < region.width; x++)
+	{
+		colWeights[x] = min(x + 1, region.width - x);
+	}
+
+	bool populated = false;
+	for (int y = 0; y < region.height; y++)
+	{
+		const uchar * hsv = hsvRegion.ptr<uchar>(y);
+		const uint64 rowWeight = min(y + 1, region.height - y);
+
+		for (int x = 0; x < region.width; x++, hsv += 3)
+		{
+			if (hsv[1] >= minSaturation)
+			{
+				model[hueIndex[hsv[0]] * satBins + satIndex[hsv[1]]] +=
+					rowWeight * colWeights[x];
+				populated = true;
+			}
+		}
+	}
+
+	computeBackProjectionLUT();
+
+	return populated;
+}
+
+/*
+ * Computes the back-projection LUT from the model histogram: each
+ * (hue, saturation) value receives the population of its bin scaled
+ * so that the most populated bin is 255.
+ */
+void CvHueSatHistogram::computeBackProjectionLUT()
+{
+	uint64 maxValue = 0;
+	for (int i = 0; i < hueBins * satBins; i++)
+	{
+		if (model[i] > maxValue)
+		{
+			maxValue = model[i];
+		}
+	}
+
+	for (int h = 0; h < hueLevels; h++)
+	{
+		uchar * lutRow = backProjectionLUT.ptr<uchar>(h);
+		const uint64 * modelRow = model + hueIndex[h] * satBins;
+
+		for (int s = 0; s < satLevels; s++)
+		{
+			if ((maxValue == 0) || (s < minSaturation))
+			{
+				lutRow[s] = 0;
+			}
+			else
+			{
+				lutRow[s] = (uchar)((modelRow[satIndex[s]] * 255) / maxValue);
+			}
+		}
+	}
+}
+
+/*
+ * Converts a region of the source image to HSV and back-projects it
+ * @param region the region to back-project
+ */
+void CvHueSatHistogram::backProject(const Rect & region)
+{
+	if (region.area() == 0)
+	{
+		return;
+	}
+
+	Mat hsvRegion = hsvImage(region);
+	cvtColor((*sourceImage)(region), hsvRegion, CV_BGR2HSV);
+
+	// backProjectionLUT is continuous: (h, s) value is at h * satLevels + s
+	const uchar * lut = backProjectionLUT.ptr<uchar>(0);
+
+	for (int y = 0; y < region.height; y++)
+	{
+		const uchar * hsv = hsvRegion.ptr<uchar>(y);
+		uchar * projected = backProjection.ptr<uchar>(region.y + y) + region.x;
+
+		for (int x = 0; x < region.width; x++, hsv += 3)
+		{
+			projected[x] = lut[hsv[0] * satLevels + hsv[1]];
+		}
+	}
+}
+
+/*
+ * Sets a new model region: model will be computed from this region
+ * of the next image and search window is set to this region
+ * @param region the region to compute the model from
+ */
+void CvHueSatHistogram::setModelRegion(const Rect & region)
+{
+	modelRegion = region;
+	modelRequested = true;
+}
+
+/*
+ * Clears the current model
+ */
+void CvHueSatHistogram::clearModel()
+{
+	modeled = false;
+	modelRequested = false;
+	searchWindow = Rect(0, 0, 0, 0);
+	memset(model, 0, hueBins * satBins * sizeof(uint64));
+	backProjectionLUT = Scalar(0);
+}
+
+/*
+ * Gets the model status
+ * @return true if a model has been computed
+ */
+bool CvHueSatHistogram::isModeled() const
+{
+	return modeled;
+}
+
+/*
+ * Gets the number of hue bins of the model histogram
+ * @return the number of hue bins
+ */
+int CvHueSatHistogram::getHueBins() const
+{
+	return hueBins;
+}
+
+/*
+ * Gets the number of saturation bins of the model histogram
+ * @return the number of saturation bins
+ */
+int CvHueSatHistogram::getSatBins() const
+{
+	return satBins;
+}
+
+/*
+ * Gets the joint histogram value of a (hue, saturation) bin
+ * @param h the hue bin
+ * @param s the saturation bin
+ * @return the model population of this bin or 0 if bins are
+ * invalid
+ */
+uint64 CvHueSatHistogram::getModelValue(const int h, const int s) const
+{
+	if ((h >= 0) && (h < hueBins) && (s >= 0) && (s < satBins))
+	{
+		return model[h * satBins + s];
+	}
+
+	return 0;
+}
+
+/*
+ * Gets the minimum back-projected saturation
+ * @return the minimum back-projected saturation
+ */
+int CvHueSatHistogram::getMinSaturation() const
+{
+	return minSaturation;
+}
+
+/*
+ * Sets the minimum back-projected saturation
+ * @param minSaturation the new minimum saturation in [0..255]
+ */
+void CvHueSatHistogram::setMinSaturation(const int minSaturation)
+{
+	if ((minSaturation >= 0) && (minSaturation < satLevels))
+	{
+		this->minSaturation = minSaturation;
+
+		if (modeled)
+		{
+			/*
+			 * Model only contains pixels above the previous minimum
+			 * saturation, so it is recomputed from the same region
+			 */
+			modelRequested = true;
+		}
+	}
+	else
+	{
+		cerr << "CvHueSatHistogram::setMinSaturation(" << minSaturation
+			 << ") : invalid value" << endl;
+	}
+}
+
+/*
+ * Gets the mean-shift tracking status
+ * @return true if mean-shift tracking is on
+ */
+bool CvHueSatHistogram::isMeanShift() const
+{
+	return meanShift;
+}
+
+/*
+ * Sets the mean-shift tracking status
+ * @param meanShift the new mean-shift tracking status
+ */
+void CvHueSatHistogram::setMeanShift(const bool meanShift)
+{
+	this->meanShift = meanShift;
+
+	if (meanShift && modeled && (searchWindow.area() == 0))
+	{
+		searchWindow = modelRegion & Rect(Point(0, 0), size);
+	}
+}
+
+/*
+ * Gets the current search window
+ * @return the current search window
+ */
+const Rect & CvHueSatHistogram::getSearchWindow() const
+{
+	return searchWindow;
+}
+
+/*
+ * Gets current show/hide search window status
+ * @return the current show/hide search window status
+ */
+bool CvHueSatHistogram::isShowWindow() const
+{
+	return showWindow;
+}
+
+/*
+ * Sets new show/hide search window status
+ * @param showWindow the new show/hide search window status
+ */
+void CvHueSatHistogram::setShowWindow(const bool showWindow)
+{
+	this->showWindow = showWindow;
+}
+
+/*
+ * Return processor processing time of step index
+ * @param index index of the step which processing time is required,
+ * 0 indicates all steps, and values above 0 indicates step #.
+ * @return the processing time of step index.
+ */
+double CvHueSatHistogram::getProcessTime(const size_t index) const
+{
+	switch (index)
+	{
+		case BACK_PROJECTION:
+			return (double) backProjectionTime;
+		case MEAN_SHIFT:
+			return (double) meanShiftTime;
+		default:
+			return (double) processTime;
+	}
+}
+
+/*
+ * Return processor mean processing time of step index
+ * @param index index of the step which processing time is required,
+ * 0 indicates all steps, and values above 0 indicates step #.
+ * @return the mean processing time of step index.
+ */
+double CvHueSatHistogram::getMeanProcessTime(const size_t index) const
+{
+	switch (index)
+	{
+		case BACK_PROJECTION:
+			return (double) meanBackProjectionTime.mean();
+		case MEAN_SHIFT:
+			return (double) meanMeanShiftTime.mean();
+		default:
+			return (double) meanProcessTime.mean();
+	}
+}
+
+/*
+ * Return processor processing time std of step index
+ * @param index index of the step which processing time is required,
+ * 0 indicates all steps, and values above 0 indicates step #.
+ * @return the processing time std of step index.
+ */
+double CvHueSatHistogram::getStdProcessTime(const size_t index) const
+{
+	switch (index)
+	{
+		case BACK_PROJECTION:
+			return (double) meanBackProjectionTime.std();
+		case MEAN_SHIFT:
+			return (double) meanMeanShiftTime.std();
+		default:
+			return (double) meanProcessTime.std();
+	}
+}
+
+/*
+ * Reset mean and std process time in order to re-start computing
+ * new mean and std process time values.
+ */
+void CvHueSatHistogram::resetMeanProcessTime()
+{
+	CvProcessor::resetMeanProcessTime();
+	meanBackProjectionTime.reset();
+	meanMeanShiftTime.reset();
+}
@@ -0,0 +1,344 @@
+/*
+ * CvHueSatHistogram.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#ifndef CVHUESATHISTOGRAM_H_
+#define CVHUESATHISTOGRAM_H_
+
+#include "CvProcessor.h"
+
+/**
+ * OpenCV joint Hue / Saturation histogram of a selected region of a BGR
+ * image used as a color model to localize this region in the next images:
+ * each image is back-projected against the model (each pixel receives the
+ * model probability of its hue and saturation) and a search window can
+ * optionally be moved to the densest back-projection area by mean-shift.
+ * @note source image should be a 8 bits BGR image
+ */
+class CvHueSatHistogram : virtual public CvProcessor
+{
+	public:
+		/**
+		 * Processing indices for getProcessTime method
+		 * @see #getProcessTime
+		 */
+		typedef enum
+		{
+			ALL = 0,		//!< ALL
+			BACK_PROJECTION,//!< HSV conversion and back-projection
+			MEAN_SHIFT,		//!< search window mean-shift
+			NB_PROC_INDEX	//!< Number of processing time indices
+		} ProcessTimeIndex;
+
+	protected:
+		/**
+		 * Number of hue values in 8 bits HSV images (hue is in [0..179])
+		 */
+		static const int hueLevels = 180;
+
+		/**
+		 * Number of saturation values in 8 bits HSV images
+		 */
+		static const int satLevels = 256;
+
+		/**
+		 * Number of hue bins in the model histogram
+		 */
+		int hueBins;
+
+		/**
+		 * Number of saturation bins in the model histogram
+		 */
+		int satBins;
+
+		/**
+		 * Hue bin of each hue value (hueLevels values)
+		 */
+		int * hueIndex;
+
+		/**
+		 * Saturation bin of each saturation value (satLevels values)
+		 */
+		int * satIndex;
+
+		/**
+		 * Integer joint histogram of the model region (hueBins * satBins
+		 * counters, hue major). Each pixel of the model region is counted
+		 * with the integer weight of a separable tent kernel centered on the
+		 * region so that region borders (most likely background) weight
+		 * less than its center.
+		 */
+		uint64 * model;
+
+		/**
+		 * Indicates a model has been computed
+		 */
+		bool modeled;
+
+		/**
+		 * Indicates a new model region has been selected and the model
+		 * should be computed from the next image
+		 */
+		bool modelRequested;
+
+		/**
+		 * The region to compute the model from
+		 */
+		Rect modelRegion;
+
+		/**
+		 * Pixels with a saturation below minSaturation are not
+		 * back-projected (their hue is meaningless) [default value is 30]
+		 */
+		int minSaturation;
+
+		/**
+		 * Back-projection 2D LUT: model probability (scaled to [0..255]) of
+		 * each (hue, saturation) value (hueLevels rows of satLevels values)
+		 */
+		Mat backProjectionLUT;
+
+		/**
+		 * HSV converted source image (only converted in processed region)
+		 */
+		Mat hsvImage;
+
+		/**
+		 * Back-projection image
+		 */
+		Mat backProjection;
+
+		/**
+		 * Region of the back-projection image computed during last update
+		 * (cleared before next update)
+		 */
+		Rect lastRegion;
+
+		/**
+		 * Indicates if mean-shift tracking is on: only the search window
+		 * (and a margin around it) is back-projected and the search window
+		 * is moved to the densest back-projection area.
+		 * Otherwise the whole image is back-projected.
+		 */
+		bool meanShift;
+
+		/**
+		 * Mean-shift search window
+		 */
+		Rect searchWindow;
+
+		/**
+		 * Back-projected margin around the search window relative to
+		 * search window size [default value is 0.5]
+		 */
+		float searchMargin;
+
+		/**
+		 * Mean-shift termination criteria
+		 */
+		TermCriteria meanShiftCriteria;
+
+		/**
+		 * Show/Hides search window in back-projection image (source image
+		 * is shared with other processors and is never drawn into)
+		 */
+		bool showWindow;
+
+		/**
+		 * Back-projection time
+		 */
+		clock_t backProjectionTime;
+
+		/**
+		 * Mean back-projection time
+		 */
+		ProcessTime meanBackProjectionTime;
+
+		/**
+		 * Mean-shift time
+		 */
+		clock_t meanShiftTime;
+
+		/**
+		 * Mean mean-shift time
+		 */
+		ProcessTime meanMeanShiftTime;
+
+	public:
+		/**
+		 * Hue / Saturation histogram constructor
+		 * @param image the source image
+		 * @param hueBins the number of hue bins of the model histogram
+		 * @param satBins the number of saturation bins of the model
+		 * histogram
+		 */
+		CvHueSatHistogram(Mat * image,
+						  const int hueBins = 30,
+						  const int satBins = 32);
+
+		/**
+		 * Hue / Saturation histogram destructor
+		 */
+		virtual ~CvHueSatHistogram();
+
+		/**
+		 * Update:
+		 * 	- computes the model from the selected region if requested
+		 * 	- back-projects the image (or the search window area) against
+		 * 	the model
+		 * 	- moves the search window by mean-shift if required and draws it
+		 * 	in the back-projection image if required
+		 */
+		virtual void update();
+
+		/**
+		 * Sets a new model region: model will be computed from this region
+		 * of the next image and search window is set to this region
+		 * @param region the region to compute the model from
+		 */
+		virtual void setModelRegion(const Rect & region);
+
+		/**
+		 * Clears the current model
+		 */
+		virtual void clearModel();
+
+		/**
+		 * Gets the model status
+		 * @return true if a model has been computed
+		 */
+		bool isModeled() const;
+
+		/**
+		 * Gets the number of hue bins of the model histogram
+		 * @return the number of hue bins
+		 */
+		int getHueBins() const;
+
+		/**
+		 * Gets the number of saturation bins of the model histogram
+		 * @return the number of saturation bins
+		 */
+		int getSatBins() const;
+
+		/**
+		 * Gets the joint histogram value of a (hue, saturation) bin
+		 * @param h the hue bin
+		 * @param s the saturation bin
+		 * @return the model population of this bin or 0 if bins are
+		 * invalid
+		 */
+		uint64 getModelValue(const int h, const int s) const;
+
+		/**
+		 * Gets the minimum back-projected saturation
+		 * @return the minimum back-projected saturation
+		 */
+		int getMinSaturation() const;
+
+		/**
+		 * Sets the minimum back-projected saturation
+		 * @param minSaturation the new minimum saturation in [0..255]
+		 */
+		virtual void setMinSaturation(const int minSaturation);
+
+		/**
+		 * Gets the mean-shift tracking status
+		 * @return true if mean-shift tracking is on
+		 */
+		bool isMeanShift() const;
+
+		/**
+		 * Sets the mean-shift tracking status
+		 * @param meanShift the new mean-shift tracking status
+		 */
+		virtual void setMeanShift(const bool meanShift);
+
+		/**
+		 * Gets the current search window
+		 * @return the current search window
+		 */
+		const Rect & getSearchWindow() const;
+
+		/**
+		 * Gets current show/hide search window status
+		 * @return the current show/hide search window status
+		 */
+		bool isShowWindow() const;
+
+		/**
+		 * Sets new show/hide search window status
+		 * @param showWindow the new show/hide search window status
+		 */
+		virtual void setShowWindow(const bool showWindow);
+
+		/**
+		 * Return processor processing time of step index
+		 * @param index index of the step which processing time is required,
+		 * 0 indicates all steps, and values above 0 indicates step #.
+		 * @return the processing time of step index.
+		 */
+		virtual double getProcessTime(const size_t index = 0) const;
+
+		/**
+		 * Return processor mean processing time of step index
+		 * @param index index of the step which processing time is required,
+		 * 0 indicates all steps, and values above 0 indicates step #.
+		 * @return the mean processing time of step index.
+		 */
+		virtual double getMeanProcessTime(const size_t index = 0) const;
+
+		/**
+		 * Return processor processing time std of step index
+		 * @param index index of the step which processing time is required,
+		 * 0 indicates all steps, and values above 0 indicates step #.
+		 * @return the processing time std of step index.
+		 */
+		virtual double getStdProcessTime(const size_t index = 0) const;
+
+		/**
+		 * Reset mean and std process time in order to re-start computing
+		 * new mean and std process time values.
+		 */
+		virtual void resetMeanProcessTime();
+
+	protected:
+		/**
+		 * Setup attributes when source image is changed
+		 * @param image source Image
+		 * @param completeSetup is true when used to change source image,
+		 * and false when used in constructor
+		 */
+		virtual void setup(Mat * image, const bool completeSetup = false);
+
+		/**
+		 * Cleanup attributes before changing source image or cleaning class
+		 * before destruction
+		 */
+		virtual void cleanup();
+
+		/**
+		 * Computes the model histogram from the model region of the source
+		 * image and the back-projection LUT
+		 * @return true if model region contains some saturated pixels
+		 */
+		bool computeModel();
+
+		/**
+		 * Computes the back-projection LUT from the model histogram: each
+		 * (hue, saturation) value receives the population of its bin scaled
+		 * so that the most populated bin is 255.
+		 */
+		void computeBackProjectionLUT();
+
+		/**
+		 * Converts a region of the source image to HSV and back-projects it
+		 * @param region the region to back-project
+		 */
+		void backProject(const Rect & region);
+};
+
+#endif /* CVHUESATHISTOGRAM_H_ */
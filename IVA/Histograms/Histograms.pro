@@ -19,6 +19,8 @@ MODULES = CvProcessor \
 	QcvProcessor \
 	CvHistograms \
 	QcvHistograms \
+	CvHueSatHistogram \
+	QcvHueSatHistogram \
 	utils/MeanValue \
 	matWidgets/QcvMatWidget \
 	matWidgets/QcvMatWidgetLabel \
@@ -212,6 +212,94 @@ void QcvHistograms::setTimeCumulative(const bool value)
 	emit sendMessage(message, defaultTimeOut);
 }
 
+/*
+ * Time cumulation mode setting with notification
+ * @param mode the new time cumulation mode
+ */
+void QcvHistograms::setTimeCumulationMode(const TimeCumulationMode mode)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHistograms8UC3::setTimeCumulationMode(mode);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Time cumulation is "));
+	switch (getTimeCumulationMode())
+	{
+		case TIME_UNBOUNDED:
+			message.append(tr("unbounded"));
+			break;
+		case TIME_WINDOW:
+			message.append(tr("over the last %1 frames").arg(getTimeWindow()));
+			break;
+		case TIME_DECAY:
+			message.append(tr("decaying by %1").arg(getTimeDecay()));
+			break;
+		default:
+			message.append(tr("unknown"));
+			break;
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Time window size setting with notification
+ * @param frames the new number of frames in the time window
+ */
+void QcvHistograms::setTimeWindow(const size_t frames)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHistograms8UC3::setTimeWindow(frames);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Time window is %1 frames").arg(getTimeWindow()));
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Time decay factor setting with notification
+ * @param decay the weight of the newest frame in decayed histograms
+ */
+void QcvHistograms::setTimeDecay(const float decay)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHistograms8UC3::setTimeDecay(decay);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Time decay is %1").arg(getTimeDecay()));
+	emit sendMessage(message, defaultTimeOut);
+}
+
 /*
  * Cumulative histogram status read access
  * @param value the value to set for cumulative status
@@ -245,6 +333,114 @@ void QcvHistograms::setCumulative(const bool value)
 	emit sendMessage(message, defaultTimeOut);
 }
 
+/*
+ * Histogram counting engine setting with notification
+ * @param kernel the new counting engine
+ */
+void QcvHistograms::setHistogramKernel(const HistogramKernel kernel)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHistograms8UC3::setHistogramKernel(kernel);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Histogram counting engine is "));
+	switch (getHistogramKernel())
+	{
+		case ITERATOR_KERNEL:
+			message.append(tr("iterator"));
+			break;
+		case BANKED_KERNEL:
+			message.append(tr("banked"));
+			break;
+		default:
+			message.append(tr("unknown"));
+			break;
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Histogram rendering engine setting with notification
+ * @param renderer the new rendering engine
+ */
+void QcvHistograms::setHistogramRenderer(const HistogramRenderer renderer)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHistograms8UC3::setHistogramRenderer(renderer);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Histogram rendering engine is "));
+	switch (getHistogramRenderer())
+	{
+		case PRIMITIVES_RENDERER:
+			message.append(tr("primitives"));
+			break;
+		case RASTER_RENDERER:
+			message.append(tr("raster"));
+			break;
+		default:
+			message.append(tr("unknown"));
+			break;
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Number of histogram counting threads setting with notification
+ * @param threads the number of threads to use (1 for sequential
+ * counting)
+ */
+void QcvHistograms::setParallel(const int threads)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHistograms8UC3::setParallel(threads);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	if (getParallel() > 1)
+	{
+		message.append(tr("Histogram is counted with %1 threads")
+					   .arg(getParallel()));
+	}
+	else
+	{
+		message.append(tr("Histogram is counted sequentially"));
+	}
+
+	emit sendMessage(message, defaultTimeOut);
+}
+
 /*
  * Ith histogram component shown status write access
  * @param i the ith histogram component
@@ -348,6 +544,9 @@ void QcvHistograms::setLutType(const TransfertType lutType)
 		case NEGATIVE:
 			message.append(tr("Inverse"));
 			break;
+		case LOCAL_EQUALIZE:
+			message.append(tr("Local equalize based on tiles histograms"));
+			break;
 		default:
 			message.append(tr("unknown"));
 			break;
@@ -356,6 +555,57 @@ void QcvHistograms::setLutType(const TransfertType lutType)
 	emit sendMessage(message, defaultTimeOut);
 }
 
+/*
+ * Local equalization tiles grid setting with notification
+ * @param tilesX the number of tiles columns
+ * @param tilesY the number of tiles rows
+ */
+void QcvHistograms::setLocalTiles(const size_t tilesX, const size_t tilesY)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHistograms8UC3::setLocalTiles(tilesX, tilesY);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Local equalization tiles are %1 x %2")
+				   .arg(getLocalTilesX()).arg(getLocalTilesY()));
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Local equalization clip limit setting with notification
+ * @param limit the clip limit relative to the mean bin population
+ */
+void QcvHistograms::setLocalClipLimit(const float limit)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHistograms8UC3::setLocalClipLimit(limit);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Local equalization clip limit is %1")
+				   .arg(getLocalClipLimit()));
+	emit sendMessage(message, defaultTimeOut);
+}
+
 /*
  * Reset mean and std process time in order to re-start computing
  * new mean and std process time values.
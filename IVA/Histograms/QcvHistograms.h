@@ -144,12 +144,49 @@ class QcvHistograms: public QcvProcessor, public CvHistograms8UC3
 		 */
 		void setTimeCumulative(const bool value);
 
+		/**
+		 * Time cumulation mode setting with notification
+		 * @param mode the new time cumulation mode
+		 */
+		void setTimeCumulationMode(const TimeCumulationMode mode);
+
+		/**
+		 * Time window size setting with notification
+		 * @param frames the new number of frames in the time window
+		 */
+		void setTimeWindow(const size_t frames);
+
+		/**
+		 * Time decay factor setting with notification
+		 * @param decay the weight of the newest frame in decayed histograms
+		 */
+		void setTimeDecay(const float decay);
+
 		/**
 		 * Cumulative histogram status setting with notification
 		 * @param value the value to set for cumulative status
 		 */
 		void setCumulative(const bool value);
 
+		/**
+		 * Histogram counting engine setting with notification
+		 * @param kernel the new counting engine
+		 */
+		void setHistogramKernel(const HistogramKernel kernel);
+
+		/**
+		 * Histogram rendering engine setting with notification
+		 * @param renderer the new rendering engine
+		 */
+		void setHistogramRenderer(const HistogramRenderer renderer);
+
+		/**
+		 * Number of histogram counting threads setting with notification
+		 * @param threads the number of threads to use (1 for sequential
+		 * counting)
+		 */
+		void setParallel(const int threads);
+
 		/**
 		 * Ith histogram component show setting with notifications
 		 * @param i the ith histogram component
@@ -162,6 +199,19 @@ class QcvHistograms: public QcvProcessor, public CvHistograms8UC3
 		 */
 		void setLutType(const TransfertType lutType);
 
+		/**
+		 * Local equalization tiles grid setting with notification
+		 * @param tilesX the number of tiles columns
+		 * @param tilesY the number of tiles rows
+		 */
+		void setLocalTiles(const size_t tilesX, const size_t tilesY);
+
+		/**
+		 * Local equalization clip limit setting with notification
+		 * @param limit the clip limit relative to the mean bin population
+		 */
+		void setLocalClipLimit(const float limit);
+
 		/**
 		 * Reset mean and std process time in order to re-start computing
 		 * new mean and std process time values.
@@ -0,0 +1,233 @@
+/*
+ * QcvHueSatHistogram.cpp
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#include "QcvHueSatHistogram.h"
+
+/*
+ * QcvHueSatHistogram constructor
+ * @param inFrame the input frame from capture
+ * @param imageLock the mutex for concurrent access to the source image.
+ * In order to avoid concurrent access to the same image
+ * @param updateThread the thread in which this processor should run
+ * @param parent parent QObject
+ */
+QcvHueSatHistogram::QcvHueSatHistogram(Mat * inFrame,
+									   QMutex * imageLock,
+									   QThread * updateThread,
+									   QObject * parent) :
+	CvProcessor(inFrame), // <-- virtual base class constructor first
+	QcvProcessor(inFrame, imageLock, updateThread, parent),
+	CvHueSatHistogram(inFrame),
+	selfLock(updateThread != NULL ? new QMutex() :
+									(imageLock != NULL ? imageLock : NULL))
+{
+	numberFormat = QString::fromUtf8("%5.0f");
+	meanStdFormat = numberFormat + QString::fromUtf8(" ± %4.0f µs");
+	minMaxFormat = numberFormat + QString::fromUtf8(" / ") + numberFormat +
+				   QString::fromUtf8(" µs");
+}
+
+/*
+ * QcvHueSatHistogram destructor
+ */
+QcvHueSatHistogram::~QcvHueSatHistogram()
+{
+	if (selfLock != NULL)
+	{
+		selfLock->lock();
+		selfLock->unlock();
+		delete selfLock;
+	}
+}
+
+/*
+ * Update back-projection image
+ */
+void QcvHueSatHistogram::update()
+{
+	bool hasSourceLock = (sourceLock != NULL) && (sourceLock != selfLock);
+	if (hasSourceLock)
+	{
+		sourceLock->lock();
+	}
+
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHueSatHistogram::update();
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	if (hasSourceLock)
+	{
+		sourceLock->unlock();
+	}
+
+	/*
+	 * emit updated signal
+	 */
+	QcvProcessor::update();
+}
+
+/*
+ * Changes source image slot.
+ * Attributes needs to be cleaned up then set up again
+ * @param image the new source Image
+ */
+void QcvHueSatHistogram::setSourceImage(Mat * image) throw (CvProcessorException)
+{
+	Size previousSize(sourceImage->size());
+	int previousNbChannels(nbChannels);
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvProcessor::setSourceImage(image);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	emit imageChanged(sourceImage);
+
+	emit imageChanged();
+
+	if ((previousSize.width != image->cols) ||
+		(previousSize.height != image->rows))
+	{
+		emit imageSizeChanged();
+	}
+
+	if (previousNbChannels != nbChannels)
+	{
+		emit imageColorsChanged();
+	}
+
+	// notifies any connected component to change source image
+	emit backProjectionChanged(&backProjection);
+}
+
+/*
+ * Sets a new model region from a selection (typically
+ * QcvMatWidget::releaseSelection signal): left button selects a new
+ * model region, right button clears the current model.
+ * @param r the selected rectangle
+ * @param button the button used for selection
+ */
+void QcvHueSatHistogram::setSelection(const QRect & r,
+									  const Qt::MouseButton & button)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	message.clear();
+
+	if (button == Qt::LeftButton)
+	{
+		Rect region(r.x(), r.y(), r.width(), r.height());
+		CvHueSatHistogram::setModelRegion(region);
+		message.append(tr("Hue / Saturation model region set to %1 x %2 at (%3, %4)")
+					   .arg(r.width()).arg(r.height()).arg(r.x()).arg(r.y()));
+	}
+	else if (button == Qt::RightButton)
+	{
+		CvHueSatHistogram::clearModel();
+		message.append(tr("Hue / Saturation model cleared"));
+	}
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	if (!message.isEmpty())
+	{
+		emit sendMessage(message, defaultTimeOut);
+	}
+}
+
+/*
+ * Sets the minimum back-projected saturation with notification
+ * @param minSaturation the new minimum saturation in [0..255]
+ */
+void QcvHueSatHistogram::setMinSaturation(const int minSaturation)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHueSatHistogram::setMinSaturation(minSaturation);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Minimum back-projected saturation set to %1")
+				   .arg(getMinSaturation()));
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Sets the mean-shift tracking status with notification
+ * @param meanShift the new mean-shift tracking status
+ */
+void QcvHueSatHistogram::setMeanShift(const bool meanShift)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHueSatHistogram::setMeanShift(meanShift);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+
+	message.clear();
+	message.append(tr("Mean-shift tracking is "));
+	message.append(meanShift ? tr("on") : tr("off"));
+	emit sendMessage(message, defaultTimeOut);
+}
+
+/*
+ * Sets new show/hide search window status
+ * @param showWindow the new show/hide search window status
+ */
+void QcvHueSatHistogram::setShowWindow(const bool showWindow)
+{
+	bool hasLock = selfLock != NULL;
+	if (hasLock)
+	{
+		selfLock->lock();
+	}
+
+	CvHueSatHistogram::setShowWindow(showWindow);
+
+	if (hasLock)
+	{
+		selfLock->unlock();
+	}
+}
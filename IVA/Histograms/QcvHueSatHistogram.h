@@ -0,0 +1,98 @@
+/*
+ * QcvHueSatHistogram.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: agent
+ */
+
+#ifndef QCVHUESATHISTOGRAM_H_
+#define QCVHUESATHISTOGRAM_H_
+
+#include <QMutex>
+#include <QRect>
+
+#include "QcvProcessor.h"
+#include "CvHueSatHistogram.h"
+
+/**
+ * Qt oriented Hue / Saturation histogram back-projection processor
+ */
+class QcvHueSatHistogram : public QcvProcessor, public CvHueSatHistogram
+{
+	Q_OBJECT
+
+	protected:
+		/**
+		 * Self lock for operations from multiple threads
+		 * @note may be NULL if there is no update thread.
+		 */
+		QMutex * selfLock;
+
+	public:
+		/**
+		 * QcvHueSatHistogram constructor
+		 * @param inFrame the input frame from capture
+		 * @param imageLock the mutex for concurrent access to the source image.
+		 * In order to avoid concurrent access to the same image
+		 * @param updateThread the thread in which this processor should run
+		 * @param parent object
+		 */
+		QcvHueSatHistogram(Mat * inFrame,
+						   QMutex * imageLock = NULL,
+						   QThread * updateThread = NULL,
+						   QObject * parent = NULL);
+
+		/**
+		 * QcvHueSatHistogram destructor
+		 */
+		virtual ~QcvHueSatHistogram();
+
+	public slots:
+		/**
+		 * Update back-projection image
+		 */
+		void update();
+
+		/**
+		 * Changes source image slot.
+		 * Attributes needs to be cleaned up then set up again
+		 * @param image the new source Image
+		 */
+		void setSourceImage(Mat * image) throw (CvProcessorException);
+
+		/**
+		 * Sets a new model region from a selection (typically
+		 * QcvMatWidget::releaseSelection signal): left button selects a new
+		 * model region, right button clears the current model.
+		 * @param r the selected rectangle
+		 * @param button the button used for selection
+		 */
+		void setSelection(const QRect & r, const Qt::MouseButton & button);
+
+		/**
+		 * Sets the minimum back-projected saturation with notification
+		 * @param minSaturation the new minimum saturation in [0..255]
+		 */
+		void setMinSaturation(const int minSaturation);
+
+		/**
+		 * Sets the mean-shift tracking status with notification
+		 * @param meanShift the new mean-shift tracking status
+		 */
+		void setMeanShift(const bool meanShift);
+
+		/**
+		 * Sets new show/hide search window status
+		 * @param showWindow the new show/hide search window status
+		 */
+		void setShowWindow(const bool showWindow);
+
+	signals:
+		/**
+		 * Signal sent when back-projection image has been reallocated
+		 * @param image the new back-projection image
+		 */
+		void backProjectionChanged(Mat * image);
+};
+
+#endif /* QCVHUESATHISTOGRAM_H_ */
@@ -7,6 +7,7 @@
 #include "QcvVideoCapture.h"
 #include "CaptureFactory.h"
 #include "QcvHistograms.h"
+#include "QcvHueSatHistogram.h"
 #include "mainwindow.h"
 
 /**
@@ -28,6 +29,9 @@ void usage(char * name);
  * 	- gray : turns on source image gray conversion
  *	- size : [--size | -s] <width>x<height> resize capture to fit desired <width>
  *	and <height>
+ *	- benchmark : [--benchmark | -b] benchmarks histograms counting and
+ *	drawing engines on 8 bits gray, 8 bits color and 16 bits gray images then
+ *	exits
  */
 int main(int argc, char *argv[])
 {
@@ -45,6 +49,7 @@ int main(int argc, char *argv[])
 	QStringList argList = QCoreApplication::arguments();
 
 	int threadNumber = 3;
+	bool benchmark = false;
 	// parse arguments for --threads tag
 	for (QListIterator<QString> it(argList); it.hasNext(); )
 	{
@@ -69,7 +74,39 @@ int main(int argc, char *argv[])
 				qWarning("Warning: thread tag found with no following thread number");
 			}
 		}
+		else if (currentArg == "-b" || currentArg == "--benchmark")
+		{
+			benchmark = true;
+		}
 	}
+
+	// ------------------------------------------------------------------------
+	// Benchmark histograms counting engines on random images and on a
+	// uniform image (worst case of consecutive increments of the same bin)
+	// then exit
+	// ------------------------------------------------------------------------
+	if (benchmark)
+	{
+		Mat grayImage(480, 640, CV_8UC1);
+		randu(grayImage, Scalar::all(0), Scalar::all(256));
+		CvHistograms<uchar, 1>::benchmark(&grayImage, cout);
+		grayImage.setTo(Scalar::all(128));
+		CvHistograms<uchar, 1>::benchmark(&grayImage, cout);
+
+		Mat colorImage(480, 640, CV_8UC3);
+		randu(colorImage, Scalar::all(0), Scalar::all(256));
+		CvHistograms<uchar, 3>::benchmark(&colorImage, cout);
+		CvHistograms<uchar, 3>::benchmarkGray(&colorImage, cout);
+		CvHistograms<uchar, 3>::benchmarkDraw(&colorImage, cout);
+
+		// 16 bits gray level images (such as thermal cameras)
+		Mat deepImage(480, 640, CV_16UC1);
+		randu(deepImage, Scalar::all(0), Scalar::all(65536));
+		CvHistograms<ushort, 1>::benchmark(&deepImage, cout);
+
+		return 0;
+	}
+
 	// ------------------------------------------------------------------------
 	// Create Capture factory using program arguments and
 	// open Video Capture
@@ -104,11 +141,13 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	// Processsor
+	// Processsors
 	QcvHistograms * histograms = NULL;
+	QcvHueSatHistogram * hueSat = NULL;
 	if (procThread == NULL)
 	{
 		histograms = new QcvHistograms(capture->getImage());
+		hueSat = new QcvHueSatHistogram(capture->getImage());
 	}
 	else
 	{
@@ -117,15 +156,34 @@ int main(int argc, char *argv[])
 			histograms = new QcvHistograms(capture->getImage(),
 										   capture->getMutex(),
 										   procThread);
+			hueSat = new QcvHueSatHistogram(capture->getImage(),
+											capture->getMutex(),
+											procThread);
 		}
 		else // procThread == capThread
 		{
 			histograms = new QcvHistograms(capture->getImage(),
 										   NULL,
 										   procThread);
+			hueSat = new QcvHueSatHistogram(capture->getImage(),
+											NULL,
+											procThread);
 		}
 	}
 
+	// ------------------------------------------------------------------------
+	// Connects capture to Hue / Saturation back-projection
+	// ------------------------------------------------------------------------
+	QObject::connect(capture, SIGNAL(updated()),
+					 hueSat, SLOT(update()),
+					 ((threadNumber < 3) ? Qt::DirectConnection :
+										   Qt::QueuedConnection));
+
+	QObject::connect(capture, SIGNAL(imageChanged(Mat*)),
+					 hueSat, SLOT(setSourceImage(Mat*)),
+					 ((threadNumber < 3) ? Qt::DirectConnection :
+										   Qt::QueuedConnection));
+
 	// ------------------------------------------------------------------------
 	// Connects capture to Histograms
 	// ------------------------------------------------------------------------
@@ -145,7 +203,7 @@ int main(int argc, char *argv[])
 	// add our MainWindow as toplevel
 	// and launches app
 	// ------------------------------------------------------------------------
-	MainWindow w(capture, histograms);
+	MainWindow w(capture, histograms, hueSat);
 	w.show();
 
 	usage(argv[0]);
@@ -156,6 +214,7 @@ int main(int argc, char *argv[])
 	// Cleanup & return
 	// ------------------------------------------------------------------------
 	delete histograms;
+	delete hueSat;
 	delete capture;
 	qDebug() << "Processor and Capture deleted";
 	bool sameThread = capThread == procThread;
@@ -187,5 +246,6 @@ void usage(char * name)
 		 << "[-s | --size] <width>x<height> "
 		 << "[-m | --mirror]"
 		 << "[-t | --threads] <number of threads [1..3]>"
+		 << "[-b | --benchmark]"
 		 << endl;
 }
@@ -15,15 +15,18 @@
  * MainWindow constructor
  * @param capture the capture QObject to capture frames from devices
  * or video files
+ * @param hueSat hue / saturation back-projection processor
  * @param parent parent widget
  */
 MainWindow::MainWindow(QcvVideoCapture * capture,
 					   QcvHistograms * processor,
+					   QcvHueSatHistogram * hueSat,
 					   QWidget *parent) :
 	QMainWindow(parent),
 	ui(new Ui::MainWindow),
 	capture(capture),
 	processor(processor),
+	hueSat(hueSat),
 	preferredWidth(320),
 	preferredHeight(240)
 {
@@ -37,12 +40,15 @@ MainWindow::MainWindow(QcvVideoCapture * capture,
 
 	assert(processor != NULL);
 
+	assert(hueSat != NULL);
+
 	// ------------------------------------------------------------------------
 	// Special widgets initialisation
 	// ------------------------------------------------------------------------
 	ui->widgetImage->setSourceImage(processor->getImagePtr("out"));
 	ui->widgetHistogram->setSourceImage(processor->getImagePtr("histogram"));
 	ui->widgetLUT->setSourceImage(processor->getImagePtr("lut"));
+	ui->widgetBackProjection->setSourceImage(hueSat->getImagePtr("backprojection"));
 
 	// Replace widgetImage QcvMatWidget instance with QcvMatWidgetImage
 	// Sets Source image for widgetImage
@@ -69,6 +75,13 @@ MainWindow::MainWindow(QcvVideoCapture * capture,
 	connect(processor, SIGNAL(lutImageChanged(Mat*)),
 			ui->widgetLUT, SLOT(setSourceImage(Mat*)));
 
+	// Back-projection update and source image changed to its image widget
+	connect(hueSat, SIGNAL(updated()),
+			ui->widgetBackProjection, SLOT(update()));
+
+	connect(hueSat, SIGNAL(backProjectionChanged(Mat*)),
+			ui->widgetBackProjection, SLOT(setSourceImage(Mat*)));
+
 	// Capture, histogram and this messages to status bar
 	connect(capture, SIGNAL(messageChanged(QString,int)),
 			ui->statusBar, SLOT(showMessage(QString,int)));
@@ -76,6 +89,9 @@ MainWindow::MainWindow(QcvVideoCapture * capture,
 	connect(processor, SIGNAL(sendMessage(QString,int)),
 			ui->statusBar, SLOT(showMessage(QString,int)));
 
+	connect(hueSat, SIGNAL(sendMessage(QString,int)),
+			ui->statusBar, SLOT(showMessage(QString,int)));
+
 	connect(this, SIGNAL(sendMessage(QString,int)),
 			ui->statusBar, SLOT(showMessage(QString,int)));
 
@@ -283,6 +299,10 @@ void MainWindow::setupImageWidget(const RenderMode mode)
 	disconnect(processor, SIGNAL(outImageChanged(Mat*)),
 			   ui->widgetImage, SLOT(setSourceImage(Mat*)));
 
+	// Selection in image widget sets hue / saturation model region
+	disconnect(ui->widgetImage, SIGNAL(releaseSelection(QRect,Qt::MouseButton)),
+			   hueSat, SLOT(setSelection(QRect,Qt::MouseButton)));
+
 	QWindow * currentWindow = windowHandle();
 	if (mode == RENDER_GL)
 	{
@@ -321,14 +341,20 @@ void MainWindow::setupImageWidget(const RenderMode mode)
 		switch (mode)
 		{
 			case RENDER_PIXMAP:
-				ui->widgetImage = new QcvMatWidgetLabel(image);
+				ui->widgetImage = new QcvMatWidgetLabel(image,
+														ui->scrollArea,
+														QcvMatWidget::MOUSE_DRAG);
 				break;
 			case RENDER_GL:
-				ui->widgetImage = new QcvMatWidgetGL(image);
+				ui->widgetImage = new QcvMatWidgetGL(image,
+													 ui->scrollArea,
+													 QcvMatWidget::MOUSE_DRAG);
 				break;
 			case RENDER_IMAGE:
 			default:
-				ui->widgetImage = new QcvMatWidgetImage(image);
+				ui->widgetImage = new QcvMatWidgetImage(image,
+														ui->scrollArea,
+														QcvMatWidget::MOUSE_DRAG);
 				break;
 		}
 
@@ -345,6 +371,11 @@ void MainWindow::setupImageWidget(const RenderMode mode)
 			connect(processor, SIGNAL(outImageChanged(Mat*)),
 					ui->widgetImage, SLOT(setSourceImage(Mat*)));
 
+			// Selection in image widget sets hue / saturation model region
+			connect(ui->widgetImage, SIGNAL(releaseSelection(QRect,Qt::MouseButton)),
+					hueSat, SLOT(setSelection(QRect,Qt::MouseButton)),
+					Qt::DirectConnection);
+
 			if (mode == RENDER_GL)
 			{
 				connect(currentWindow,
@@ -521,6 +552,9 @@ void MainWindow::setupUIfromProcessor()
 		case CvHistograms8UC3::EQUALIZE_COLOR:
 			ui->radioButtonEqualize->setChecked(true);
 			break;
+		case CvHistograms8UC3::LOCAL_EQUALIZE:
+			ui->radioButtonLocalEqualize->setChecked(true);
+			break;
 		case CvHistograms8UC3::GAMMA:
 			ui->radioButtonGamma->setChecked(true);
 			break;
@@ -544,6 +578,7 @@ void MainWindow::setupUIfromProcessor()
 		case CvHistograms8UC3::THRESHOLD_GRAY:
 		case CvHistograms8UC3::DYNAMIC_GRAY:
 		case CvHistograms8UC3::EQUALIZE_GRAY:
+		case CvHistograms8UC3::LOCAL_EQUALIZE:
 		case CvHistograms8UC3::GAMMA:
 		case CvHistograms8UC3::NEGATIVE:
 		case CvHistograms8UC3::NONE:
@@ -563,6 +598,18 @@ void MainWindow::setupUIfromProcessor()
 
 	// LUT param
 	ui->spinBoxlutParam->setValue((int)processor->getLUTParam());
+
+	// Local equalization params
+	ui->spinBoxTilesX->setValue((int)processor->getLocalTilesX());
+	ui->spinBoxTilesY->setValue((int)processor->getLocalTilesY());
+	ui->doubleSpinBoxClipLimit->setValue(processor->getLocalClipLimit());
+
+	// ------------------------------------------------------------------------
+	// UI setup according to Hue / Saturation model options
+	// ------------------------------------------------------------------------
+	ui->spinBoxMinSaturation->setValue(hueSat->getMinSaturation());
+	ui->checkBoxMeanShift->setChecked(hueSat->isMeanShift());
+	ui->checkBoxShowWindow->setChecked(hueSat->isShowWindow());
 }
 
 
@@ -604,6 +651,9 @@ void MainWindow::setupProcessorFromUI()
 	}
 
 	processor->setLUTParam((float)ui->spinBoxlutParam->value());
+	processor->setLocalTiles((size_t)ui->spinBoxTilesX->value(),
+							 (size_t)ui->spinBoxTilesY->value());
+	processor->setLocalClipLimit((float)ui->doubleSpinBoxClipLimit->value());
 
 	if (ui->radioButtonIdentity->isChecked())
 	{
@@ -650,6 +700,10 @@ void MainWindow::setupProcessorFromUI()
 			processor->setLutType(CvHistograms8UC3::EQUALIZE_COLOR);
 		}
 	}
+	if (ui->radioButtonLocalEqualize->isChecked())
+	{
+		processor->setLutType(CvHistograms8UC3::LOCAL_EQUALIZE);
+	}
 }
 
 
@@ -813,6 +867,14 @@ void MainWindow::on_radioButtonEqualize_clicked()
 	}
 }
 
+/*
+ * Set transfert function to tiled local equalization
+ */
+void MainWindow::on_radioButtonLocalEqualize_clicked()
+{
+	processor->setLutType(CvHistograms8UC3::LOCAL_EQUALIZE);
+}
+
 /*
  * Set transfert function depending on processor to use colors
  * components of the histogram generating 1 transfert function per image
@@ -881,6 +943,69 @@ void MainWindow::on_spinBoxlutParam_valueChanged(int value)
 	processor->setLUTParam((float)value);
 }
 
+/*
+ * Modify the number of local equalization tiles columns
+ * @param value the new number of tiles columns
+ */
+void MainWindow::on_spinBoxTilesX_valueChanged(int value)
+{
+	processor->setLocalTiles((size_t)value,
+							 (size_t)ui->spinBoxTilesY->value());
+}
+
+/*
+ * Modify the number of local equalization tiles rows
+ * @param value the new number of tiles rows
+ */
+void MainWindow::on_spinBoxTilesY_valueChanged(int value)
+{
+	processor->setLocalTiles((size_t)ui->spinBoxTilesX->value(),
+							 (size_t)value);
+}
+
+/*
+ * Modify the local equalization clip limit
+ * @param value the new clip limit relative to the mean bin
+ * population
+ */
+void MainWindow::on_doubleSpinBoxClipLimit_valueChanged(double value)
+{
+	processor->setLocalClipLimit((float)value);
+}
+
+/*
+ * Clears the current hue / saturation model
+ */
+void MainWindow::on_pushButtonClearModel_clicked()
+{
+	hueSat->setSelection(QRect(), Qt::RightButton);
+}
+
+/*
+ * Modify the minimum back-projected saturation
+ * @param value the new minimum saturation
+ */
+void MainWindow::on_spinBoxMinSaturation_valueChanged(int value)
+{
+	hueSat->setMinSaturation(value);
+}
+
+/*
+ * Turns on/off mean-shift tracking of the model
+ */
+void MainWindow::on_checkBoxMeanShift_clicked()
+{
+	hueSat->setMeanShift(ui->checkBoxMeanShift->isChecked());
+}
+
+/*
+ * Show/Hides the mean-shift search window
+ */
+void MainWindow::on_checkBoxShowWindow_clicked()
+{
+	hueSat->setShowWindow(ui->checkBoxShowWindow->isChecked());
+}
+
 /*
  * Set histogram mode to normal
  */
@@ -4,6 +4,7 @@
 #include <QMainWindow>
 #include "QcvVideoCapture.h"
 #include "QcvHistograms.h"
+#include "QcvHueSatHistogram.h"
 
 /**
  * Namespace for generated UI
@@ -35,10 +36,12 @@ class MainWindow : public QMainWindow
 		 * @param capture the capture QObject to capture frames from devices
 		 * or video files
 		 * @param processor processor and LUT processing class
+		 * @param hueSat hue / saturation back-projection processor
 		 * @param parent parent widget
 		 */
 		explicit MainWindow(QcvVideoCapture * capture,
 							QcvHistograms * histograms,
+							QcvHueSatHistogram * hueSat,
 							QWidget *parent = NULL);
 
 		/**
@@ -102,6 +105,12 @@ class MainWindow : public QMainWindow
 		 */
 		QcvHistograms * processor;
 
+		/**
+		 * The Hue / Saturation back-projection processor localizes a model
+		 * region selected in the image widget
+		 */
+		QcvHueSatHistogram * hueSat;
+
 		/**
 		 * Image preferred width
 		 */
@@ -272,6 +281,11 @@ class MainWindow : public QMainWindow
 		 */
 		void on_radioButtonEqualize_clicked();
 
+		/**
+		 * Set transfert function to tiled local equalization
+		 */
+		void on_radioButtonLocalEqualize_clicked();
+
 		/**
 		 * Set transfert function depending on processor to use colors
 		 * components of the histogram generating 1 transfert function per image
@@ -293,6 +307,46 @@ class MainWindow : public QMainWindow
 		 */
 		void on_spinBoxlutParam_valueChanged(int value);
 
+		/**
+		 * Modify the number of local equalization tiles columns
+		 * @param value the new number of tiles columns
+		 */
+		void on_spinBoxTilesX_valueChanged(int value);
+
+		/**
+		 * Modify the number of local equalization tiles rows
+		 * @param value the new number of tiles rows
+		 */
+		void on_spinBoxTilesY_valueChanged(int value);
+
+		/**
+		 * Modify the local equalization clip limit
+		 * @param value the new clip limit relative to the mean bin
+		 * population
+		 */
+		void on_doubleSpinBoxClipLimit_valueChanged(double value);
+
+		/**
+		 * Clears the current hue / saturation model
+		 */
+		void on_pushButtonClearModel_clicked();
+
+		/**
+		 * Modify the minimum back-projected saturation
+		 * @param value the new minimum saturation
+		 */
+		void on_spinBoxMinSaturation_valueChanged(int value);
+
+		/**
+		 * Turns on/off mean-shift tracking of the model
+		 */
+		void on_checkBoxMeanShift_clicked();
+
+		/**
+		 * Show/Hides the mean-shift search window
+		 */
+		void on_checkBoxShowWindow_clicked();
+
 		/**
 		 * Set histogram mode to normal
 		 */